@@ -0,0 +1,220 @@
+/**
+ * Decoders of the encoded array replies
+ *
+ * Same formats as middleware/signal/kencode.hpp on the server side.
+ * The loops are written to be vectorized by the compiler.
+ *
+ * (c) Koheron
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "definitions.h"
+#include "koheron.h"
+
+#define ENC_BLOCK_SIZE   128
+#define ENC_LANES        4
+#define ENC_HEADER_BYTES 12
+
+/*
+ * Internal functions
+ */
+
+static void decode_int16(const int16_t *in, uint32_t n, int32_t *out)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+        out[i] = in[i];
+}
+
+/* See: https://gist.github.com/rygorous/2156668 */
+static inline uint32_t half_to_float_bits(uint16_t h)
+{
+    const uint32_t shifted_exp = 0x7c00U << 13;
+    const uint32_t magic_bits = 113U << 23;
+    uint32_t o = (h & 0x7fffU) << 13;
+    uint32_t exp = o & shifted_exp;
+    uint32_t inf_nan, denorm_bits, denorm, f;
+    float denorm_f, magic;
+
+    o += (127U - 15U) << 23;
+    inf_nan = o + ((128U - 16U) << 23);
+
+    denorm_bits = o + (1U << 23);
+    memcpy(&denorm_f, &denorm_bits, sizeof(denorm_f));
+    memcpy(&magic, &magic_bits, sizeof(magic));
+    denorm_f -= magic;
+    memcpy(&denorm, &denorm_f, sizeof(denorm));
+
+    f = exp == shifted_exp ? inf_nan : exp == 0 ? denorm : o;
+    return f | ((uint32_t)(h & 0x8000U) << 16);
+}
+
+static void decode_float16(const uint16_t *in, uint32_t n, uint32_t *out)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+        out[i] = half_to_float_bits(in[i]);
+}
+
+/*
+ * unpack_block - Unpack 128 codes of width bits
+ *
+ * Returns the number of words read
+ */
+static uint32_t unpack_block(const uint32_t *in, uint32_t width, uint32_t *out)
+{
+    const uint32_t mask = width == 32 ? 0xffffffffU : (1U << width) - 1;
+    uint32_t shift = 0;
+    uint32_t r, l;
+
+    if (width == 0) {
+        memset(out, 0, ENC_BLOCK_SIZE * sizeof(uint32_t));
+        return 0;
+    }
+
+    for (r = 0; r < ENC_BLOCK_SIZE / ENC_LANES; r++) {
+        uint32_t *row = out + ENC_LANES * r;
+
+        if (shift + width > 32) {
+            for (l = 0; l < ENC_LANES; l++)
+                row[l] = ((in[l] >> shift)
+                          | (in[ENC_LANES + l] << (32 - shift))) & mask;
+        } else {
+            for (l = 0; l < ENC_LANES; l++)
+                row[l] = (in[l] >> shift) & mask;
+        }
+
+        shift += width;
+
+        if (shift >= 32) {
+            in += ENC_LANES;
+            shift -= 32;
+        }
+    }
+
+    return ENC_LANES * width;
+}
+
+static int decode_delta_bitpack(const uint8_t *in, uint32_t len,
+                                uint32_t n, uint32_t *out)
+{
+    uint32_t blocks_num = (n + ENC_BLOCK_SIZE - 1) / ENC_BLOCK_SIZE;
+    uint32_t widths_bytes = (blocks_num + 3) & ~3U;
+    uint32_t words_num = 0;
+    uint32_t codes[ENC_BLOCK_SIZE];
+    const uint32_t *words;
+    uint32_t b, i;
+
+    if (len < widths_bytes)
+        return -1;
+
+    for (b = 0; b < blocks_num; b++) {
+        if (in[b] > 32)
+            return -1;
+
+        words_num += ENC_LANES * in[b];
+    }
+
+    if (len != widths_bytes + 4 * words_num)
+        return -1;
+
+    words = (const uint32_t *)(in + widths_bytes);
+
+    for (b = 0; b < blocks_num; b++) {
+        uint32_t first = b * ENC_BLOCK_SIZE;
+        uint32_t count = n - first < ENC_BLOCK_SIZE ? n - first : ENC_BLOCK_SIZE;
+
+        words += unpack_block(words, in[b], codes);
+
+        /* Zigzag decoding */
+        for (i = 0; i < count; i++)
+            out[first + i] = (codes[i] >> 1) ^ (0U - (codes[i] & 1));
+    }
+
+    /* Prefix sums lane by lane */
+    for (i = ENC_LANES; i < n; i++)
+        out[i] += out[i - ENC_LANES];
+
+    return 0;
+}
+
+/*
+ * External functions
+ */
+
+KOHERON_LIB_EXPORT
+int koheron_encoded_len(const void *header, uint32_t *values_num)
+{
+    uint32_t words[3];
+
+    memcpy(words, header, sizeof(words));
+
+    if (words[0] >= KOHERON_ENCODINGS_NUM) {
+        DEBUG_MSG("Unknown encoding\n");
+        return -1;
+    }
+
+    if (values_num != NULL)
+        *values_num = words[1];
+
+    return ENC_HEADER_BYTES + words[2];
+}
+
+KOHERON_LIB_EXPORT
+int koheron_decode_array(const void *frame, uint32_t len,
+                         void *values, uint32_t max_values)
+{
+    const uint8_t *data = (const uint8_t *)frame + ENC_HEADER_BYTES;
+    uint32_t header[3];
+    uint32_t n, bytes;
+
+    if (len < ENC_HEADER_BYTES) {
+        DEBUG_MSG("Frame shorter than its header\n");
+        return -1;
+    }
+
+    memcpy(header, frame, sizeof(header));
+    n = header[1];
+    bytes = header[2];
+
+    if (len != ENC_HEADER_BYTES + bytes || n > max_values) {
+        DEBUG_MSG("Invalid frame length\n");
+        return -1;
+    }
+
+    switch (header[0]) {
+      case KOHERON_ENC_NONE:
+        if (bytes != 4 * n)
+            return -1;
+
+        memcpy(values, data, bytes);
+        break;
+      case KOHERON_ENC_INT16:
+        if (bytes != 2 * n)
+            return -1;
+
+        decode_int16((const int16_t *)data, n, values);
+        break;
+      case KOHERON_ENC_FLOAT16:
+        if (bytes != 2 * n)
+            return -1;
+
+        decode_float16((const uint16_t *)data, n, values);
+        break;
+      case KOHERON_ENC_DELTA_BITPACK:
+        if (decode_delta_bitpack(data, bytes, n, values) < 0) {
+            DEBUG_MSG("Invalid bit-packed data\n");
+            return -1;
+        }
+        break;
+      default:
+        DEBUG_MSG("Unknown encoding\n");
+        return -1;
+    }
+
+    return (int)n;
+}
@@ -6,6 +6,8 @@
  
 #ifndef __KOHERON_H__
 #define __KOHERON_H__
+
+#include <stdint.h>
  
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +66,47 @@ struct devmem* dev_mem_init(struct kclient *kcl);
  */
 void dev_mem_exit(struct devmem *dvm);
 
+/* 
+ * ---------------
+ *   Encodings
+ * ---------------
+ */
+
+/*
+ * Encodings of the array replies, requested by prefixing a command
+ * with %ENC| (see doc/encodings.md). The reply is then a frame:
+ * | encoding (uint32) | values num (uint32) | length (uint32) | data |
+ */
+enum koheron_encoding {
+    KOHERON_ENC_NONE,           // Raw 32 bits values
+    KOHERON_ENC_INT16,          // 16 bits integers
+    KOHERON_ENC_FLOAT16,        // IEEE half precision floats
+    KOHERON_ENC_DELTA_BITPACK,  // Bit-packed differences of integers
+    KOHERON_ENCODINGS_NUM
+};
+
+/**
+ * koheron_encoded_len - Length of an encoded frame
+ * @header: The first 12 bytes of the frame
+ * @values_num: Set to the number of values of the frame if not NULL
+ *
+ * Returns the number of bytes of the frame (header included), 
+ * -1 if the header is invalid
+ */
+int koheron_encoded_len(const void *header, uint32_t *values_num);
+
+/**
+ * koheron_decode_array - Decode an encoded frame
+ * @frame: The frame, 4 bytes aligned
+ * @len: Number of bytes of the frame
+ * @values: The decoded 32 bits values (integers or floats)
+ * @max_values: Size of the values array
+ *
+ * Returns the number of values decoded, -1 if failure
+ */
+int koheron_decode_array(const void *frame, uint32_t len,
+                         void *values, uint32_t max_values);
+
 #ifdef __cplusplus
 }
 #endif
@@ -320,3 +320,149 @@ struct session_perfs* kclient_get_session_perfs(struct kclient *kcl, int sid)
     return perfs;
 }
 
+/*
+ * --------------------
+ *  Operations perfs
+ * --------------------
+ */
+
+/* Fields of the operations perfs */
+enum ops_perfs_fields {
+    OPS_PERFS_DEV_NAME,
+    OPS_PERFS_OP_NAME,
+    OPS_PERFS_COUNT,
+    OPS_PERFS_MEAN,
+    OPS_PERFS_P50,
+    OPS_PERFS_P90,
+    OPS_PERFS_P99,
+    OPS_PERFS_MAX,
+    ops_perfs_fields_num
+};
+
+/**
+ * __get_ops_perfs_data - Load operations perfs data
+ * @kcl: Kclient structure
+ * @rcv_buffer: Reception buffer to load
+ * @sid: Session ID
+ *
+ * Returns the number of bytes received on success, -1 if failure
+ */
+static int __get_ops_perfs_data(struct kclient *kcl, 
+                                struct rcv_buff *rcv_buffer, int sid)
+{
+    int bytes_read;
+    char cmd[64];
+    
+    snprintf(cmd, 64, "1|7|%i|\n", sid);
+    
+    if (kclient_send_string(kcl, cmd) < 0)
+        return -1;
+    
+    bytes_read = kclient_rcv_esc_seq(kcl, rcv_buffer, "EOOP");
+    
+    if (bytes_read < 0)
+        return -1;
+    
+    return bytes_read;
+}
+
+/**
+ * __set_op_perf_field - Set a field of an operation perf
+ * @op: Operation perf to fill
+ * @field: Field index
+ * @str: Field value
+ */
+static void __set_op_perf_field(struct op_perf *op, int field, 
+                                const char *str)
+{
+    switch (field) {
+      case OPS_PERFS_DEV_NAME:
+        strncpy(op->dev_name, str, OP_PERF_NAME_LEN - 1);
+        op->dev_name[OP_PERF_NAME_LEN - 1] = '\0';
+        break;
+      case OPS_PERFS_OP_NAME:
+        strncpy(op->op_name, str, OP_PERF_NAME_LEN - 1);
+        op->op_name[OP_PERF_NAME_LEN - 1] = '\0';
+        break;
+      case OPS_PERFS_COUNT:
+        op->count = strtoull(str, (char **)NULL, 10);
+        break;
+      case OPS_PERFS_MEAN:
+        op->mean = (float) strtof(str, (char **)NULL);
+        break;
+      case OPS_PERFS_P50:
+        op->p50 = strtoull(str, (char **)NULL, 10);
+        break;
+      case OPS_PERFS_P90:
+        op->p90 = strtoull(str, (char **)NULL, 10);
+        break;
+      case OPS_PERFS_P99:
+        op->p99 = strtoull(str, (char **)NULL, 10);
+        break;
+      case OPS_PERFS_MAX:
+        op->max = strtoull(str, (char **)NULL, 10);
+        break;
+    }
+}
+
+struct ops_perfs* kclient_get_ops_perfs(struct kclient *kcl, int sid)
+{
+    int i, tmp_buff_cnt;
+    char tmp_buff[2048];
+    int current_field = OPS_PERFS_DEV_NAME;
+    struct op_perf tmp_op;
+    struct ops_perfs *perfs;
+    
+    struct rcv_buff rcv_buffer;
+    char *buffer = rcv_buffer.buffer;
+    int bytes_read = __get_ops_perfs_data(kcl, &rcv_buffer, sid);
+    
+    if (bytes_read < 0) {
+        fprintf(stderr, "Can't get operations perfs data\n");
+        return NULL;
+    }
+    
+    perfs = malloc(sizeof *perfs);
+    
+    if (perfs == NULL) {
+        fprintf(stderr, "Can't allocate operations perfs memory\n");
+        return NULL;
+    }
+    
+    perfs->sess_id = sid;
+    
+    // Parse rcv_buffer
+    tmp_buff[0] = '\0';
+    tmp_buff_cnt = 0;
+    perfs->ops_num = 0;
+    
+    for (i=0; i<bytes_read; i++) {
+        if (buffer[i] == ':') {
+            tmp_buff[tmp_buff_cnt] = '\0';
+            __set_op_perf_field(&tmp_op, current_field, tmp_buff);
+            current_field++;
+            tmp_buff[0] = '\0';
+            tmp_buff_cnt = 0;
+        } else if (buffer[i] == '\n') {
+            tmp_buff[tmp_buff_cnt] = '\0';
+            
+            if (strstr(tmp_buff, "EOOP") != NULL)
+                break;
+            
+            __set_op_perf_field(&tmp_op, current_field, tmp_buff);
+            tmp_buff[0] = '\0';
+            tmp_buff_cnt = 0;
+            current_field = OPS_PERFS_DEV_NAME;
+            
+            if (perfs->ops_num < MAX_OPS_PERFS_NUM) {
+                perfs->ops[perfs->ops_num] = tmp_op;
+                perfs->ops_num++;
+            }
+        } else {
+            tmp_buff[tmp_buff_cnt] = buffer[i];
+            tmp_buff_cnt++;
+        }  
+    }
+    
+    return perfs;
+}
@@ -98,4 +98,53 @@ struct session_perfs {
  */ 
 struct session_perfs* kclient_get_session_perfs(struct kclient *kcl, int sid);
 
+/*
+ * --------------------
+ *  Operations perfs
+ * --------------------
+ */
+
+#define OP_PERF_NAME_LEN 64
+#define MAX_OPS_PERFS_NUM 256
+
+/**
+ * struct op_perf - Execution latencies of an operation
+ * @dev_name: Name of the device
+ * @op_name: Name of the operation
+ * @count: Number of executions
+ * @mean: Mean execution duration (ns)
+ * @p50: Median execution duration (ns)
+ * @p90: 90th percentile of the execution duration (ns)
+ * @p99: 99th percentile of the execution duration (ns)
+ * @max: Maximum execution duration (ns)
+ */
+struct op_perf {
+    char                dev_name[OP_PERF_NAME_LEN];
+    char                op_name[OP_PERF_NAME_LEN];
+    unsigned long long  count;
+    float               mean;
+    unsigned long long  p50;
+    unsigned long long  p90;
+    unsigned long long  p99;
+    unsigned long long  max;
+};
+
+/**
+ * struct ops_perfs - Execution latencies of the operations
+ * @sess_id: ID of the session, -1 for the whole server
+ * @ops_num: Number of executed operations
+ * @ops: The operations latencies
+ */
+struct ops_perfs {
+    int             sess_id;
+    int             ops_num;
+    struct op_perf  ops[MAX_OPS_PERFS_NUM];
+};
+
+/**
+ * kclient_get_ops_perfs - Obtain the latencies of the executed operations
+ * @sid: ID of the session, -1 for all the sessions since server start
+ */ 
+struct ops_perfs* kclient_get_ops_perfs(struct kclient *kcl, int sid);
+
 #endif /* __SESSIONS_H__ */
@@ -0,0 +1,131 @@
+/// @file bulk_copy.cpp
+///
+/// @brief Throughput of the bulk transfer kernels
+///
+/// The device memory is replaced by a shared mapping of a memfd
+/// (or of a temporary file), so the benchmark runs on any host.
+/// On the board, the figures of a real memory map are obtained
+/// with READ_BUFFER/WRITE_BUFFER after SET_ACCESS.
+///
+/// Usage: bulk_copy [size_kB] [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <vector>
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+}
+
+#include <drivers/core/wr_register.hpp>
+
+static const char *modes_names[Klib::access_modes_num] = {
+    "ACCESS_32", "ACCESS_64", "ACCESS_VECTOR", "ACCESS_STREAM"
+};
+
+/// Open the file backing the stand-in memory map
+static int open_backing_file()
+{
+#ifdef SYS_memfd_create
+    int fd = syscall(SYS_memfd_create, "bulk_copy", 0);
+
+    if(fd >= 0)
+        return fd;
+#endif
+
+    char path[] = "/tmp/bulk_copyXXXXXX";
+    int fd_tmp = mkstemp(path);
+
+    if(fd_tmp >= 0)
+        unlink(path);
+
+    return fd_tmp;
+}
+
+/// Throughput in MB/s
+static double throughput(uint32_t n_words, unsigned int iterations,
+                         std::chrono::steady_clock::duration duration)
+{
+    double seconds = std::chrono::duration<double>(duration).count();
+    return 1E-6 * sizeof(uint32_t) * n_words * iterations / seconds;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t size_kB = argc > 1 ? strtoul(argv[1], NULL, 10) : 1024;
+    unsigned int iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 100;
+
+    if(size_kB == 0 || iterations == 0) {
+        fprintf(stderr, "Usage: %s [size_kB] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t size = 1024 * static_cast<size_t>(size_kB);
+    int fd = open_backing_file();
+
+    if(fd < 0 || ftruncate(fd, size) < 0) {
+        fprintf(stderr, "Can't create the backing file\n");
+        return EXIT_FAILURE;
+    }
+
+    void *map = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if(map == MAP_FAILED) {
+        fprintf(stderr, "Can't map the backing file\n");
+        return EXIT_FAILURE;
+    }
+
+    intptr_t addr = reinterpret_cast<intptr_t>(map);
+    uint32_t n_words = size / sizeof(uint32_t);
+    std::vector<uint32_t> buffer(n_words);
+
+    for(uint32_t i=0; i<n_words; i++)
+        buffer[i] = i;
+
+    printf("%u kB, %u iterations\n\n", size_kB, iterations);
+    printf("%-14s %12s %12s\n", "Mode", "Read (MB/s)", "Write (MB/s)");
+
+    for(uint32_t mode=0; mode<Klib::access_modes_num; mode++) {
+        // Warm up the mapping
+        Klib::WriteBuff(addr, buffer.data(), n_words, mode);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for(unsigned int i=0; i<iterations; i++)
+            Klib::WriteBuff(addr, buffer.data(), n_words, mode);
+
+        double write_mbps = throughput(n_words, iterations, 
+                                       std::chrono::steady_clock::now() - start);
+
+        start = std::chrono::steady_clock::now();
+
+        for(unsigned int i=0; i<iterations; i++)
+            Klib::ReadBuff(addr, buffer.data(), n_words, mode);
+
+        double read_mbps = throughput(n_words, iterations, 
+                                      std::chrono::steady_clock::now() - start);
+
+        // Check the copy, with a misaligned start
+        bool valid = true;
+        std::vector<uint32_t> check(n_words - 1);
+        Klib::ReadBuff(addr + sizeof(uint32_t), check.data(), n_words - 1, mode);
+
+        for(uint32_t i=0; i<n_words-1; i++)
+            valid = valid && (check[i] == i + 1);
+
+        printf("%-14s %12.1f %12.1f%s\n", modes_names[mode], read_mbps, 
+               write_mbps, valid ? "" : "  (INVALID COPY)");
+    }
+
+    munmap(map, size);
+    close(fd);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,137 @@
+/// @file kadc.cpp
+///
+/// @brief Checks and throughput of the ADC conversions
+///
+/// Checks the conversions of KAdcConverter against a scalar conversion
+/// sample by sample (the one a client would write), for several layouts
+/// of the words. Then compares their throughputs.
+///
+/// Usage: kadc [words]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include <signal/kadc.hpp>
+
+using namespace Klib;
+
+struct Layout
+{
+    const char *name;
+    unsigned int bits;
+    bool is_signed;
+    unsigned int fields_per_word;
+    unsigned int channels_num;
+    bool cubic;
+};
+
+/// Scalar conversion of the field k, sample by sample
+static float scalar_sample(const Layout& l, const uint32_t *words, size_t k,
+                           const KAdcCalibration<float>& cal)
+{
+    const uint32_t word = words[k / l.fields_per_word];
+    const unsigned int shift = (k % l.fields_per_word) * (32 / l.fields_per_word);
+    uint32_t field = (word >> shift) & ((1ULL << l.bits) - 1);
+    int64_t raw = field;
+
+    if(l.is_signed && (field >> (l.bits - 1)))
+        raw -= 1LL << l.bits;
+
+    const float x = raw - cal.offset;
+    return cal.gain * x + cal.c2 * x * x + cal.c3 * x * x * x;
+}
+
+static void scalar_convert(const Layout& l, const uint32_t *words, size_t n,
+                           const KAdcConverter<float>& conv, float *out)
+{
+    const size_t samples_num = conv.SamplesNum(n);
+
+    for(size_t k=0; k<samples_num * l.channels_num; k++) {
+        const unsigned int c = k % l.channels_num;
+        out[c * samples_num + k / l.channels_num]
+            = scalar_sample(l, words, k, conv.GetCalibration(c));
+    }
+}
+
+/// Mwords/s
+template<typename Fn>
+static double mwps(Fn fn, size_t words)
+{
+    fn(); // Warm up
+    unsigned int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double duration;
+
+    do {
+        fn();
+        iterations++;
+        duration = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - start).count();
+    } while(duration < 2e5);
+
+    return words * iterations / duration;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1 << 20;
+
+    if(n == 0) {
+        fprintf(stderr, "Usage: %s [words]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint32_t> words(n);
+
+    for(size_t i=0; i<n; i++)
+        words[i] = static_cast<uint32_t>(rand()) * 2 + (rand() & 1);
+
+    const Layout layouts[] = {
+        {"14 bits, 1 channel",                14, true,  1, 1, false},
+        {"14 bits, 2 channels interleaved",   14, true,  1, 2, false},
+        {"14 bits, 2 channels in a word",     14, true,  2, 2, false},
+        {"12 bits unsigned, 2 in a word",     12, false, 2, 2, false},
+        {"8 bits, 4 channels in a word",       8, true,  4, 4, false},
+        {"16 bits, 2 in a word, cubic",       16, true,  2, 2, true},
+    };
+
+    printf("%-34s %10s %12s %12s\n", "Layout", "Max error", "KAdc Mw/s",
+           "Scalar Mw/s");
+
+    for(const Layout& l : layouts) {
+        KAdcConverter<float> conv(l.bits, l.is_signed, l.fields_per_word,
+                                  l.channels_num);
+
+        for(unsigned int c=0; c<l.channels_num; c++)
+            conv.SetCalibration(c, 3.0f * c - 5, 1.0f / (1 << (l.bits - 1)),
+                                l.cubic ? 1e-9f : 0, l.cubic ? -1e-14f : 0);
+
+        const size_t out_size = l.channels_num * conv.SamplesNum(n);
+        std::vector<float> y(out_size), ref(out_size);
+        conv.Convert(words.data(), n, y.data());
+        scalar_convert(l, words.data(), n, conv, ref.data());
+
+        double err = 0;
+
+        for(size_t i=0; i<out_size; i++)
+            err = std::max(err, std::fabs(double(y[i]) - ref[i]));
+
+        double t_kadc = mwps([&]() {conv.Convert(words.data(), n, y.data());}, n);
+        double t_ref = mwps([&]() {
+            scalar_convert(l, words.data(), n, conv, ref.data());
+        }, n);
+
+        printf("%-34s %10.2g %12.1f %12.1f\n", l.name, err, t_kadc, t_ref);
+    }
+
+    printf("(Millions of 32 bits words per second)\n");
+    return EXIT_SUCCESS;
+}
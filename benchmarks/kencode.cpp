@@ -0,0 +1,133 @@
+/// @file kencode.cpp
+///
+/// @brief Checks and throughput of the array encodings
+///
+/// Encodes 14 bits ADC samples (sine and noise) and their conversion
+/// to floats. Checks the round trips, then prints the size of the
+/// frames and the encoding and decoding throughputs, to be compared
+/// with the link speed (125 MB/s for Gigabit Ethernet).
+///
+/// Usage: kencode [samples]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include <signal/kencode.hpp>
+
+using namespace Klib;
+
+static const char *names[kencodings_num] = {
+    "None", "Int16", "Float16", "Delta + bitpack"
+};
+
+/// MB/s of raw 32 bits values
+template<typename Fn>
+static double mbps(Fn fn, size_t samples)
+{
+    fn(); // Warm up
+    unsigned int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double duration;
+
+    do {
+        fn();
+        iterations++;
+        duration = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - start).count();
+    } while(duration < 2e5);
+
+    return 4.0 * samples * iterations / duration;
+}
+
+/// Largest error of a round trip
+template<typename T>
+static double round_trip(KEncoder& encoder, kencoding_t enc,
+                         const std::vector<T>& x, std::vector<T>& y)
+{
+    encoder.Encode(enc, x.data(), x.size());
+
+    if(KDecode(encoder.Frame(), encoder.FrameSize(), y.data(), y.size())
+           != static_cast<long>(x.size()))
+        return INFINITY;
+
+    double err = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        err = std::max(err, std::fabs(double(x[i]) - double(y[i])));
+
+    return err;
+}
+
+template<typename T>
+static void bench(const char *label, kencoding_t enc, const std::vector<T>& x)
+{
+    KEncoder encoder;
+    std::vector<T> y(KBitpackBlocksNum(x.size()) * KENC_BLOCK_SIZE);
+    const double err = round_trip(encoder, enc, x, y);
+    const kencoding_t used = encoder.Encode(enc, x.data(), x.size());
+    const size_t frame_size = encoder.FrameSize();
+
+    double t_enc = mbps([&]() {encoder.Encode(enc, x.data(), x.size());},
+                        x.size());
+    double t_dec = mbps([&]() {
+        KDecode(encoder.Frame(), frame_size, y.data(), y.size());
+    }, x.size());
+
+    printf("%-8s %-16s %-16s %8.2f %10.3g %10.0f %10.0f\n", label,
+           names[enc], names[used], 4.0 * x.size() / frame_size,
+           err, t_enc, t_dec);
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1 << 20;
+
+    if(n == 0) {
+        fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // 14 bits ADC: sine at 1/100 of the sampling rate and noise
+    std::vector<int32_t> adc(n);
+    std::vector<float> volts(n);
+
+    for(size_t i=0; i<n; i++) {
+        adc[i] = static_cast<int32_t>(6000 * std::sin(2 * M_PI * i / 100.0))
+                 + rand() % 64 - 32;
+        volts[i] = adc[i] / 8192.0f;
+    }
+
+    // Float16 special values
+    const float specials[] = {0.0f, -0.0f, 1e-7f, 6e-5f, 65504.0f,
+                              1e5f, -INFINITY, 1.0f / 3};
+    bool specials_ok = true;
+
+    for(float f : specials) {
+        uint16_t h1 = __float_to_half(f), h2;
+        KEncodeFloat16(&f, 1, &h2);
+        float g1 = __half_to_float(h1), g2;
+        KDecodeFloat16(&h1, 1, &g2);
+        specials_ok &= (h1 == h2 && (g1 == g2 || (std::isnan(g1) && std::isnan(g2))));
+    }
+
+    printf("Float16 scalar conversions %s\n\n",
+           specials_ok ? "match" : "DON'T MATCH");
+
+    printf("%-8s %-16s %-16s %8s %10s %10s %10s\n", "Values", "Requested",
+           "Used", "Ratio", "Max err", "Enc MB/s", "Dec MB/s");
+
+    for(int enc=KENC_NONE; enc<kencodings_num; enc++)
+        bench("ADC", static_cast<kencoding_t>(enc), adc);
+
+    bench("Floats", KENC_FLOAT16, volts);
+
+    printf("(MB/s of 32 bits values)\n");
+    return EXIT_SUCCESS;
+}
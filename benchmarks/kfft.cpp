@@ -0,0 +1,137 @@
+/// @file kfft.cpp
+///
+/// @brief Accuracy and speed of the real FFT and of the Welch PSD
+///
+/// Compares KFft with a direct DFT computed in double precision,
+/// checks the Parseval normalization of KWelch on white noise and
+/// the position of the peak of a sine, then times both for the
+/// usual FFT sizes.
+///
+/// Usage: kfft [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include <signal/kfft.hpp>
+
+using Klib::KFft;
+using Klib::KWelch;
+using Klib::KVector;
+
+/// Maximum error of the bins, relative to the largest bin
+static double fft_error(size_t n)
+{
+    std::vector<float> x(n);
+
+    for(size_t i=0; i<n; i++)
+        x[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+
+    KFft<float> fft(n);
+    std::vector<float> re(fft.BinsNum()), im(fft.BinsNum());
+    fft.Forward(x.data(), re.data(), im.data());
+
+    double err = 0, peak = 0;
+
+    for(size_t k=0; k<fft.BinsNum(); k++) {
+        double dre = 0, dim = 0;
+
+        for(size_t i=0; i<n; i++) {
+            double phi = -2 * M_PI * double((k * i) % n) / n;
+            dre += x[i] * std::cos(phi);
+            dim += x[i] * std::sin(phi);
+        }
+
+        err = std::max(err, std::hypot(re[k] - dre, im[k] - dim));
+        peak = std::max(peak, std::hypot(dre, dim));
+    }
+
+    return err / peak;
+}
+
+template<typename Fn>
+static double time_us(Fn fn, unsigned int iterations)
+{
+    fn(); // Warm up
+    auto start = std::chrono::steady_clock::now();
+
+    for(unsigned int i=0; i<iterations; i++)
+        fn();
+
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int iterations = argc > 1 ? strtoul(argv[1], NULL, 10) : 200;
+
+    if(iterations == 0) {
+        fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Accuracy
+    printf("%-8s %16s\n", "N", "Error vs DFT");
+
+    for(size_t n=16; n<=4096; n *= 4)
+        printf("%-8zu %16.2e\n", n, fft_error(n));
+
+    // Parseval on white noise: sum(psd) / nfft = variance
+    const size_t len = 1 << 18;
+    KVector<float> noise(len);
+
+    for(size_t i=0; i<len; i++)
+        noise[i] = static_cast<float>(rand()) / RAND_MAX - 0.5f;
+
+    KWelch<float> welch(1024);
+    KVector<float> psd = welch.Compute(noise);
+    printf("\nWhite noise: sum(PSD)/nfft = %.5f, variance = %.5f\n",
+           psd.sum() / welch.Nfft(), noise.var());
+
+    // Peak of a sine at the bin 100.25
+    KVector<float> sine(len);
+
+    for(size_t i=0; i<len; i++)
+        sine[i] = 100.0f + std::sin(2 * M_PI * 100.25 * i / 1024);
+
+    psd = welch.Compute(sine);
+    size_t peak = 0;
+
+    for(size_t k=0; k<psd.size(); k++)
+        if(psd[k] > psd[peak])
+            peak = k;
+
+    printf("Sine at the bin 100.25: peak at the bin %zu\n", peak);
+
+    // Speed
+    printf("\n%-8s %14s %14s %20s\n", "N", "FFT (us)", "ns/(N log2 N)",
+           "Welch 256K (ms)");
+
+    for(size_t n=256; n<=65536; n *= 4) {
+        KFft<float> fft(n);
+        std::vector<float> re(fft.BinsNum()), im(fft.BinsNum());
+        const float *x = noise.get_ptr();
+
+        double t_fft = time_us([&]() {
+            fft.Forward(x, re.data(), im.data());
+        }, iterations);
+
+        KWelch<float> w(n);
+        KVector<float> res(w.BinsNum());
+        double t_welch = time_us([&]() {
+            w.Compute(noise.get_ptr(), len, &res[0]);
+        }, iterations / 20 + 1);
+
+        printf("%-8zu %14.2f %14.3f %20.2f\n", n, t_fft,
+               1e3 * t_fft / (n * std::log2(n)), t_welch / 1e3);
+    }
+
+    return EXIT_SUCCESS;
+}
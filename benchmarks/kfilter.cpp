@@ -0,0 +1,163 @@
+/// @file kfilter.cpp
+///
+/// @brief Checks and throughput of the streaming decimation filters
+///
+/// Checks that a signal decimated chunk by chunk gives the same
+/// outputs as decimated at once, the response of the anti-aliasing
+/// filter and the DC gain of the CIC. Then compares the throughput of
+/// the decimators with a scalar FIR filter computed at the input rate
+/// and decimated afterwards.
+///
+/// Usage: kfilter [samples]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include <signal/kfilter.hpp>
+
+using namespace Klib;
+
+/// Largest difference between a decimation at once and by chunks
+template<typename Filter, typename In>
+static double chunks_error(Filter f1, Filter f2, const std::vector<In>& x)
+{
+    std::vector<float> y1(f1.MaxOutputsNum(x.size()));
+    std::vector<float> y2(y1.size());
+    size_t n1 = f1.Process(x.data(), x.size(), y1.data());
+    size_t n2 = 0;
+
+    for(size_t i=0; i<x.size(); ) {
+        size_t chunk = std::min(static_cast<size_t>(1 + rand() % 1000),
+                                x.size() - i);
+        n2 += f2.Process(x.data() + i, chunk, y2.data() + n2);
+        i += chunk;
+    }
+
+    if(n1 != n2)
+        return INFINITY;
+
+    double err = 0;
+
+    for(size_t i=0; i<n1; i++)
+        err = std::max(err, std::fabs(double(y1[i]) - y2[i]));
+
+    return err;
+}
+
+/// Gain of the filter @h at the frequency @f (cycles per sample), in dB
+static double gain_db(const KVector<float>& h, double f)
+{
+    double re = 0, im = 0;
+
+    for(size_t k=0; k<h.size(); k++) {
+        re += h[k] * std::cos(2 * M_PI * f * k);
+        im -= h[k] * std::sin(2 * M_PI * f * k);
+    }
+
+    return 20 * std::log10(std::hypot(re, im));
+}
+
+template<typename Fn>
+static double msps(Fn fn, size_t samples)
+{
+    fn(); // Warm up
+    unsigned int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double duration;
+
+    do {
+        fn();
+        iterations++;
+        duration = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - start).count();
+    } while(duration < 2e5);
+
+    return samples * iterations / duration;
+}
+
+int main(int argc, char **argv)
+{
+    size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1 << 20;
+
+    if(n == 0) {
+        fprintf(stderr, "Usage: %s [samples]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<int32_t> xi(n);
+    std::vector<float> xf(n);
+
+    for(size_t i=0; i<n; i++) {
+        xi[i] = rand() % 16384 - 8192;
+        xf[i] = static_cast<float>(xi[i]);
+    }
+
+    // Checks
+    printf("Chunks vs at once: average %g, FIR %g, CIC %g\n",
+           chunks_error(KMovingAverage<float>(10, 10),
+                        KMovingAverage<float>(10, 10), xf),
+           chunks_error(KFirDecimator<float>(KDecimationTaps<float>(10), 10),
+                        KFirDecimator<float>(KDecimationTaps<float>(10), 10),
+                        xf),
+           chunks_error(KCicDecimator<float>(3, 10),
+                        KCicDecimator<float>(3, 10), xi));
+
+    for(size_t d : {4, 64}) {
+        KVector<float> h = KDecimationTaps<float>(d);
+        printf("Decimation by %3zu, gain (dB) at 0.2, 0.43 and 0.57"
+               " x output rate: %.3f, %.1f, %.1f\n", d,
+               gain_db(h, 0.2 / d), gain_db(h, 0.43 / d), gain_db(h, 0.57 / d));
+    }
+
+    std::vector<int32_t> dc(4096, -1000);
+    std::vector<float> y(4096);
+    KCicDecimator<float> cic(3, 1024);
+    cic.Process(dc.data(), dc.size(), y.data());
+    printf("CIC order 3 by 1024, DC -1000 -> %g\n\n", y[3]);
+
+    // Throughput
+    printf("%-6s %12s %12s %12s %12s %12s\n", "Decim", "Average", "CIC 3",
+           "FIR", "FIR taps", "Scalar FIR");
+    y.resize(n);
+
+    for(size_t d : {4, 16, 64, 256}) {
+        KMovingAverage<float> avg(d, d);
+        KCicDecimator<float> cic3(3, d);
+        KVector<float> h = KDecimationTaps<float>(d);
+        KFirDecimator<float> fir(h, d);
+
+        double t_avg = msps([&]() {avg.Process(xf.data(), n, y.data());}, n);
+        double t_cic = msps([&]() {cic3.Process(xi.data(), n, y.data());}, n);
+        double t_fir = msps([&]() {fir.Process(xf.data(), n, y.data());}, n);
+
+        // Filtered at the input rate, then decimated
+        const size_t m = std::min(n, static_cast<size_t>(1 << 16));
+        double t_ref = msps([&]() {
+            for(size_t i=h.size(); i<m; i++) {
+                float acc = 0;
+
+                for(size_t k=0; k<h.size(); k++)
+                    acc += h[k] * xf[i - k];
+
+                y[i] = acc;
+            }
+
+            for(size_t i=0; i<m/d; i++)
+                y[i] = y[i * d];
+        }, m);
+
+        printf("%-6zu %12.1f %12.1f %12.1f %12zu %12.1f\n",
+               d, t_avg, t_cic, t_fir, h.size(), t_ref);
+    }
+
+    printf("(Msamples/s at the input)\n");
+    return EXIT_SUCCESS;
+}
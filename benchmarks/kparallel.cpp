@@ -0,0 +1,120 @@
+/// @file kparallel.cpp
+///
+/// @brief Scaling of the KVector operations on several threads
+///
+/// Runs element-wise expressions and reductions of large vectors
+/// on 1 to max_threads threads (KSetParallel), and checks that the
+/// results are bit for bit the same for all the numbers of threads.
+///
+/// Usage: kparallel [size] [max_threads]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <functional>
+
+#include <signal/kvector.hpp>
+#include <signal/kfastmath.hpp>
+#include <signal/kparallel.hpp>
+
+using namespace Klib;
+
+struct Bench
+{
+    const char *name;
+    std::function<float()> run; ///< Returns a value checked across threads
+};
+
+/// Msamples/s
+static double msps(const std::function<float()>& fn, size_t size, float *res)
+{
+    *res = fn(); // Warm up
+    unsigned int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double duration;
+
+    do {
+        fn();
+        iterations++;
+        duration = std::chrono::duration<double, std::micro>(
+                       std::chrono::steady_clock::now() - start).count();
+    } while(duration < 2e5);
+
+    return size * iterations / duration;
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = argc > 1 ? strtoul(argv[1], NULL, 10) : 1 << 22;
+    unsigned int max_threads = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+
+    if(size == 0 || max_threads == 0) {
+        fprintf(stderr, "Usage: %s [size] [max_threads]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    KVector<float> a(size), b(size), res(size);
+
+    for(size_t i=0; i<size; i++) {
+        a[i] = (rand() % 16384) - 8192.0f;
+        b[i] = (rand() % 16384) - 8192.0f;
+    }
+
+    const float g = 1.5f, o = -0.25f;
+
+    std::vector<Bench> benchs = {
+        {"affine a*g + o",        [&] {res = a*g + o; return res[size / 2];}},
+        {"magnitude",             [&] {res = sqrt(a*a + b*b); return res[size - 1];}},
+        {"fast::sin(a)",          [&] {res = fast::sin(a); return res[size / 3];}},
+        {"res *= g",              [&] {res *= g; res /= g; return res[0];}},
+        {"sum",                   [&] {return a.sum();}},
+        {"norm2",                 [&] {return a.norm2();}},
+        {"max",                   [&] {return a.max();}},
+        {"dot",                   [&] {return KDot(a.get_ptr(), b.get_ptr(), size);}},
+        {"sum((a - b)^2)",        [&] {return sum((a - b) * (a - b));}},
+    };
+
+    std::vector<unsigned int> threads_nums;
+
+    for(unsigned int t=1; t<=max_threads; t*=2)
+        threads_nums.push_back(t);
+
+    printf("%zu samples, %u cores\n\n", size,
+           std::thread::hardware_concurrency());
+    printf("%-22s", "Msamples/s");
+
+    for(unsigned int t : threads_nums)
+        printf(" %7u th", t);
+
+    printf("  Identical\n");
+
+    for(const Bench& bench : benchs) {
+        printf("%-22s", bench.name);
+        float ref = 0;
+        bool identical = true;
+
+        for(unsigned int t : threads_nums) {
+            // Threshold at one chunk: the vector is always split
+            KSetParallel(t, KPAR_CHUNK_SIZE);
+            float val;
+            printf(" %10.0f", msps(bench.run, size, &val));
+
+            if(t == 1)
+                ref = val;
+            else
+                identical = identical && memcmp(&ref, &val, sizeof(float)) == 0;
+
+            fflush(stdout);
+        }
+
+        printf("  %s\n", identical ? "yes" : "NO");
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/// @file kvector_alloc.cpp
+///
+/// @brief Allocations of a processing loop with the KVector allocators
+///
+/// Runs the same processing step (copy of an acquired buffer,
+/// calibration, statistics, filtering through functions returning
+/// vectors) with std::allocator and with the default pool allocator.
+/// The system allocations are counted by replacing the global
+/// operator new (std::allocator) and by the pool statistics.
+///
+/// Usage: kvector_alloc [size] [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include <signal/kvector.hpp>
+
+using Klib::KVector;
+using Klib::KBlockPool;
+
+static unsigned long allocs_num = 0;
+
+void* operator new(size_t size)
+{
+    allocs_num++;
+    void *ptr = malloc(size);
+
+    if(ptr == NULL)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+/// Moving average on 4 samples, returned by value
+template<typename Vector>
+static Vector smooth(const Vector& x)
+{
+    Vector res(x.size(), 0.0f);
+
+    for(size_t i=3; i<x.size(); i++)
+        res[i] = 0.25f * (x[i] + x[i-1] + x[i-2] + x[i-3]);
+
+    return res;
+}
+
+template<typename Vector>
+static float process(std::vector<float>& adc, Vector& history)
+{
+    Vector raw(adc.data(), adc.size());
+    Vector volts = raw * 0.0012f - 0.5f;
+    Vector filtered = smooth(volts);
+    Vector centered = filtered - filtered.mean();
+    float rms = centered.norm2();
+    history = centered;     // Copy into a kept vector
+    volts = smooth(history); // Move assignment
+    return rms + volts.max();
+}
+
+template<typename Vector>
+static void run(const char *name, size_t size, unsigned int iterations)
+{
+    std::vector<float> adc(size);
+
+    for(size_t i=0; i<size; i++)
+        adc[i] = static_cast<float>(rand() % 16384);
+
+    Vector history(size);
+    volatile float sink = process(adc, history); // Warm up
+
+    unsigned long allocs_start = allocs_num;
+    KBlockPool::Stats stats_start = KBlockPool::GetStats();
+    auto start = std::chrono::steady_clock::now();
+
+    for(unsigned int i=0; i<iterations; i++)
+        sink += process(adc, history);
+
+    double duration = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - start).count();
+    KBlockPool::Stats stats = KBlockPool::GetStats();
+
+    unsigned long sys_allocs = allocs_num - allocs_start
+                               + stats.misses - stats_start.misses;
+    printf("%-16s %14.2f %14.2f %14.2f %10s\n", name,
+           double(sys_allocs) / iterations,
+           double(stats.hits - stats_start.hits) / iterations,
+           duration / iterations,
+           reinterpret_cast<uintptr_t>(history.get_ptr()) % 64 == 0
+               ? "yes" : "no");
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = argc > 1 ? strtoul(argv[1], NULL, 10) : 16384;
+    unsigned int iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000;
+
+    if(size == 0 || iterations == 0) {
+        fprintf(stderr, "Usage: %s [size] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu samples, %u iterations\n\n", size, iterations);
+    printf("%-16s %14s %14s %14s %10s\n", "Allocator",
+           "System allocs", "Pool allocs", "us/iteration", "Aligned");
+
+    run< KVector<float, std::allocator<float> > >("std::allocator",
+                                                  size, iterations);
+    run< KVector<float> >("pool (default)", size, iterations);
+    return EXIT_SUCCESS;
+}
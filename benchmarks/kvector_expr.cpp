@@ -0,0 +1,142 @@
+/// @file kvector_expr.cpp
+///
+/// @brief Allocations and time per sample of KVector expressions
+///
+/// Each chain is evaluated in one loop by the expression templates, 
+/// and step by step with a temporary vector per operation, as before
+/// the expression templates. The allocations are counted by replacing
+/// the global operator new, hence the vectors use std::allocator
+/// instead of the pool (see kvector_alloc.cpp).
+///
+/// Usage: kvector_expr [size] [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <new>
+
+#include <signal/kvector.hpp>
+
+typedef Klib::KVector<float, std::allocator<float> > Vector;
+
+static unsigned long allocs_num = 0;
+
+void* operator new(size_t size)
+{
+    allocs_num++;
+    void *ptr = malloc(size);
+
+    if(ptr == NULL)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+/// Run a chain and print the allocations and the time per sample
+template<class Chain>
+static void run(const char *name, size_t size, unsigned int iterations, 
+                Chain chain)
+{
+    volatile float sink = 0;
+    sink += chain(); // Warm up
+
+    unsigned long allocs_start = allocs_num;
+    auto start = std::chrono::steady_clock::now();
+
+    for(unsigned int i=0; i<iterations; i++)
+        sink += chain();
+
+    double duration = std::chrono::duration<double, std::nano>(
+                            std::chrono::steady_clock::now() - start).count();
+
+    printf("%-36s %10.1f %12.3f\n", name, 
+           double(allocs_num - allocs_start) / iterations,
+           duration / iterations / size);
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = argc > 1 ? strtoul(argv[1], NULL, 10) : 16384;
+    unsigned int iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000;
+
+    if(size == 0 || iterations == 0) {
+        fprintf(stderr, "Usage: %s [size] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Vector a(size), b(size), x(-4.0f, 4.0f, size);
+    Vector res(size);
+    float n = 3.0f, g = 1.5f, o = -0.25f, s = 2.0f;
+
+    for(size_t i=0; i<size; i++) {
+        a[i] = (rand() % 16384) - 8192.0f;
+        b[i] = (rand() % 16384) - 8192.0f;
+    }
+
+    printf("%zu samples, %u iterations\n\n", size, iterations);
+    printf("%-36s %10s %12s\n", "Chain", "Allocs", "ns/sample");
+
+    // sqrt(a*a + b*b) / n
+    run("magnitude (fused)", size, iterations, [&] {
+        res = sqrt(a*a + b*b) / n;
+        return res[0];
+    });
+
+    run("magnitude (step by step)", size, iterations, [&] {
+        Vector a2 = a*a;
+        Vector b2 = b*b;
+        Vector sum = a2 + b2;
+        Vector root = sqrt(sum);
+        res = Vector(root / n);
+        return res[0];
+    });
+
+    // a*g + o
+    run("affine (fused)", size, iterations, [&] {
+        res = a*g + o;
+        return res[0];
+    });
+
+    run("affine (step by step)", size, iterations, [&] {
+        Vector scaled = a*g;
+        res = Vector(scaled + o);
+        return res[0];
+    });
+
+    // exp(-(x*x) / s) * n
+    run("gaussian (fused)", size, iterations, [&] {
+        res = exp(-(x*x) / s) * n;
+        return res[0];
+    });
+
+    run("gaussian (step by step)", size, iterations, [&] {
+        Vector x2 = x*x;
+        Vector neg = -x2;
+        Vector arg = neg / s;
+        Vector e = exp(arg);
+        res = Vector(e * n);
+        return res[0];
+    });
+
+    // sum((a - b) * (a - b))
+    run("squared distance (fused)", size, iterations, [&] {
+        return sum((a - b) * (a - b));
+    });
+
+    run("squared distance (step by step)", size, iterations, [&] {
+        Vector diff = a - b;
+        Vector sq = diff * diff;
+        return sq.sum();
+    });
+
+    return 0;
+}
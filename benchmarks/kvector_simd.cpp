@@ -0,0 +1,255 @@
+/// @file kvector_simd.cpp
+///
+/// @brief Time per sample of the vectorized KVector kernels
+///
+/// Compares the reductions of KVector (kreduce.hpp) with the
+/// sequential loops they replace, and the fast math functions
+/// (kfastmath.hpp) with the std ones. The error column is the
+/// maximum relative error of the reductions, and the maximum
+/// absolute (sin, cos) or relative (exp, log) error of the functions.
+///
+/// Usage: kvector_simd [size] [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+
+#include <signal/kvector.hpp>
+#include <signal/kfastmath.hpp>
+
+using Klib::KVector;
+
+/// Time per sample of a function (ns)
+template<class Func>
+static double time_per_sample(size_t size, unsigned int iterations, Func func)
+{
+    volatile double sink = 0;
+    sink += func(); // Warm up
+
+    auto start = std::chrono::steady_clock::now();
+
+    for(unsigned int i=0; i<iterations; i++)
+        sink += func();
+
+    double duration = std::chrono::duration<double, std::nano>(
+                            std::chrono::steady_clock::now() - start).count();
+    return duration / iterations / size;
+}
+
+static void print_result(const char *name, double t_ref, double t_new,
+                         double error)
+{
+    printf("%-14s %10.3f %10.3f %8.2f %12.2e\n",
+           name, t_ref, t_new, t_ref / t_new, error);
+}
+
+static double rel_error(double ref, double val)
+{
+    return ref == 0 ? std::fabs(val) : std::fabs((val - ref) / ref);
+}
+
+// ---------------------------------------
+// Sequential reductions
+// ---------------------------------------
+
+template<typename T>
+static T ref_sum(const KVector<T>& x)
+{
+    T res = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        res += x[i];
+
+    return res;
+}
+
+template<typename T>
+static T ref_min(const KVector<T>& x)
+{
+    T res = x[0];
+
+    for(size_t i=1; i<x.size(); i++)
+        if(x[i] < res)
+            res = x[i];
+
+    return res;
+}
+
+template<typename T>
+static T ref_max(const KVector<T>& x)
+{
+    T res = x[0];
+
+    for(size_t i=1; i<x.size(); i++)
+        if(x[i] > res)
+            res = x[i];
+
+    return res;
+}
+
+template<typename T>
+static T ref_norm1(const KVector<T>& x)
+{
+    T res = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        res += std::fabs(x[i]);
+
+    return res;
+}
+
+template<typename T>
+static T ref_norm2(const KVector<T>& x)
+{
+    T res = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        res += x[i] * x[i];
+
+    return std::sqrt(res);
+}
+
+template<typename T>
+static T ref_normp(const KVector<T>& x, uint32_t p)
+{
+    T res = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        res += std::pow(std::fabs(x[i]), static_cast<T>(p));
+
+    return std::pow(res, 1/static_cast<T>(p));
+}
+
+template<typename T>
+static T ref_var(const KVector<T>& x)
+{
+    T mean = ref_sum(x) / x.size();
+    T res = 0;
+
+    for(size_t i=0; i<x.size(); i++)
+        res += (x[i] - mean) * (x[i] - mean);
+
+    return res / x.size();
+}
+
+#define BENCH_REDUCTION(name, ref_expr, new_expr)                           \
+    do {                                                                    \
+        double ref_val = ref_expr, new_val = new_expr;                      \
+        print_result(name,                                                  \
+            time_per_sample(size, iterations, [&]{return ref_expr;}),       \
+            time_per_sample(size, iterations, [&]{return new_expr;}),       \
+            rel_error(ref_val, new_val));                                   \
+    } while(0)
+
+template<typename T>
+static void bench_reductions(const char *type, size_t size,
+                             unsigned int iterations)
+{
+    KVector<T> x(size);
+
+    for(size_t i=0; i<size; i++)
+        x[i] = std::sin(T(0.001) * i) + T(0.25) * ((i * 7919) % 13) - 1;
+
+    printf("\nReductions (%s)\n", type);
+    printf("%-14s %10s %10s %8s %12s\n",
+           "", "loop (ns)", "simd (ns)", "speedup", "rel. error");
+
+    BENCH_REDUCTION("sum", ref_sum(x), x.sum());
+    BENCH_REDUCTION("min", ref_min(x), x.min());
+    BENCH_REDUCTION("max", ref_max(x), x.max());
+    BENCH_REDUCTION("norm1", ref_norm1(x), x.norm1());
+    BENCH_REDUCTION("norm2", ref_norm2(x), x.norm2());
+    BENCH_REDUCTION("normp(3)", ref_normp(x, 3), x.normp(3));
+    BENCH_REDUCTION("var", ref_var(x), x.var());
+}
+
+// ---------------------------------------
+// Fast math
+// ---------------------------------------
+
+template<class StdFunc, class FastFunc>
+static void bench_function(const char *name, const KVector<float>& x,
+                           unsigned int iterations, bool relative,
+                           StdFunc std_func, FastFunc fast_func)
+{
+    size_t size = x.size();
+    KVector<float> ref(size), res(size);
+
+    double t_ref = time_per_sample(size, iterations, [&] {
+        for(size_t i=0; i<size; i++)
+            ref[i] = std_func(x[i]);
+
+        return ref[size / 2];
+    });
+
+    double t_new = time_per_sample(size, iterations, [&] {
+        res = fast_func(x);
+        return res[size / 2];
+    });
+
+    double error = 0;
+
+    for(size_t i=0; i<size; i++) {
+        double err = relative ? rel_error(ref[i], res[i])
+                              : std::fabs(double(res[i]) - ref[i]);
+        error = err > error ? err : error;
+    }
+
+    print_result(name, t_ref, t_new, error);
+}
+
+static void bench_fast_math(size_t size, unsigned int iterations)
+{
+    KVector<float> x(-80.0f, 80.0f, size);
+    KVector<float> xpos(1e-30f, 1e30f, size);
+    KVector<float> xtrig(-8000.0f, 8000.0f, size);
+    KVector<float> y(size);
+
+    printf("\nFast math (float)\n");
+    printf("%-14s %10s %10s %8s %12s\n",
+           "", "std (ns)", "fast (ns)", "speedup", "max. error");
+
+    bench_function("exp", x, iterations, true,
+                   [](float v) {return std::exp(v);},
+                   [](const KVector<float>& v) {return Klib::fast::exp(v);});
+    bench_function("log", xpos, iterations, true,
+                   [](float v) {return std::log(v);},
+                   [](const KVector<float>& v) {return Klib::fast::log(v);});
+    bench_function("sin", xtrig, iterations, false,
+                   [](float v) {return std::sin(v);},
+                   [](const KVector<float>& v) {return Klib::fast::sin(v);});
+    bench_function("cos", xtrig, iterations, false,
+                   [](float v) {return std::cos(v);},
+                   [](const KVector<float>& v) {return Klib::fast::cos(v);});
+
+    // Element-wise evaluation of the scalar version in an expression
+    bench_function("sin (expr)", xtrig, iterations, false,
+                   [](float v) {return std::sin(2.0f * v) * 0.5f;},
+                   [&](const KVector<float>& v) {
+                       y = Klib::fast::sin(2.0f * v) * 0.5f;
+                       return y;
+                   });
+}
+
+int main(int argc, char **argv)
+{
+    size_t size = argc > 1 ? strtoul(argv[1], NULL, 10) : 16384;
+    unsigned int iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000;
+
+    if(size == 0 || iterations == 0) {
+        fprintf(stderr, "Usage: %s [size] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu samples, %u iterations\n", size, iterations);
+    bench_reductions<float>("float", size, iterations);
+    bench_reductions<double>("double", size, iterations);
+    bench_fast_math(size, iterations);
+    return EXIT_SUCCESS;
+}
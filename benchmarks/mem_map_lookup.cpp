@@ -0,0 +1,147 @@
+/// @file mem_map_lookup.cpp
+///
+/// @brief Registers operations per second through Klib::DevMem
+///
+/// Measures the path of the DEV_MEM register operations (READ, WRITE, 
+/// SET_BIT): memory map lookup and register access, without the network.
+/// The lookup of the std::map previously used by DevMem is given as a
+/// reference. The device memory is replaced by a temporary file.
+///
+/// Usage: mem_map_lookup [maps_num] [iterations]
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <vector>
+
+extern "C" {
+    #include <unistd.h>
+}
+
+#include <drivers/core/dev_mem.hpp>
+#include <drivers/core/wr_register.hpp>
+
+#define MAP_SIZE 4096
+
+/// Operations per second
+static double ops_rate(uint64_t ops, std::chrono::steady_clock::duration duration)
+{
+    return ops / std::chrono::duration<double>(duration).count();
+}
+
+template<class Op>
+static double run(const std::vector<Klib::MemMapID>& ids, 
+                  unsigned int iterations, Op op)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for(unsigned int i=0; i<iterations; i++)
+        for(unsigned int j=0; j<ids.size(); j++)
+            op(ids[j], (i & 0xFF) * sizeof(uint32_t));
+
+    return ops_rate(static_cast<uint64_t>(iterations) * ids.size(),
+                    std::chrono::steady_clock::now() - start);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int maps_num = argc > 1 ? strtoul(argv[1], NULL, 10) : 16;
+    unsigned int iterations = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+
+    if(maps_num == 0 || maps_num > MEMMAP_SLOTS_NUM || iterations == 0) {
+        fprintf(stderr, "Usage: %s [maps_num] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char path[] = "/tmp/mem_map_lookupXXXXXX";
+    int fd = mkstemp(path);
+
+    if(fd < 0 || ftruncate(fd, 2 * MAP_SIZE * (maps_num + 1)) < 0) {
+        fprintf(stderr, "Can't create the backing file\n");
+        return EXIT_FAILURE;
+    }
+
+    Klib::DevMem dev_mem;
+    int ret = dev_mem.Open(path);
+    unlink(path);
+    close(fd);
+
+    if(ret < 0)
+        return EXIT_FAILURE;
+
+    std::vector<Klib::MemMapID> ids;
+    std::map<Klib::MemMapID, Klib::MemoryMap*> std_maps;
+
+    // The first page is left unmapped (address 0 isn't mapped by DevMem).
+    // The maps are not adjacent, else they would share one mapping.
+    for(unsigned int i=0; i<maps_num; i++) {
+        Klib::MemMapID id = dev_mem.AddMemoryMap(2 * MAP_SIZE * (i + 1), 
+                                                 MAP_SIZE);
+
+        if(id == MEMMAP_INVALID_ID)
+            return EXIT_FAILURE;
+
+        ids.push_back(id);
+        std_maps[id] = &dev_mem.GetMemMap(id);
+    }
+
+    printf("%u memory maps, %u iterations\n\n", maps_num, iterations);
+    printf("%-28s %14s\n", "Operation", "Mops/s");
+
+    double rate = run(ids, iterations, [&](Klib::MemMapID id, uint32_t offset) {
+        Klib::ReadReg32(std_maps.at(id)->GetBaseAddr() + offset);
+    });
+    printf("%-28s %14.1f\n", "READ (std::map reference)", 1E-6 * rate);
+
+    rate = run(ids, iterations, [&](Klib::MemMapID id, uint32_t offset) {
+        intptr_t base_addr = dev_mem.GetBaseAddr(id);
+
+        if(base_addr != 0)
+            Klib::ReadReg32(base_addr + offset);
+    });
+    printf("%-28s %14.1f\n", "READ", 1E-6 * rate);
+
+    rate = run(ids, iterations, [&](Klib::MemMapID id, uint32_t offset) {
+        intptr_t base_addr = dev_mem.GetBaseAddr(id);
+
+        if(base_addr != 0)
+            Klib::WriteReg32(base_addr + offset, offset);
+    });
+    printf("%-28s %14.1f\n", "WRITE", 1E-6 * rate);
+
+    rate = run(ids, iterations, [&](Klib::MemMapID id, uint32_t offset) {
+        intptr_t base_addr = dev_mem.GetBaseAddr(id);
+
+        if(base_addr != 0)
+            Klib::SetBit(base_addr + offset, offset & 0x1F);
+    });
+    printf("%-28s %14.1f\n", "SET_BIT", 1E-6 * rate);
+
+    // Stale IDs: removed and added again in the same slots
+    std::vector<Klib::MemMapID> stale_ids = ids;
+
+    for(unsigned int i=0; i<maps_num; i++) {
+        dev_mem.RmMemoryMap(ids[i]);
+        ids[i] = dev_mem.AddMemoryMap(2 * MAP_SIZE * (i + 1), MAP_SIZE);
+    }
+
+    unsigned int rejected = 0;
+
+    rate = run(stale_ids, iterations, [&](Klib::MemMapID id, uint32_t offset) {
+        rejected += dev_mem.GetBaseAddr(id) == 0;
+    });
+    printf("%-28s %14.1f\n", "Stale ID lookup", 1E-6 * rate);
+
+    if(rejected != static_cast<uint64_t>(iterations) * maps_num) {
+        fprintf(stderr, "Stale IDs accepted\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -57,7 +57,7 @@ _kserver()
         ;;
     # STATUS
     status)
-        local status_opts="-h --help -d --devices -s --sessions -p --perfs"
+        local status_opts="-h --help -d --devices -s --sessions -p --perfs -o --perf"
         COMPREPLY=( $(compgen -W "${status_opts}" -- ${cur}) )
         return 0
         ;;
@@ -80,6 +80,7 @@ void __stop_client(struct kclient *kcl)
 #define IS_STATUS_DEVICES  TEST_CMD("-d", "--devices")
 #define IS_STATUS_SESSIONS TEST_CMD("-s", "--sessions")
 #define IS_STATUS_PERFS    TEST_CMD("-p", "--perfs")
+#define IS_STATUS_OPS_PERF TEST_CMD("-o", "--perf")
 
 /**
  * __status_usage - Help for the status command
@@ -100,6 +101,10 @@ void __status_usage(void)
            "Show the running sessions");
     printf("%-10s%-15s%-15s%-50s\n", "-p", "--perfs", "SID", 
            "Show the perfs of the session with ID SID");
+    printf("%-10s%-15s%-15s%-50s\n", "-o", "--perf", "", 
+           "Show the operations latencies since server start");
+    printf("%-10s%-15s%-15s%-50s\n", "-o", "--perf", "SID", 
+           "Show the operations latencies of the session with ID SID");
 }
 
 /**
@@ -184,6 +189,28 @@ void __display_perfs(struct session_perfs *perfs)
     }
 }
 
+/**
+ * __display_ops_perfs - Display the operations latencies
+ * @perfs: Operations perfs structure
+ */
+void __display_ops_perfs(struct ops_perfs *perfs)
+{
+    int i;
+    struct op_perf op;
+    
+    printf("\e[7m%-15s%-25s%-12s%-12s%-12s%-12s%-12s%-12s\e[27m\n",
+           "DEVICE", "OPERATION", "COUNT", "MEAN (ns)", "P50 (ns)", 
+           "P90 (ns)", "P99 (ns)", "MAX (ns)");
+
+    for (i=0; i<perfs->ops_num; i++) {
+        op = perfs->ops[i];
+        
+        printf("%-15s%-25s%-12llu%-12.0f%-12llu%-12llu%-12llu%-12llu\n",
+               op.dev_name, op.op_name, op.count, op.mean,
+               op.p50, op.p90, op.p99, op.max);
+    }
+}
+
 /**
  * __display_sessions - Display running sessions
  * @sessions: Running sessions structure
@@ -338,6 +365,58 @@ void ks_cli_status(int argc, char **argv)
         free(sessions);
         free(perfs);
         __stop_client(kcl);        
+    }
+    else if (IS_STATUS_OPS_PERF) {
+        struct kclient *kcl;
+        struct ops_perfs *perfs;
+        int sid = -1; // Whole server
+        
+        if (argc > 3) {
+            fprintf(stderr, "Invalid number of arguments.\n"
+                            "Expect an optional session ID\n");
+            exit(EXIT_FAILURE);
+        }
+        
+        if (argc == 3)
+            sid = (int) strtol(argv[2], (char **)NULL, 10);
+        
+        kcl = __start_client();
+        
+        if (kcl == NULL) {
+            fprintf(stderr, "Connection failed\n");
+            exit(EXIT_FAILURE);
+        }
+        
+        if (sid != -1) {
+            struct running_sessions *sessions 
+                = kclient_get_running_sessions(kcl);
+        
+            if (sessions == NULL) {
+                __stop_client(kcl);
+                exit(EXIT_FAILURE);
+            }
+            
+            if (!kclient_is_valid_sess_id(sessions, sid)) {
+                fprintf(stderr, "Invalid session ID %d\n", sid);
+                free(sessions);
+                __stop_client(kcl);
+                exit(EXIT_FAILURE);
+            }
+            
+            free(sessions);
+        }
+        
+        perfs = kclient_get_ops_perfs(kcl, sid);
+        
+        if (perfs == NULL) {
+            __stop_client(kcl);
+            exit(EXIT_FAILURE);
+        }
+        
+        __display_ops_perfs(perfs);
+        
+        free(perfs);
+        __stop_client(kcl);
     } else {
         fprintf(stderr, "Invalid status command: %s\n", argv[1]);
         __status_usage();
@@ -0,0 +1,264 @@
+/// @file args_parser.hpp
+///
+/// @brief Generic parser for the arguments of the device operations
+///
+/// The fields of an Argument<op> structure are exposed as a tuple
+/// of references (see ARGUMENT_FIELDS in kdevice.hpp). The parser
+/// walks this tuple at compile time and decodes each '|' separated
+/// field of the command buffer directly into the structure.
+///
+/// Example: the buffer "1|256|" of the command "2|3|1|256|\n" fills
+/// Argument<KS_Dev_mem::READ> with mmap_idx = 1 and offset = 256.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __ARGS_PARSER_HPP__
+#define __ARGS_PARSER_HPP__
+
+#include <tuple>
+#include <limits>
+#include <cstdlib>
+#include <cstdint>
+#include <type_traits>
+
+#include "kdevice.hpp"
+#include "commands.hpp"
+#include "kserver.hpp"
+
+namespace kserver {
+
+/// Parsing errors
+typedef enum {
+    PARSE_OK,
+    PARSE_INVALID_CHAR,     ///< Unexpected character in a numeric field
+    PARSE_EMPTY_FIELD,      ///< Field without any digit
+    PARSE_OVERFLOW,         ///< Value out of range for the field type
+    PARSE_MISSING_FIELDS,   ///< Less fields than expected
+    PARSE_EXTRA_FIELDS,     ///< More fields than expected
+    parse_errors_num
+} parse_error_t;
+
+/// Parsing error descriptions
+const std::array< std::string, parse_errors_num >
+parse_error_desc = {{
+    "OK",
+    "Invalid character",
+    "Empty field",
+    "Value out of range",
+    "Missing parameters",
+    "Too many parameters"
+}};
+
+/// Result of the parsing of a command buffer
+struct ParseStatus
+{
+    parse_error_t error = PARSE_OK;
+    unsigned int field = 0;     ///< Index of the field in error
+    unsigned int position = 0;  ///< Offset of the error in the buffer
+};
+
+// ---------------------------------------------
+// Fields
+// ---------------------------------------------
+
+// Each parse_field function reads the field starting at ptr
+// up to the '|' delimiter. On success ptr points to the first
+// character of the next field.
+
+/// Parse an unsigned integer
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value
+                               && std::is_unsigned<T>::value,
+                               parse_error_t>::type
+parse_field(const char*& ptr, T& value)
+{
+    const char *start = ptr;
+    uintmax_t acc = 0;
+
+    while(*ptr != '|') {
+        if(*ptr == '\0')
+            return PARSE_MISSING_FIELDS;
+
+        unsigned int digit = static_cast<unsigned int>(*ptr - '0');
+
+        if(digit > 9)
+            return PARSE_INVALID_CHAR;
+
+        if(acc > (std::numeric_limits<T>::max() - digit) / 10)
+            return PARSE_OVERFLOW;
+
+        acc = 10 * acc + digit;
+        ptr++;
+    }
+
+    if(ptr == start)
+        return PARSE_EMPTY_FIELD;
+
+    value = static_cast<T>(acc);
+    ptr++; // Skip '|'
+    return PARSE_OK;
+}
+
+/// Parse a signed integer
+template<typename T>
+inline typename std::enable_if<std::is_integral<T>::value
+                               && std::is_signed<T>::value,
+                               parse_error_t>::type
+parse_field(const char*& ptr, T& value)
+{
+    typedef typename std::make_unsigned<T>::type U;
+
+    bool is_negative = (*ptr == '-');
+
+    if(is_negative)
+        ptr++;
+
+    const char *start = ptr;
+    U abs_val = 0;
+    parse_error_t err = parse_field<U>(ptr, abs_val);
+
+    if(err != PARSE_OK) {
+        // Report the position of the sign for an empty field
+        if(err == PARSE_EMPTY_FIELD && is_negative)
+            ptr = start - 1;
+
+        return err;
+    }
+
+    U max_abs = static_cast<U>(std::numeric_limits<T>::max())
+                + (is_negative ? 1 : 0);
+
+    if(abs_val > max_abs) {
+        ptr = start;
+        return PARSE_OVERFLOW;
+    }
+
+    value = is_negative ? static_cast<T>(-static_cast<intmax_t>(abs_val))
+                        : static_cast<T>(abs_val);
+    return PARSE_OK;
+}
+
+/// Parse a floating point number
+template<typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value,
+                               parse_error_t>::type
+parse_field(const char*& ptr, T& value)
+{
+    char *end;
+    double val = strtod(ptr, &end);
+
+    if(end == ptr)
+        return *ptr == '|' ? PARSE_EMPTY_FIELD : PARSE_INVALID_CHAR;
+
+    ptr = end;
+
+    if(*ptr == '\0')
+        return PARSE_MISSING_FIELDS;
+
+    if(*ptr != '|')
+        return PARSE_INVALID_CHAR;
+
+    value = static_cast<T>(val);
+    ptr++;
+    return PARSE_OK;
+}
+
+/// Parse a boolean ('0' or '1')
+inline parse_error_t parse_field(const char*& ptr, bool& value)
+{
+    if(*ptr == '\0')
+        return PARSE_MISSING_FIELDS;
+
+    if(*ptr == '|')
+        return PARSE_EMPTY_FIELD;
+
+    if((*ptr != '0' && *ptr != '1') || *(ptr + 1) != '|')
+        return PARSE_INVALID_CHAR;
+
+    value = (*ptr == '1');
+    ptr += 2;
+    return PARSE_OK;
+}
+
+// ---------------------------------------------
+// Buffer
+// ---------------------------------------------
+
+// Compile time recursion over the fields (see tuple_utils.hpp)
+
+template<std::size_t I = 0, typename... Tp>
+inline typename std::enable_if<I == sizeof...(Tp), parse_error_t>::type
+parse_fields(const char*& ptr, std::tuple<Tp&...>& fields,
+             unsigned int& field_idx)
+{
+    field_idx = I;
+    return *ptr == '\0' ? PARSE_OK : PARSE_EXTRA_FIELDS;
+}
+
+template<std::size_t I = 0, typename... Tp>
+inline typename std::enable_if<I < sizeof...(Tp), parse_error_t>::type
+parse_fields(const char*& ptr, std::tuple<Tp&...>& fields,
+             unsigned int& field_idx)
+{
+    field_idx = I;
+    parse_error_t err = parse_field(ptr, std::get<I>(fields));
+
+    if(err != PARSE_OK)
+        return err;
+
+    return parse_fields<I + 1, Tp...>(ptr, fields, field_idx);
+}
+
+/// @brief Parse a command buffer into a tuple of fields
+/// @buffer Null-terminated buffer "p1|p2|...|pn|"
+/// @fields References to the fields to be filled
+/// @return The parsing status
+template<typename... Tp>
+inline ParseStatus parse_buffer(const char *buffer,
+                                std::tuple<Tp&...> fields)
+{
+    ParseStatus status;
+    const char *ptr = buffer;
+
+    if(buffer == nullptr) {
+        status.error = sizeof...(Tp) == 0 ? PARSE_OK : PARSE_MISSING_FIELDS;
+        return status;
+    }
+
+    status.error = parse_fields(ptr, fields, status.field);
+    status.position = static_cast<unsigned int>(ptr - buffer);
+    return status;
+}
+
+// ---------------------------------------------
+// KDevice
+// ---------------------------------------------
+
+/// Default parser of the device operations
+///
+/// The arguments are decoded according to the fields
+/// declared with ARGUMENT_FIELDS in the Argument structure.
+template<class Dev, device_t dev_kind>
+template<int op>
+int KDevice<Dev, dev_kind>::parse_arg(const Command& cmd,
+                                      Argument<op>& args)
+{
+    ParseStatus status = parse_buffer(cmd.buffer, args.fields());
+
+    if(status.error != PARSE_OK) {
+        kserver->syslog.print(SysLog::ERROR,
+                "%s::%s: %s (parameter #%u at position %u)\n",
+                GET_DEVICE_DESC(cmd).c_str(), GET_OPERATION_DESC(cmd).c_str(),
+                parse_error_desc[status.error].c_str(),
+                status.field + 1, status.position);
+        return -1;
+    }
+
+    return 0;
+}
+
+} // namespace kserver
+
+#endif // __ARGS_PARSER_HPP__
@@ -17,6 +17,13 @@ void Command::print(void)
     printf("Device = %u\n", (uint32_t)device);
     printf("Operation = %u\n", operation);
     printf("Buffer = %s\n", buffer);
+
+    if(async)
+        printf("Request ID = %u\n", req_id);
+
+    if(encoding != 0)
+        printf("Encoding = %u\n", encoding);
+
     printf("Parsing = %s\n", parsing_err ? "ERR" : "OK");
     printf("Status = %u\n", (uint32_t)status);
 }
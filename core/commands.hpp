@@ -29,6 +29,10 @@ struct Command
     uint32_t operation = -1;        ///< Operation ID
     char* buffer = nullptr;         ///< data buffer
 
+    bool async = 0;                 ///< True if asynchronous (#ID| prefix)
+    uint32_t req_id = 0;            ///< Request ID of an asynchronous command
+    uint32_t encoding = 0;          ///< Encoding of the array replies (%ENC| prefix)
+
     bool parsing_err = 0;           ///< True if parsing error
     exec_status_t status = exec_pending; ///< Execution status
     
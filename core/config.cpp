@@ -14,6 +14,8 @@
 
 #include "config.hpp"
 
+#include <drivers/core/mem_backend.hpp>
+
 namespace kserver {
 
 KServerConfig::KServerConfig()
@@ -27,12 +29,23 @@ KServerConfig::KServerConfig()
   websock_worker_connections(DFLT_WORKER_CONNECTIONS),
   unixsock_worker_connections(DFLT_WORKER_CONNECTIONS),
   addr_limit_down(DFLT_ADDR_LIMIT_DOWN),
-  addr_limit_up(DFLT_ADDR_LIMIT_UP)
+  addr_limit_up(DFLT_ADDR_LIMIT_UP),
+  mem_base(DFLT_MEM_SIM_BASE),
+  mem_size(DFLT_MEM_SIM_SIZE),
+  signal_threads(DFLT_SIGNAL_THREADS),
+  signal_parallel_threshold(DFLT_SIGNAL_PARALLEL_THRESHOLD),
+  signal_pool_cache_bytes(DFLT_SIGNAL_POOL_CACHE_BYTES)
 //  interrupt(NULL)
    //sess_interrupt(NULL)
 {
    memset(unixsock_path, 0, UNIX_SOCKET_PATH_LEN);
    strcpy(unixsock_path, DFLT_UNIX_SOCK_PATH);
+   
+   for(mem_backend=0; mem_backend<Klib::mem_backends_num; mem_backend++)
+       if(strcmp(Klib::mem_backends_names[mem_backend], DFLT_MEM_BACKEND) == 0)
+           break;
+
+   memset(mem_path, 0, MEM_BACKEND_PATH_LEN);
 }
 
 char* KServerConfig::_get_source(char *filename)
@@ -254,6 +267,91 @@ int KServerConfig::_read_addr_limits(JsonValue value)
     return 0;
 }
 
+int KServerConfig::_read_memory(JsonValue value)
+{
+    if(value.getTag() != JSON_OBJECT) {
+        fprintf(stderr, "Invalid memory field\n");
+        return -1;
+    }
+    
+    for (auto i : value) {
+        if(i->value.getTag() != JSON_STRING) {
+            fprintf(stderr, "Memory field %s must be a string\n", i->key);
+            return -1;
+        }
+
+        if(strcmp(i->key, "backend") == 0) {
+            uint32_t kind = 0;
+
+            while(kind < Klib::mem_backends_num
+                  && strcmp(Klib::mem_backends_names[kind], 
+                            i->value.toString()) != 0)
+                kind++;
+
+            if(kind == Klib::mem_backends_num) {
+                fprintf(stderr, "Unknown memory backend %s\n", 
+                        i->value.toString());
+                return -1;
+            }
+
+            mem_backend = kind;
+        }
+        else if(strcmp(i->key, "path") == 0) {
+            if(strlen(i->value.toString()) >= MEM_BACKEND_PATH_LEN) {
+                fprintf(stderr, "Memory path too long\n");
+                return -1;
+            }
+
+            memset(mem_path, 0, MEM_BACKEND_PATH_LEN);
+            strcpy(mem_path, i->value.toString());
+        }
+        else if(strcmp(i->key, "base") == 0) {
+            mem_base = (uintptr_t)strtoull(i->value.toString(), NULL, 0);
+        }
+        else if(strcmp(i->key, "size") == 0) {
+            mem_size = strtoull(i->value.toString(), NULL, 0);
+        }
+        else {
+            fprintf(stderr, "Unknown memory key %s\n", i->key);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
+int KServerConfig::_read_signal(JsonValue value)
+{
+    if(value.getTag() != JSON_OBJECT) {
+        fprintf(stderr, "Invalid signal field\n");
+        return -1;
+    }
+    
+    for (auto i : value) {
+        if(i->value.getTag() != JSON_NUMBER || i->value.toNumber() < 0) {
+            fprintf(stderr, "Signal field %s must be a positive number\n",
+                    i->key);
+            return -1;
+        }
+
+        if(strcmp(i->key, "threads") == 0) {
+            signal_threads = i->value.toNumber();
+        }
+        else if(strcmp(i->key, "parallel_threshold") == 0) {
+            signal_parallel_threshold = i->value.toNumber();
+        }
+        else if(strcmp(i->key, "pool_cache_bytes") == 0) {
+            signal_pool_cache_bytes = i->value.toNumber();
+        }
+        else {
+            fprintf(stderr, "Unknown signal key %s\n", i->key);
+            return -1;
+        }
+    }
+    
+    return 0;
+}
+
 void KServerConfig::_check_config()
 {
     if(daemon) {
@@ -282,6 +380,8 @@ void KServerConfig::_check_config()
 #define IS_WEBSOCKET    TEST_KEY("websocket")
 #define IS_UNIX         TEST_KEY("unix")
 #define IS_ADDR_LIMITS  TEST_KEY("addr_limits")
+#define IS_MEMORY       TEST_KEY("memory")
+#define IS_SIGNAL       TEST_KEY("signal")
 
 int KServerConfig::load_file(char *filename)
 {
@@ -341,6 +441,14 @@ int KServerConfig::load_file(char *filename)
             if(_read_addr_limits(i->value) < 0)
                 return -1;
         }
+        else if(IS_MEMORY) {
+            if(_read_memory(i->value) < 0)
+                return -1;
+        }
+        else if(IS_SIGNAL) {
+            if(_read_signal(i->value) < 0)
+                return -1;
+        }
         else {
             fprintf(stderr, "Unknown field %s in configuration file\n", i->key);
             return -1;
@@ -375,6 +483,17 @@ void KServerConfig::show()
     
     printf("Addr limit down: %lu\n", addr_limit_down);
     printf("Addr limit up: %lu\n\n", addr_limit_up);
+    
+    printf("Memory backend: %s\n", Klib::mem_backends_names[mem_backend]);
+    printf("Memory path: %s\n", mem_path);
+    printf("Memory base: 0x%llx\n", (unsigned long long)mem_base);
+    printf("Memory size: 0x%llx\n\n", (unsigned long long)mem_size);
+
+    printf("Signal threads: %u\n", signal_threads);
+    printf("Signal parallel threshold: %llu\n",
+           (unsigned long long)signal_parallel_threshold);
+    printf("Signal pool cache: %llu bytes\n",
+           (unsigned long long)signal_pool_cache_bytes);
     printf("\n====================================\n\n");
 }
 
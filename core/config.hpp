@@ -63,6 +63,21 @@ struct KServerConfig
     /// Allowed memory region for memory mapping
     intptr_t addr_limit_down;
     intptr_t addr_limit_up;
+
+    /// Backend of the physical memory (Klib::mem_backend_t)
+    uint32_t mem_backend;
+    /// Device or file of the backend (default path if empty)
+    char mem_path[MEM_BACKEND_PATH_LEN];
+    /// Simulated physical address space (file and memfd)
+    uintptr_t mem_base;
+    uint64_t mem_size;
+
+    /// Threads of the operations on the large vectors (0 for all the cores)
+    unsigned int signal_threads;
+    /// Size of the vectors above which their operations run in parallel
+    uint64_t signal_parallel_threshold;
+    /// Bytes of vector buffers kept for reuse by each thread
+    uint64_t signal_pool_cache_bytes;
     
   private:
     char* _get_source(char *filename);
@@ -79,6 +94,8 @@ struct KServerConfig
     int _read_websocket(JsonValue value);
     int _read_unixsocket(JsonValue value);
     int _read_addr_limits(JsonValue value);
+    int _read_memory(JsonValue value);
+    int _read_signal(JsonValue value);
 };
 
 } // namespace kserver
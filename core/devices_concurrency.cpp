@@ -0,0 +1,19 @@
+/// @file devices_concurrency.cpp
+///
+/// @brief Implementation of devices_concurrency.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "devices_concurrency.hpp"
+
+#if KSERVER_HAS_THREADS
+
+namespace kserver {
+
+thread_local SharedLockGuard *SharedLockGuard::current = nullptr;
+
+} // namespace kserver
+
+#endif // KSERVER_HAS_THREADS
@@ -0,0 +1,135 @@
+/// @file devices_concurrency.hpp
+///
+/// @brief Synchronization primitives enforcing the devices concurrency policies
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __DEVICES_CONCURRENCY_HPP__
+#define __DEVICES_CONCURRENCY_HPP__
+
+#include "kserver_defs.hpp"
+
+#if KSERVER_HAS_THREADS
+
+#include <mutex>
+
+extern "C" {
+  #include <pthread.h>
+}
+
+namespace kserver {
+
+/// @brief Reader/writer lock
+///
+/// std::shared_mutex is not available in C++11.
+///
+/// The writers are preferred: a pending exclusive operation blocks
+/// the new shared ones, so it can't be starved by a steady stream of
+/// shared operations. A thread must hence not take the shared lock
+/// twice.
+class RWLock
+{
+  public:
+    RWLock()
+    {
+        pthread_rwlockattr_t attr;
+        pthread_rwlockattr_init(&attr);
+#ifdef __GLIBC__
+        pthread_rwlockattr_setkind_np(&attr, 
+                PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+        pthread_rwlock_init(&rwlock, &attr);
+        pthread_rwlockattr_destroy(&attr);
+    }
+
+    ~RWLock() {pthread_rwlock_destroy(&rwlock);}
+
+    RWLock(const RWLock&) = delete;
+    RWLock& operator=(const RWLock&) = delete;
+
+    inline void lock() {pthread_rwlock_wrlock(&rwlock);}
+    inline void unlock() {pthread_rwlock_unlock(&rwlock);}
+    inline void lock_shared() {pthread_rwlock_rdlock(&rwlock);}
+    inline void unlock_shared() {pthread_rwlock_unlock(&rwlock);}
+
+  private:
+    pthread_rwlock_t rwlock;
+};
+
+/// @brief Hold a RWLock in shared mode within a scope
+///
+/// An operation can release the lock of its device before
+/// the end of the scope with SharedLockGuard::release(), once
+/// it doesn't access the device anymore (e.g. before sending
+/// a copy of the device memory to the client), or in between
+/// two slices of a long wait with SharedLockGuard::reacquire().
+class SharedLockGuard
+{
+  public:
+    SharedLockGuard(RWLock& rwlock_)
+    : rwlock(rwlock_)
+    , locked(true)
+    , previous(current)
+    {
+        rwlock.lock_shared();
+        current = this;
+    }
+
+    ~SharedLockGuard()
+    {
+        unlock();
+        current = previous;
+    }
+
+    inline void lock()
+    {
+        if(!locked) {
+            rwlock.lock_shared();
+            locked = true;
+        }
+    }
+
+    inline void unlock()
+    {
+        if(locked) {
+            rwlock.unlock_shared();
+            locked = false;
+        }
+    }
+
+    /// @brief Release the shared lock held by the calling thread
+    ///
+    /// No effect if the thread doesn't hold a shared lock
+    /// (exclusive operations keep their lock).
+    static inline void release()
+    {
+        if(current != nullptr)
+            current->unlock();
+    }
+
+    /// @brief Take back the shared lock released by the calling thread
+    ///
+    /// The device may have changed in between: the operation
+    /// must check again the resources it uses.
+    static inline void reacquire()
+    {
+        if(current != nullptr)
+            current->lock();
+    }
+
+  private:
+    RWLock& rwlock;
+    bool locked;
+    SharedLockGuard *previous;
+
+    /// Innermost guard of the thread
+    static thread_local SharedLockGuard *current;
+};
+
+} // namespace kserver
+
+#endif // KSERVER_HAS_THREADS
+
+#endif // __DEVICES_CONCURRENCY_HPP__
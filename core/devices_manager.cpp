@@ -22,8 +22,11 @@ DeviceManager::DeviceManager(KServer *kserver_)
   kserver(kserver_),
   dev_mem(kserver_->config->addr_limit_down, kserver_->config->addr_limit_up)
 {
+    for(auto& started : is_started)
+        started.store(false);
+
     device_list[KSERVER] = static_cast<KDeviceAbstract*>(kserver);
-    is_started[KSERVER] = 1;
+    is_started[KSERVER].store(true);
 }
 
 DeviceManager::~DeviceManager()
@@ -33,17 +36,47 @@ DeviceManager::~DeviceManager()
 
 int DeviceManager::Init()
 {
-#if KSERVER_HAS_DEVMEM
-    if(dev_mem.Open() < 0) {
+    KServerConfig *config = kserver->config;
+
+    if(config->mem_backend == Klib::MEM_BACKEND_NONE)
+        return 0;
+
+    std::unique_ptr<Klib::MemBackend> backend = Klib::MakeMemBackend(
+            config->mem_backend, config->mem_path, 
+            config->mem_base, config->mem_size);
+
+    if(dev_mem.Open(std::move(backend)) < 0) {
         kserver->syslog.print(SysLog::CRITICAL,
-                              "Can't start DevMem\n");
+                              "Can't start DevMem on backend %s\n",
+                              Klib::mem_backends_names[config->mem_backend]);
         return -1;
     }
-#endif
-    
+
+    kserver->syslog.print(SysLog::INFO, "DevMem backend: %s %s\n",
+                          dev_mem.GetBackend()->Name(),
+                          dev_mem.GetBackend()->Path().c_str());
     return 0;
 }
 
+void DeviceManager::ReleaseSession(SessID sess_id)
+{
+    // The memory maps and their snapshots are removed
+    // under the lock of DEV_MEM, as by RM_MEMORY_MAP
+#if KSERVER_HAS_THREADS
+    std::lock_guard<RWLock> lock(dev_locks[DEV_MEM]);
+#endif
+
+    std::vector<Klib::MemMapID> removed 
+        = dev_mem.ReleaseOwner(static_cast<uint32_t>(sess_id));
+
+    if(is_started[DEV_MEM]) {
+        KS_Dev_mem *ks_dev_mem = static_cast<KS_Dev_mem*>(device_list[DEV_MEM]);
+
+        for(Klib::MemMapID mmap_idx : removed)
+            ks_dev_mem->rm_snapshots(mmap_idx);
+    }
+}
+
 // X Macro: Start new device
 #define EXPAND_AS_START_DEVICE(num, name, operations ...)                \
         case num:                                                        \
@@ -58,6 +91,11 @@ int DeviceManager::StartDev(device_t dev)
     std::lock_guard<std::mutex> lock(mutex);
 #endif
 
+    return __start_dev(dev);
+}
+
+int DeviceManager::__start_dev(device_t dev)
+{
     assert(dev < device_num);
 
     // If already started, nothing to do
@@ -66,7 +104,7 @@ int DeviceManager::StartDev(device_t dev)
     }
 
     if(dev == NO_DEVICE) {
-        is_started[dev] = 1;
+        is_started[dev].store(true);
         return 0;
     }
     
@@ -95,23 +133,64 @@ int DeviceManager::StartDev(device_t dev)
         return -1;
     }
 
-    is_started[dev] = 1;
+    // Release: the device is constructed before
+    // being seen started by the other sessions
+    is_started[dev].store(true, std::memory_order_release);
 
     return 0;
 }
 
+template<class Dev, device_t dev_kind, unsigned int ops_num>
+int DeviceManager::__execute(KDeviceAbstract *dev_abs, const Command& cmd)
+{
+    static_assert(static_cast<int>(Dev::__concurrency) 
+                      != CONCURRENCY_READ_WRITE 
+                  || ops_num <= SHARED_OPS_MAX,
+                  "Too many operations for the mask __shared_ops");
+
+    KDevice<Dev, dev_kind> *dev = static_cast<KDevice<Dev, dev_kind>*>(dev_abs);
+
+#if KSERVER_HAS_THREADS
+    // The policy is a compile-time constant:
+    // only one branch remains for each device.
+    switch(static_cast<concurrency_policy_t>(Dev::__concurrency)) {
+      case CONCURRENCY_EXCLUSIVE: {
+        std::lock_guard<RWLock> lock(dev_locks[dev_kind]);
+        return dev->execute(cmd);
+      }
+      case CONCURRENCY_READ_WRITE: {
+        if(cmd.operation < ops_num
+           && (static_cast<unsigned int>(Dev::__shared_ops) 
+               & SHARED_OP(cmd.operation))) {
+            SharedLockGuard lock(dev_locks[dev_kind]);
+            return dev->execute(cmd);
+        }
+
+        std::lock_guard<RWLock> lock(dev_locks[dev_kind]);
+        return dev->execute(cmd);
+      }
+      case CONCURRENCY_LOCK_FREE:
+      case concurrency_policies_num:
+      default:
+        break;
+    }
+#endif
+
+    return dev->execute(cmd);
+}
+
 // X Macro: Execute device
 #define EXPAND_AS_EXECUTE_DEVICE(num, name, operations ...)         \
-        case num: {                                                 \
-            KDevice<name, num>                                      \
-                *dev = static_cast<KDevice<name, num> *>(dev_abs);  \
-            error = dev->execute(cmd);                              \
-            break;                                                  \
-        }
+        case num:                                                   \
+            return __execute<name, num, __ops_num(operations)>(dev_abs, cmd);
 
 int DeviceManager::Execute(const Command& cmd)
-{ 
-    if(StartDev(cmd.device) < 0) {
+{
+    assert(cmd.device < device_num);
+
+    // Lock-free once the device is started
+    if(!is_started[cmd.device].load(std::memory_order_acquire)
+       && StartDev(cmd.device) < 0) {
         return -1;
     }
 
@@ -119,21 +198,14 @@ int DeviceManager::Execute(const Command& cmd)
         return 0;
     }
 
-    assert(cmd.device < device_num);
     KDeviceAbstract *dev_abs = device_list[cmd.device];
 
-    int error = 0;
-
     switch (dev_abs->kind) {
       case NO_DEVICE:
         return 0;
-        break;
-      case KSERVER: {
-        KDevice<KServer, KSERVER>
-           *dev = static_cast<KDevice<KServer, KSERVER> *>(dev_abs);
-        error = dev->execute(cmd);
-        break;
-      }
+      case KSERVER:
+        return __execute<KServer, KSERVER, KServer::kserver_op_num>(dev_abs, 
+                                                                 cmd);
 	    
       DEVICES_TABLE(EXPAND_AS_EXECUTE_DEVICE) // X-Macro
 	
@@ -142,8 +214,6 @@ int DeviceManager::Execute(const Command& cmd)
         kserver->syslog.print(SysLog::CRITICAL, "Execute: Unknown device\n");
         return -1;
     }
-
-    return error; 
 }
 
 bool DeviceManager::IsStarted(device_t dev) const
@@ -155,7 +225,7 @@ bool DeviceManager::IsStarted(device_t dev) const
 void DeviceManager::SetDevStarted(device_t dev) 
 {
     assert(dev < device_num);
-    is_started[(unsigned int) (dev)] = 1; 
+    is_started[(unsigned int) (dev)].store(true); 
 }
 
 bool DeviceManager::IsFailed(device_t dev)
@@ -176,7 +246,7 @@ bool DeviceManager::IsFailed(device_t dev)
         case num: {                                            \
             if(is_started[num]) {                              \
                 delete static_cast< name *>(device_list[num]); \
-                is_started[num] = 0;                           \
+                is_started[num].store(false);                  \
             }                                                  \
             break;                                             \
         }
@@ -187,6 +257,11 @@ void DeviceManager::StopDev(device_t dev)
     std::lock_guard<std::mutex> lock(mutex);
 #endif
 
+    __stop_dev(dev);
+}
+
+void DeviceManager::__stop_dev(device_t dev)
+{
     assert(dev < device_num);
     
     // A direct call to delete as:
@@ -213,7 +288,7 @@ void DeviceManager::Reset(void)
 
     // KServer is never reseted
     for(unsigned int i=2; i<device_num; i++) {
-        StopDev((device_t)i);
+        __stop_dev((device_t)i);
     }
 }
 
@@ -228,7 +303,7 @@ int DeviceManager::StartAll(void)
     // Maybe not the most efficient implementation
     // But not a speed critical function
     for(unsigned int i=0; i<device_num; i++) {
-        if(StartDev((device_t)i) < 0) {
+        if(__start_dev((device_t)i) < 0) {
             ret = -1;
         }
     }
@@ -11,10 +11,11 @@
 #define __DEVICES_MANAGER_HPP__
 
 #include <array>
-#include <bitset>
+#include <atomic>
 #include <assert.h>
 
 #include "kdevice.hpp"
+#include "devices_concurrency.hpp"
 
 // XXX This must be at the end else compile error:
 // error: ‘mutex’ in namespace ‘std’ does not name a type
@@ -47,6 +48,10 @@ class KServer;
 struct Command;
 
 /// @brief Manage the KServer devices
+///
+/// The devices are started on their first use. Commands are executed
+/// under the concurrency policy declared by each device (kdevice.hpp),
+/// the manager mutex is only taken to start or stop a device.
 class DeviceManager
 {
   public:
@@ -86,6 +91,9 @@ class DeviceManager
     
     Klib::DevMem& GetDevMem() {return dev_mem;}
 
+    /// @brief Release the resources held by a closed session
+    void ReleaseSession(SessID sess_id);
+
   private:
     std::vector<KDeviceAbstract*> device_list;
     KServer *kserver;
@@ -93,11 +101,20 @@ class DeviceManager
     Klib::DevMem dev_mem;
 
     /// True if a device is started
-    std::bitset<device_num> is_started;
+    std::array<std::atomic<bool>, device_num> is_started;
     
 #if KSERVER_HAS_THREADS
     std::mutex mutex;
+
+    /// Locks of the EXCLUSIVE and READ_WRITE devices
+    std::array<RWLock, device_num> dev_locks;
 #endif
+
+    int __start_dev(device_t dev);
+    void __stop_dev(device_t dev);
+
+    template<class Dev, device_t dev_kind, unsigned int ops_num>
+    int __execute(KDeviceAbstract *dev_abs, const Command& cmd);
 };
 
 } // namespace kserver
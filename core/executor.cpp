@@ -0,0 +1,68 @@
+/// @file executor.cpp
+///
+/// @brief Implementation of executor.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "executor.hpp"
+
+#if KSERVER_HAS_THREADS
+
+namespace kserver {
+
+Executor::Executor(unsigned int threads_num)
+: stop(false)
+{
+    for(unsigned int i=0; i<threads_num; i++)
+        threads.push_back(std::thread(&Executor::__loop, this));
+}
+
+Executor::~Executor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+
+    cond.notify_all();
+
+    for(auto& thread : threads)
+        thread.join();
+}
+
+void Executor::post(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+
+    cond.notify_one();
+}
+
+void Executor::__loop()
+{
+    while(1) {
+        std::function<void()> job;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [this] {return stop || !jobs.empty();});
+
+            // Pending jobs are executed before stopping
+            if(jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+} // namespace kserver
+
+#endif // KSERVER_HAS_THREADS
@@ -0,0 +1,52 @@
+/// @file executor.hpp
+///
+/// @brief Fixed pool of threads executing jobs
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __EXECUTOR_HPP__
+#define __EXECUTOR_HPP__
+
+#include "kserver_defs.hpp"
+
+#if KSERVER_HAS_THREADS
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace kserver {
+
+/// @brief Execute jobs on a fixed number of threads
+///
+/// The jobs are executed in their order of submission,
+/// but complete in any order.
+class Executor
+{
+  public:
+    Executor(unsigned int threads_num);
+    ~Executor();
+
+    /// @brief Queue a job for execution
+    void post(std::function<void()> job);
+
+  private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque< std::function<void()> > jobs;
+    bool stop;
+    std::vector<std::thread> threads;
+
+    void __loop();
+};
+
+} // namespace kserver
+
+#endif // KSERVER_HAS_THREADS
+
+#endif // __EXECUTOR_HPP__
@@ -11,6 +11,7 @@
 #define __KDEVICE_HPP__
 
 #include <cstring> 
+#include <tuple>
 
 #include "kserver_defs.hpp"
 #include "dev_definitions.hpp"
@@ -32,6 +33,40 @@ DEVICES_TABLE(EXPAND_AS_CLASS_LIST) // X-macro
 
 class SessionManager;
 
+// ---------------------------------------------
+// Concurrency policies
+// ---------------------------------------------
+
+/// @brief Concurrency policy of a device
+///
+/// Each device declares its policy at compile-time:
+///     enum { __concurrency = CONCURRENCY_READ_WRITE };
+/// The DeviceManager enforces it around the execution of the operations,
+/// so that sessions using different devices, or operations which can
+/// share a device, run in parallel.
+///
+/// There is no policy of locks per memory map: the memory map of an
+/// operation is only known once its arguments are parsed by the device.
+/// A READ_WRITE device locks its memory maps itself in the shared
+/// operations (see KS_Dev_mem::mmap_mutex and doc/concurrency.md).
+typedef enum {
+    CONCURRENCY_EXCLUSIVE,  ///< One operation at a time (default)
+    CONCURRENCY_READ_WRITE, ///< The operations of __shared_ops run in parallel,
+                            ///< the other operations are exclusive
+    CONCURRENCY_LOCK_FREE,  ///< No lock taken, the device synchronizes itself
+    concurrency_policies_num
+} concurrency_policy_t;
+
+/// Number of operations of a device which __shared_ops can hold
+#define SHARED_OPS_MAX 32
+
+/// Mask of an operation in __shared_ops
+#define SHARED_OP(op) (1U << (op))
+
+/// Number of operations in a list of the devices table
+template<typename... Ops>
+constexpr unsigned int __ops_num(Ops...) {return sizeof...(Ops);}
+
 /// @brief Abstract class for KDevice
 class KDeviceAbstract {
 public:
@@ -65,6 +100,13 @@ class KDevice : public KDeviceAbstract
     /// Contains the arguments of the operation op
     template <int op> struct Argument;
 
+    /// Default concurrency policy.
+    /// Redeclare these in the device class to override.
+    enum {
+        __concurrency = CONCURRENCY_EXCLUSIVE,
+        __shared_ops = 0 ///< Mask of the operations sharing the device
+    };
+
 	KDevice(KServer *kserver_)
 	: KDeviceAbstract(dev_kind),
 	  kserver(kserver_)
@@ -80,17 +122,14 @@ class KDevice : public KDeviceAbstract
     /// Each device knows the KServer class,
     /// which itself knows every body else
     KServer* kserver;
-    
-    // TODO We should add this here for parsing instead of
-    // initializing the array in each parsing function.
-    // But got warning that args 'may be used uninitialized in this function'.
-    // --> Need to investigate ...
-    //char tmp_str[2*KSERVER_READ_STR_LEN];
 
   protected:
     /// @brief Parse the buffer of a command
     /// @cmd The Command to be parsed
     /// @args The arguments resulting of the parsing
+    ///
+    /// The default implementation (args_parser.hpp) fills the
+    /// fields declared by ARGUMENT_FIELDS in Argument<op>.
     template<int op>
     int parse_arg(const Command& cmd, Argument<op>& args);
 
@@ -104,6 +143,24 @@ friend class DeviceManager;
 friend Dev;
 };
 
+/// Declare the fields of an Argument structure
+///
+/// The fields must be listed in the order 
+/// they are sent by the client:
+/// DEVICE|OPERATION|field1|field2|...|fieldN|\n
+#define ARGUMENT_FIELDS(...)                                \
+    auto fields() -> decltype(std::tie(__VA_ARGS__))        \
+    {                                                       \
+        return std::tie(__VA_ARGS__);                       \
+    }
+
+/// For an operation without arguments
+#define NO_ARGUMENT_FIELDS                                  \
+    std::tuple<> fields()                                   \
+    {                                                       \
+        return std::tuple<>();                              \
+    }
+
 /// Macros to simplify edition of operations 
 #define VERBOSE kserver->session_manager.GetSession(sess_id).GetParams().Verbose()
 #define SEND kserver->session_manager.GetSession(sess_id).Send
@@ -126,6 +183,10 @@ public:
         OP1,
         ops_num	
     };
+
+    // OP1 can run in parallel
+    enum { __concurrency = CONCURRENCY_READ_WRITE };
+    enum { __shared_ops = SHARED_OP(OP1) };
 };
 
 template<>
@@ -144,13 +205,9 @@ struct KDevice<MyDev>::Argument<MyDev::OP1>
 {
     int N;
     uint32_t data;
-};
 
-template<>
-template<>
-int KDevice<MyDev>::parse_arg<MyDev::OP1>(const Command& cmd, KDevice<MyDev>::Argument<MyDev::OP1>& args) {
-
-}
+    ARGUMENT_FIELDS(N, data)
+};
 
 template<>
 template<>
@@ -11,6 +11,9 @@
 
 #include <chrono>
 
+#include <signal/kparallel.hpp>
+#include <signal/kallocator.hpp>
+
 #include "commands.hpp"
 #include "kserver_session.hpp"
 
@@ -32,11 +35,24 @@ KServer::KServer(KServerConfig *config_)
   dev_manager(this),
   session_manager(*this, dev_manager, SessionManager::DFLT_WRITE_PERM_POLICY),
   syslog(config_),
-  start_time(0)
+  start_time(0),
+  stats()
+#if KSERVER_HAS_THREADS
+, executor(KSERVER_ASYNC_WORKERS)
+#endif
 {
     if(sig_handler.Init(this))
         exit(EXIT_FAILURE);
 
+    // Before the devices, which can compute on large vectors
+    Klib::KSetParallel(config->signal_threads,
+                       config->signal_parallel_threshold);
+    syslog.print(SysLog::INFO, "Signal processing on %u threads above %llu "
+                 "elements\n", Klib::KParallelThreads(),
+                 (unsigned long long)Klib::KParallelThreshold());
+
+    Klib::KBlockPool::SetMaxCachedBytes(config->signal_pool_cache_bytes);
+
     if(dev_manager.Init() < 0)
         exit (EXIT_FAILURE);
     
@@ -26,6 +26,8 @@
 #include "session_manager.hpp"
 #include "devices_manager.hpp"
 #include "kserver_syslog.hpp"
+#include "kserver_stats.hpp"
+#include "executor.hpp"
 #include "signal_handler.hpp"
 
 namespace kserver {
@@ -63,14 +65,6 @@ listen_channel_desc = {{
 ////////////////////////////////////////////////////////////////////////////
 /////// ListeningChannel
 
-template<int sock_type>
-struct ListenerStats
-{
-    int opened_sessions_num = 0; ///< Number of currently opened sessions
-    int total_sessions_num = 0;  ///< Total number of sessions
-    int total_requests_num = 0;  ///< Total number of requests
-};
-
 /// Implementation in listening_channel.cpp
 template<int sock_type>
 class ListeningChannel
@@ -111,7 +105,6 @@ class ListeningChannel
 #endif
 
     KServer *kserver;
-    ListenerStats<sock_type> stats;
         
   private:  
     int __start_worker();
@@ -166,6 +159,7 @@ class KServer : public KDevice<KServer, KSERVER>
         GET_RUNNING_SESSIONS, ///< Send the running sessions
         KILL_SESSION,         ///< Kill a session (UNSTABLE)
         GET_SESSION_PERFS,    ///< Send the perfs of a session
+        GET_OPS_PERFS,        ///< Send the latencies of the operations
         kserver_op_num
     };
     
@@ -192,9 +186,11 @@ class KServer : public KDevice<KServer, KSERVER>
     // Logs
     SysLog syslog;
     std::time_t start_time;
-    
+    ServerStats<sock_type_num> stats;
+
 #if KSERVER_HAS_THREADS
-    std::mutex ks_mutex;
+    /// Executes the asynchronous requests
+    Executor executor;
 #endif
     
   private:
@@ -10,9 +10,11 @@
 #include "kserver.hpp"
 
 #include <ctime>
+#include <memory>
 
 #include "commands.hpp"
 #include "kserver_session.hpp"
+#include "args_parser.hpp"
 
 namespace kserver {
 
@@ -26,14 +28,6 @@ namespace kserver {
   template<>                                                        \
   struct KDevice<KServer, KSERVER>::Argument<KServer::cmd_name>
   
-#define KSERVER_PARSE_ARG(cmd_name)                                 \
-  template<>                                                        \
-  template<>                                                        \
-  int KDevice<KServer, KSERVER>::                                   \
-          parse_arg<KServer::cmd_name>(const Command& cmd,          \
-                        KDevice<KServer, KSERVER>::                 \
-                            Argument<KServer::cmd_name>& args)      
-
 #define KSERVER_EXECUTE_OP(cmd_name)                                \
   template<>                                                        \
   template<>                                                        \
@@ -47,14 +41,9 @@ namespace kserver {
 
 KSERVER_STRUCT_ARGUMENTS(GET_ID)
 {
-    // No arguments
+    NO_ARGUMENT_FIELDS
 };
 
-KSERVER_PARSE_ARG(GET_ID)
-{
-    return 0;
-}
-
 KSERVER_EXECUTE_OP(GET_ID)
 {
     // TODO
@@ -67,14 +56,9 @@ KSERVER_EXECUTE_OP(GET_ID)
 
 KSERVER_STRUCT_ARGUMENTS(GET_CMDS)
 {
-    // No arguments
+    NO_ARGUMENT_FIELDS
 };
 
-KSERVER_PARSE_ARG(GET_CMDS)
-{
-    return 0;
-}
-
 KSERVER_EXECUTE_OP(GET_CMDS)
 {
     char cmds_str[KS_DEV_WRITE_STR_LEN];
@@ -152,28 +136,61 @@ KSERVER_EXECUTE_OP(GET_CMDS)
 
 KSERVER_STRUCT_ARGUMENTS(GET_STATS)
 {
-    // No arguments
+    NO_ARGUMENT_FIELDS
 };
 
-KSERVER_PARSE_ARG(GET_STATS)
-{
-    return 0;
-}
-
 template<int sock_type>
-int __send_listener_stats(SessID sess_id, KServer *kserver, 
-                          ListeningChannel<sock_type> *listener)
+int __send_listener_stats(SessID sess_id, KServer *kserver)
 {
     char send_str[KS_DEV_WRITE_STR_LEN];
-    unsigned int bytes_send = 0;
+    int bytes_send = 0;
+    StatsCounters stats = kserver->stats.get_listener(sock_type);
 
     // sock_type:opened_sessions_num:total_sessions_num:total_requests_num
+    //          :errors_num:bytes_in:bytes_out
     int ret = snprintf(send_str, KS_DEV_WRITE_STR_LEN,
-                    "%s:%d:%d:%d\n", 
+                    "%s:%llu:%llu:%llu:%llu:%llu:%llu\n", 
                     listen_channel_desc[sock_type].c_str(), 
-                    listener->stats.opened_sessions_num,
-                    listener->stats.total_sessions_num,
-                    listener->stats.total_requests_num);
+                    (unsigned long long)kserver->stats
+                                            .get_sessions(sock_type),
+                    (unsigned long long)stats[CONNECTIONS],
+                    (unsigned long long)stats[REQUESTS],
+                    (unsigned long long)stats[ERRORS],
+                    (unsigned long long)stats[BYTES_IN],
+                    (unsigned long long)stats[BYTES_OUT]);
+
+    if(ret < 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "KServer::GET_STATS Format error\n");
+        return -1;
+    }
+
+    if(ret >= KS_DEV_WRITE_STR_LEN) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "KServer::GET_STATS Buffer overflow\n");
+        return -1;
+    }
+
+    if((bytes_send = GET_SESSION.SendCstr(send_str)) < 0)
+        return -1;
+    
+    return bytes_send;  
+}
+
+int __send_device_stats(SessID sess_id, KServer *kserver, device_t dev)
+{
+    char send_str[KS_DEV_WRITE_STR_LEN];
+    int bytes_send = 0;
+    StatsCounters stats = kserver->stats.get_device(dev);
+
+    // dev#:dev_name:requests_num:errors_num:bytes_in:bytes_out
+    int ret = snprintf(send_str, KS_DEV_WRITE_STR_LEN,
+                    "%u:%s:%llu:%llu:%llu:%llu\n", 
+                    dev, device_desc[dev][0].c_str(), 
+                    (unsigned long long)stats[REQUESTS],
+                    (unsigned long long)stats[ERRORS],
+                    (unsigned long long)stats[BYTES_IN],
+                    (unsigned long long)stats[BYTES_OUT]);
 
     if(ret < 0) {
         kserver->syslog.print(SysLog::ERROR, 
@@ -196,7 +213,7 @@ int __send_listener_stats(SessID sess_id, KServer *kserver,
 KSERVER_EXECUTE_OP(GET_STATS)
 {
     char send_str[KS_DEV_WRITE_STR_LEN];
-    unsigned int bytes = 0;
+    int bytes = 0;
     unsigned int bytes_send = 0;
 
     // Send start time
@@ -222,30 +239,38 @@ KSERVER_EXECUTE_OP(GET_STATS)
     bytes_send += bytes;
     
 #if KSERVER_HAS_TCP
-    if((bytes = __send_listener_stats<TCP>(sess_id, kserver, 
-                    &(kserver->tcp_listener))) < 0) {
+    if((bytes = __send_listener_stats<TCP>(sess_id, kserver)) < 0) {
         return -1;
     }
     
     bytes_send += bytes;
 #endif
 #if KSERVER_HAS_WEBSOCKET
-    if((bytes = __send_listener_stats<WEBSOCK>(sess_id, kserver, 
-                    &(kserver->websock_listener))) < 0) {
+    if((bytes = __send_listener_stats<WEBSOCK>(sess_id, kserver)) < 0) {
         return -1;
     }
     
     bytes_send += bytes;
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
-    if((bytes = __send_listener_stats<UNIX>(sess_id, kserver, 
-                    &(kserver->unix_listener))) < 0) {
+    if((bytes = __send_listener_stats<UNIX>(sess_id, kserver)) < 0) {
         return -1;
     }
     
     bytes_send += bytes;
 #endif
 
+    // Devices stats (NO_DEVICE collects the traffic
+    // not related to a device execution)
+    for(unsigned int i=0; i<device_num; i++) {
+        if((bytes = __send_device_stats(sess_id, kserver, 
+                                        static_cast<device_t>(i))) < 0) {
+            return -1;
+        }
+        
+        bytes_send += bytes;
+    }
+
     // Send EORS (End Of KServer Stats)
     if((bytes = GET_SESSION.SendCstr("EOKS\n")) < 0) {
         return -1;
@@ -262,14 +287,9 @@ KSERVER_EXECUTE_OP(GET_STATS)
 
 KSERVER_STRUCT_ARGUMENTS(GET_DEV_STATUS)
 {
-    // No arguments
+    NO_ARGUMENT_FIELDS
 };
 
-KSERVER_PARSE_ARG(GET_DEV_STATUS)
-{
-    return 0;
-}
-
 KSERVER_EXECUTE_OP(GET_DEV_STATUS)
 {
     char send_str[KS_DEV_WRITE_STR_LEN];
@@ -320,14 +340,9 @@ KSERVER_EXECUTE_OP(GET_DEV_STATUS)
 
 KSERVER_STRUCT_ARGUMENTS(GET_RUNNING_SESSIONS)
 {
-    // No arguments
+    NO_ARGUMENT_FIELDS
 };
 
-KSERVER_PARSE_ARG(GET_RUNNING_SESSIONS)
-{
-    return 0;
-}
-
 KSERVER_EXECUTE_OP(GET_RUNNING_SESSIONS)
 {
     char send_str[KS_DEV_WRITE_STR_LEN];
@@ -431,43 +446,9 @@ KSERVER_EXECUTE_OP(GET_RUNNING_SESSIONS)
 KSERVER_STRUCT_ARGUMENTS(KILL_SESSION)
 {
     SessID sid; ///< ID of the session to kill
-};
-
-KSERVER_PARSE_ARG(KILL_SESSION)
-{
-    char tmp_str[2*KSERVER_READ_STR_LEN];
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
-
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            if(param_num == 0)
-                args.sid = static_cast<SessID>(CSTRING_TO_UINT(tmp_str));
-
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
-    }
-
-    if(param_num != 1) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
-        return -1;
-    }
-
-    return 0;
-}
+    ARGUMENT_FIELDS(sid)
+};
 
 KSERVER_EXECUTE_OP(KILL_SESSION)
 {
@@ -496,43 +477,9 @@ KSERVER_EXECUTE_OP(KILL_SESSION)
 KSERVER_STRUCT_ARGUMENTS(GET_SESSION_PERFS)
 {
     SessID sid; ///< ID of the session who perfs are wanted
-};
-
-KSERVER_PARSE_ARG(GET_SESSION_PERFS)
-{
-    char tmp_str[2*KSERVER_READ_STR_LEN];
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
-
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            if(param_num == 0)
-                args.sid = static_cast<SessID>(CSTRING_TO_UINT(tmp_str));
-
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
-    }
-
-    if(param_num != 1) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
-        return -1;
-    }
-
-    return 0;
-}
+    ARGUMENT_FIELDS(sid)
+};
 
 KSERVER_EXECUTE_OP(GET_SESSION_PERFS)
 {
@@ -593,6 +540,84 @@ KSERVER_EXECUTE_OP(GET_SESSION_PERFS)
     return -1;
 }
 
+/////////////////////////////////////
+// GET_OPS_PERFS
+// Send the latencies of the operations
+
+KSERVER_STRUCT_ARGUMENTS(GET_OPS_PERFS)
+{
+    SessID sid; ///< ID of the session, -1 for the whole server
+
+    ARGUMENT_FIELDS(sid)
+};
+
+KSERVER_EXECUTE_OP(GET_OPS_PERFS)
+{
+    char send_str[KS_DEV_WRITE_STR_LEN];
+    int bytes = 0;
+    unsigned int bytes_send = 0;
+    // Too large for the stack of the session
+    std::unique_ptr<OpsLatencies> ops_latencies(new OpsLatencies);
+
+    if(args.sid == -1) {
+        kserver->session_manager.GetOpsLatencies(*ops_latencies);
+    }
+    else if(kserver->session_manager.GetOpsLatencies(args.sid, 
+                                                     *ops_latencies) < 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                        "KServer::GET_OPS_PERFS Invalid ID: %i\n", args.sid);
+        return -1;
+    }
+
+    // Send the executed operations (durations in ns):
+    // dev_name:op_name:count:mean:p50:p90:p99:max
+    for(unsigned int i=KSERVER; i<device_num; i++) {
+        for(unsigned int j=0; j<MAX_OP_NUM; j++) {
+            const LatencyHistogram& hist 
+                = ops_latencies->get(static_cast<device_t>(i), j);
+
+            if(hist.get_count() == 0)
+                continue;
+
+            int ret = snprintf(send_str, KS_DEV_WRITE_STR_LEN,
+                            "%s:%s:%llu:%f:%llu:%llu:%llu:%llu\n",
+                            device_desc[i][0].c_str(),
+                            device_desc[i][j+1].c_str(),
+                            (unsigned long long)hist.get_count(),
+                            hist.get_mean(),
+                            (unsigned long long)hist.get_percentile(50),
+                            (unsigned long long)hist.get_percentile(90),
+                            (unsigned long long)hist.get_percentile(99),
+                            (unsigned long long)hist.get_max());
+
+            if(ret < 0) {
+                kserver->syslog.print(SysLog::ERROR, 
+                                "KServer::GET_OPS_PERFS Format error\n");
+                return -1;
+            }
+
+            if(ret >= KS_DEV_WRITE_STR_LEN) {
+                kserver->syslog.print(SysLog::ERROR, 
+                                "KServer::GET_OPS_PERFS Buffer overflow\n");
+                return -1;
+            }
+
+            if((bytes = GET_SESSION.SendCstr(send_str)) < 0)
+                return -1;
+
+            bytes_send += bytes;
+        }
+    }
+
+    // Send EOOP (End Of Operations Perfs)
+    if((bytes = GET_SESSION.SendCstr("EOOP\n")) < 0) {
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", bytes_send+bytes);
+    return 0;
+}
+
 ////////////////////////////////////////////////
 
 #define KSERVER_EXECUTE_CMD(cmd_name)                               \
@@ -610,10 +635,8 @@ KSERVER_EXECUTE_OP(GET_SESSION_PERFS)
 template<>
 int KDevice<KServer, KSERVER>::execute(const Command& cmd)
 {   
-#if KSERVER_HAS_THREADS
-    std::lock_guard<std::mutex> lock(static_cast<KServer*>(this)->ks_mutex);
-#endif
-
+    // Operations are serialized by the DeviceManager:
+    // KServer has the default CONCURRENCY_EXCLUSIVE policy.
     int err;
     
     switch(cmd.operation) {
@@ -631,6 +654,8 @@ int KDevice<KServer, KSERVER>::execute(const Command& cmd)
         KSERVER_EXECUTE_CMD(KILL_SESSION)
       case KServer::GET_SESSION_PERFS:
         KSERVER_EXECUTE_CMD(GET_SESSION_PERFS)
+      case KServer::GET_OPS_PERFS:
+        KSERVER_EXECUTE_CMD(GET_OPS_PERFS)
       case KServer::kserver_op_num:
       default:
         kserver->syslog.print(SysLog::ERROR,
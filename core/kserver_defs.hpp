@@ -68,6 +68,13 @@ namespace kserver {
 /// and Websockets connections are required.
 #define KSERVER_HAS_THREADS 1
 
+/// Number of threads executing the asynchronous requests
+#define KSERVER_ASYNC_WORKERS 4
+
+/// Maximum number of asynchronous requests in flight per session.
+/// Above, the session stops reading until a request completes.
+#define KSERVER_ASYNC_MAX_PENDING 64
+
 // ------------------------------------------
 // Logs
 // ------------------------------------------
@@ -98,6 +105,27 @@ namespace kserver {
 #define DFLT_ADDR_LIMIT_DOWN 0x0
 #define DFLT_ADDR_LIMIT_UP   0x0
 
+/// Backend of the physical memory (devmem, uio, file, memfd or none)
+#if KSERVER_HAS_DEVMEM
+# define DFLT_MEM_BACKEND "devmem"
+#else
+# define DFLT_MEM_BACKEND "none"
+#endif
+
+/// Simulated physical address space (file and memfd backends)
+#define DFLT_MEM_SIM_BASE 0x40000000
+#define DFLT_MEM_SIM_SIZE 0x20000000
+
+/// Threads of the signal processing of large vectors (0 for all the cores)
+#define DFLT_SIGNAL_THREADS 0
+/// Size of the vectors above which their operations run in parallel
+#define DFLT_SIGNAL_PARALLEL_THRESHOLD 1048576
+/// Bytes of vector buffers kept for reuse by each thread
+#define DFLT_SIGNAL_POOL_CACHE_BYTES 1048576
+
+/// Memory backend path length
+#define MEM_BACKEND_PATH_LEN 256
+
 // ------------------------------------------
 // Buffer sizes
 // ------------------------------------------
@@ -117,6 +145,12 @@ namespace kserver {
 /// Number of char for the operation identification
 #define N_CHAR_OP 16
 
+/// Number of char for the request ID of an asynchronous command
+#define N_CHAR_REQ_ID 16
+
+/// Number of char for the encoding of the array replies
+#define N_CHAR_ENCODING 4
+
 /// Maximum length of the Unix socket file path 
 ///
 /// Note:
@@ -0,0 +1,212 @@
+/// @file kserver_metrics.cpp
+///
+/// @brief Implementation of kserver_metrics.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "kserver_metrics.hpp"
+
+#include <ctime>
+#include <sstream>
+#include <memory>
+
+#include "kserver.hpp"
+#include "kserver_session.hpp"
+
+namespace kserver {
+
+static void __write_header(std::ostringstream& oss, const char *name,
+                           const char *type, const char *help)
+{
+    oss << "# HELP kserver_" << name << " " << help << "\n";
+    oss << "# TYPE kserver_" << name << " " << type << "\n";
+}
+
+// ---------------------------------------------
+// Listeners
+// ---------------------------------------------
+
+static const struct {
+    stats_counter_t counter;
+    const char *name;
+    const char *help;
+} counters_metrics[] = {
+    {CONNECTIONS,    "connections_total",    "Opened sessions"},
+    {DISCONNECTIONS, "disconnections_total", "Closed sessions"},
+    {REQUESTS,       "requests_total",       "Executed requests"},
+    {ERRORS,         "errors_total",         "Requests terminated with error"},
+    {BYTES_IN,       "bytes_in_total",       "Bytes received"},
+    {BYTES_OUT,      "bytes_out_total",      "Bytes sent"}
+};
+
+static void __write_listeners(std::ostringstream& oss, KServer *kserver)
+{
+    std::array<StatsCounters, sock_type_num> stats;
+
+    for(int i=NONE+1; i<sock_type_num; i++)
+        stats[i] = kserver->stats.get_listener(i);
+
+    for(auto& metric : counters_metrics) {
+        std::string name = std::string("listener_") + metric.name;
+        __write_header(oss, name.c_str(), "counter", metric.help);
+
+        for(int i=NONE+1; i<sock_type_num; i++)
+            oss << "kserver_" << name
+                << "{listener=\"" << listen_channel_desc[i] << "\"} "
+                << stats[i][metric.counter] << "\n";
+    }
+
+    __write_header(oss, "listener_sessions", "gauge", "Running sessions");
+
+    for(int i=NONE+1; i<sock_type_num; i++)
+        oss << "kserver_listener_sessions"
+            << "{listener=\"" << listen_channel_desc[i] << "\"} "
+            << kserver->stats.get_sessions(i) << "\n";
+}
+
+// ---------------------------------------------
+// Devices
+// ---------------------------------------------
+
+static void __write_devices(std::ostringstream& oss, KServer *kserver)
+{
+    std::array<StatsCounters, device_num> stats;
+
+    for(unsigned int i=0; i<device_num; i++)
+        stats[i] = kserver->stats.get_device(static_cast<device_t>(i));
+
+    for(auto& metric : counters_metrics) {
+        // Connections are never attributed to a device
+        if(metric.counter == CONNECTIONS || metric.counter == DISCONNECTIONS)
+            continue;
+
+        std::string name = std::string("device_") + metric.name;
+        __write_header(oss, name.c_str(), "counter", metric.help);
+
+        for(unsigned int i=0; i<device_num; i++)
+            oss << "kserver_" << name
+                << "{device=\"" << device_desc[i][0] << "\"} "
+                << stats[i][metric.counter] << "\n";
+    }
+
+    __write_header(oss, "device_status", "gauge",
+                   "Device status (1 for the current status)");
+
+    for(unsigned int i=KSERVER; i<device_num; i++) {
+        KS_device_status status
+            = kserver->dev_manager.GetStatus(static_cast<device_t>(i));
+
+        for(unsigned int j=0; j<KS_device_status_num; j++)
+            oss << "kserver_device_status"
+                << "{device=\"" << device_desc[i][0] << "\","
+                << "status=\"" << KS_dev_status_desc[j] << "\"} "
+                << (j == status ? 1 : 0) << "\n";
+    }
+}
+
+// ---------------------------------------------
+// Sessions
+// ---------------------------------------------
+
+static void __write_sessions(std::ostringstream& oss, KServer *kserver)
+{
+    std::ostringstream requests, errors, uptimes;
+    std::time_t now = std::time(nullptr);
+
+    kserver->session_manager.ForEachSession([&](const Session& session) {
+        std::ostringstream labels;
+        labels << "{sid=\"" << session.GetID() << "\","
+               << "listener=\""
+               << listen_channel_desc[session.GetSockType()] << "\"} ";
+
+        requests << "kserver_session_requests_total" << labels.str()
+                 << session.RequestNum() << "\n";
+        errors << "kserver_session_errors_total" << labels.str()
+               << session.ErrorNum() << "\n";
+        uptimes << "kserver_session_uptime_seconds" << labels.str()
+                << now - session.GetStartTime() << "\n";
+    });
+
+    __write_header(oss, "session_requests_total", "counter",
+                   "Requests received by the session");
+    oss << requests.str();
+    __write_header(oss, "session_errors_total", "counter",
+                   "Requests of the session terminated with error");
+    oss << errors.str();
+    __write_header(oss, "session_uptime_seconds", "gauge",
+                   "Duration of the session");
+    oss << uptimes.str();
+}
+
+// ---------------------------------------------
+// Operations latencies
+// ---------------------------------------------
+
+#if KSERVER_HAS_PERF
+static void __write_latencies(std::ostringstream& oss, KServer *kserver)
+{
+    static const float quantiles[] = {0.5, 0.9, 0.99};
+
+    // Too large for the stack of the session
+    std::unique_ptr<OpsLatencies> ops_latencies(new OpsLatencies);
+    kserver->session_manager.GetOpsLatencies(*ops_latencies);
+    std::ostringstream max;
+
+    __write_header(oss, "op_latency_seconds", "summary",
+                   "Execution duration of the operations");
+
+    for(unsigned int i=KSERVER; i<device_num; i++) {
+        for(unsigned int j=0; j<MAX_OP_NUM; j++) {
+            const LatencyHistogram& hist
+                = ops_latencies->get(static_cast<device_t>(i), j);
+
+            if(hist.get_count() == 0)
+                continue;
+
+            std::ostringstream labels;
+            labels << "device=\"" << device_desc[i][0] << "\","
+                   << "operation=\"" << device_desc[i][j+1] << "\"";
+
+            for(float q : quantiles)
+                oss << "kserver_op_latency_seconds{" << labels.str()
+                    << ",quantile=\"" << q << "\"} "
+                    << hist.get_percentile(100 * q) * 1E-9 << "\n";
+
+            oss << "kserver_op_latency_seconds_sum{" << labels.str() << "} "
+                << hist.get_sum() * 1E-9 << "\n";
+            oss << "kserver_op_latency_seconds_count{" << labels.str() << "} "
+                << hist.get_count() << "\n";
+
+            max << "kserver_op_latency_max_seconds{" << labels.str() << "} "
+                << hist.get_max() * 1E-9 << "\n";
+        }
+    }
+
+    __write_header(oss, "op_latency_max_seconds", "gauge",
+                   "Maximum execution duration of the operations");
+    oss << max.str();
+}
+#endif
+
+std::string get_metrics(KServer *kserver)
+{
+    std::ostringstream oss;
+
+    __write_header(oss, "uptime_seconds", "gauge", "Server uptime");
+    oss << "kserver_uptime_seconds "
+        << std::time(nullptr) - kserver->start_time << "\n";
+
+    __write_listeners(oss, kserver);
+    __write_devices(oss, kserver);
+    __write_sessions(oss, kserver);
+#if KSERVER_HAS_PERF
+    __write_latencies(oss, kserver);
+#endif
+
+    return oss.str();
+}
+
+} // namespace kserver
+
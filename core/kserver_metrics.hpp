@@ -0,0 +1,36 @@
+/// @file kserver_metrics.hpp
+///
+/// @brief Server metrics in the Prometheus text format
+///
+/// Served by the WebSocket listener on a plain HTTP request:
+///    GET /metrics HTTP/1.1
+///
+/// See https://prometheus.io/docs/instrumenting/exposition_formats/
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __KSERVER_METRICS_HPP__
+#define __KSERVER_METRICS_HPP__
+
+#include <string>
+
+namespace kserver {
+
+class KServer;
+
+/// HTTP path of the metrics
+#define KSERVER_METRICS_PATH "/metrics"
+
+/// @brief Build the metrics exposition
+///
+/// The statistics and latency counters are relaxed atomics, read
+/// without stopping the requests of the sessions. The sessions and
+/// their latencies are read under the session manager lock.
+std::string get_metrics(KServer *kserver);
+
+} // namespace kserver
+
+#endif // __KSERVER_METRICS_HPP__
+
@@ -14,8 +14,24 @@ namespace kserver {
 
 #if KSERVER_HAS_PERF
   #define PERF_TIC(timing_pt) perf.tic(timing_pt);
+  #define PERF_OP_START       perf.op_start();
+  #define PERF_OP_STOP(cmd)   perf.op_stop(cmd.device, cmd.operation);
+  #define PERF_OP_RECORD(cmd, duration)                                \
+      perf.op_record(cmd.device, cmd.operation, duration);
 #else
   #define PERF_TIC(timing_pt)
+  #define PERF_OP_START
+  #define PERF_OP_STOP(cmd)
+  #define PERF_OP_RECORD(cmd, duration)
+#endif
+
+thread_local device_t Session::exec_device = NO_DEVICE;
+thread_local Klib::kencoding_t Session::reply_encoding = Klib::KENC_NONE;
+thread_local Klib::KEncoder Session::encoder;
+thread_local AsyncReply *Session::async_reply = nullptr;
+
+#if KSERVER_HAS_THREADS
+thread_local std::unique_lock<std::mutex> *Session::send_lock = nullptr;
 #endif
 
 Session::Session(KServerConfig *config_, int comm_fd_,
@@ -35,6 +51,9 @@ Session::Session(KServerConfig *config_, int comm_fd_,
 , perf()
 #endif
 , start_time(0)
+#if KSERVER_HAS_THREADS
+, pending_num(0)
+#endif
 {
     assert(sock_type < sock_type_num);
 
@@ -164,6 +183,61 @@ int Session::parse_input_buffer(void)
             goto exit_loop;
         }
         else if(get_dev_num) {
+            // Get the request ID of an asynchronous command
+            if(buff_str[i] == '#') {
+                unsigned int cnt_id = 1;
+
+                while(buff_str[cnt_id+i] != '|') {
+                    if(buff_str[cnt_id+i] == '\0') {
+                        goto exit_loop;
+                    }
+
+                    if(cnt_id >= N_CHAR_REQ_ID) {
+                        syslog_ptr->print(SysLog::CRITICAL,
+                                          "Buffer req_id overflow\n");
+                        cmd.parsing_err = 1;
+                        break;
+                    }
+
+                    cnt_id++;
+                }
+
+                cmd.async = 1;
+                cmd.req_id = (uint32_t) strtoul(&buff_str[i+1], NULL, 10);
+                i += cnt_id + 1;
+            }
+
+            // Get the encoding of the array replies
+            if(buff_str[i] == '%') {
+                unsigned int cnt_enc = 1;
+
+                while(buff_str[cnt_enc+i] != '|') {
+                    if(buff_str[cnt_enc+i] == '\0') {
+                        goto exit_loop;
+                    }
+
+                    if(cnt_enc >= N_CHAR_ENCODING) {
+                        syslog_ptr->print(SysLog::CRITICAL,
+                                          "Buffer encoding overflow\n");
+                        cmd.parsing_err = 1;
+                        break;
+                    }
+
+                    cnt_enc++;
+                }
+
+                cmd.encoding = (uint32_t) strtoul(&buff_str[i+1], NULL, 10);
+
+                if(cmd.encoding >= Klib::kencodings_num) {
+                    syslog_ptr->print(SysLog::ERROR, 
+                                      "Unknown reply encoding %u\n",
+                                      cmd.encoding);
+                    cmd.parsing_err = 1;
+                }
+
+                i += cnt_enc + 1;
+            }
+
             // Get device number
             unsigned int cnt_dev = 0;
 	        
@@ -242,6 +316,9 @@ int Session::parse_input_buffer(void)
             cmd.sess_id = id;
             cmd.device = NO_DEVICE;
             cmd.buffer = NULL;
+            cmd.async = 0;
+            cmd.req_id = 0;
+            cmd.encoding = 0;
             cmd.parsing_err = 0;
             cmd.status = exec_pending;
 	    
@@ -269,16 +346,54 @@ void Session::execute_cmds()
 //        printf("Command #%u\n",i);
 //        cmd_list[i].print();
 		
+        KServer& kserver = session_manager.kserver;
+        kserver.stats.add(sock_type, cmd_list[i].device, REQUESTS);
+
         if(cmd_list[i].parsing_err == 1) {
             cmd_list[i].status = exec_skip;
             errors_num++;
-        } else {       
+            kserver.stats.add(sock_type, cmd_list[i].device, ERRORS);
+
+            // The client waits for a reply to the request ID
+            if(cmd_list[i].async) {
+                AsyncReply reply;
+                reply.req_id = cmd_list[i].req_id;
+                send_async_reply(reply, -1);
+            }
+        } else if(cmd_list[i].async) {
+            cmd_list[i].status = exec_pending;
+            post_async_cmd(cmd_list[i]);
+        } else {
+#if KSERVER_HAS_THREADS
+            // Replies of asynchronous commands can't be sent in the
+            // middle of the reply of this command. The lock is taken
+            // at its first data sent, not during a long execution.
+            std::unique_lock<std::mutex> lock(send_mutex, std::defer_lock);
+            send_lock = &lock;
+#endif
+
+            exec_device = cmd_list[i].device;
+            reply_encoding = static_cast<Klib::kencoding_t>(cmd_list[i].encoding);
+            PERF_OP_START
+
             int exec_status 
                 = session_manager.dev_manager.Execute(cmd_list[i]);
+
+#if KSERVER_HAS_THREADS
+            send_lock = nullptr;
+
+            if(!lock.owns_lock())
+                lock.lock();
+#endif
+
+            PERF_OP_STOP(cmd_list[i])
+            exec_device = NO_DEVICE;
+            reply_encoding = Klib::KENC_NONE;
             
             if(exec_status < 0) {
                 cmd_list[i].status = exec_err;
                 errors_num++;
+                kserver.stats.add(sock_type, cmd_list[i].device, ERRORS);
             } else {
                 cmd_list[i].status = exec_done;
             }
@@ -286,11 +401,117 @@ void Session::execute_cmds()
     }
 }
 
+void Session::post_async_cmd(const Command& cmd)
+{
+#if KSERVER_HAS_THREADS
+    {
+        std::unique_lock<std::mutex> lock(pending_mutex);
+        pending_cond.wait(lock, [this] {
+            return pending_num < KSERVER_ASYNC_MAX_PENDING;
+        });
+        pending_num++;
+    }
+
+    // The receive buffer is overwritten by the next read:
+    // the job owns a copy of the command arguments.
+    std::string buffer(cmd.buffer);
+    Command async_cmd = cmd;
+
+    session_manager.kserver.executor.post([this, async_cmd, buffer]() 
+                                          mutable {
+        async_cmd.buffer = &buffer[0];
+        execute_async_cmd(async_cmd);
+
+        // Notify under the lock: the session may be
+        // deleted as soon as pending_num reaches zero.
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        pending_num--;
+        pending_cond.notify_all();
+    });
+#else
+    Command async_cmd = cmd;
+    execute_async_cmd(async_cmd);
+#endif
+}
+
+void Session::execute_async_cmd(Command& cmd)
+{
+    AsyncReply reply;
+    reply.req_id = cmd.req_id;
+
+    async_reply = &reply;
+    exec_device = cmd.device;
+    reply_encoding = static_cast<Klib::kencoding_t>(cmd.encoding);
+    auto start = std::chrono::steady_clock::now();
+
+    int exec_status = session_manager.dev_manager.Execute(cmd);
+
+    auto duration = std::chrono::steady_clock::now() - start;
+    async_reply = nullptr;
+    reply_encoding = Klib::KENC_NONE;
+
+    if(exec_status < 0) {
+        errors_num++;
+        session_manager.kserver.stats.add(sock_type, cmd.device, ERRORS);
+    }
+
+    {
+#if KSERVER_HAS_THREADS
+        std::lock_guard<std::mutex> lock(send_mutex);
+#endif
+        PERF_OP_RECORD(cmd, std::chrono::duration_cast
+                                <std::chrono::nanoseconds>(duration).count())
+    }
+
+    if(send_async_reply(reply, exec_status) < 0) {
+        syslog_ptr->print(SysLog::ERROR, 
+                          "Can't send the reply of request %u\n", 
+                          reply.req_id);
+    }
+
+    exec_device = NO_DEVICE;
+}
+
+int Session::send_async_reply(const AsyncReply& reply, int status)
+{
+    uint32_t header[3];
+    header[0] = reply.req_id;
+    header[1] = static_cast<uint32_t>(status);
+    header[2] = reply.data.size();
+
+    std::string frame(reinterpret_cast<const char*>(header), sizeof(header));
+    frame += reply.data;
+
+    syslog_ptr->print(SysLog::DEBUG, "[S@%u] #%u [%u bytes]\n", 
+                      id, reply.req_id, frame.size());
+
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(send_mutex);
+#endif
+
+    return SendArray<char>(frame.data(), frame.size());
+}
+
+void Session::wait_async_cmds()
+{
+#if KSERVER_HAS_THREADS
+    std::unique_lock<std::mutex> lock(pending_mutex);
+    pending_cond.wait(lock, [this] {return pending_num == 0;});
+#endif
+}
+
 int Session::Run()
 {
-    if(init_session() < 0) {
+    int err_init = init_session();
+
+    if(err_init < 0) {
         return -1;
     }
+    
+    if(err_init == 1) { // Request fully served at connection (HTTP)
+        exit_session();
+        return 0;
+    }
 	
     while(!session_manager.kserver.exit_comm.load()) {
         PERF_TIC(READY_TO_READ)
@@ -316,67 +537,91 @@ int Session::Run()
 #endif
         }
         
-        if(err_read == 1) {
+        if(err_read == 0) { // Connection closed by client
             break;
         } else if(err_read < 0) {
+            wait_async_cmds();
             exit_session();
             return err_read;
         }
         
+        session_manager.kserver.stats.add(sock_type, NO_DEVICE, 
+                                          BYTES_IN, err_read);
+        
         PERF_TIC(PARSE)
  
         // Parse and execute
         if(parse_input_buffer() == 1) { // Request not complete
             continue;
         } else {
-            // TODO (TV, 20/09/2015) 
-            // We perf the execution time for all the commands.
-            // Need to perf command per command and to store 
-            // the executed command for precise perf of the devices
+            // The execution duration of each command is
+            // recorded per (device, operation) in execute_cmds()
             PERF_TIC(EXECUTE)
             
             execute_cmds();
         }
     }
 
+    wait_async_cmds();
     exit_session();	
     return 0;
 }
 
 const uint32_t* Session::RcvHandshake(uint32_t buff_size)
 {
+    const uint32_t *data = nullptr;
+
+    // The socket is read by the session thread only
+    if(async_reply != nullptr) {
+        syslog_ptr->print(SysLog::ERROR, 
+                "RcvHandshake: Not available for asynchronous requests\n");
+        return nullptr;
+    }
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->RcvHandshake(buff_size);
+        data = TCPSOCKET->RcvHandshake(buff_size);
+        break;
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->RcvHandshake(buff_size);
+        data = UNIXSOCKET->RcvHandshake(buff_size);
+        break;
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->RcvHandshake(buff_size);
+        data = WEBSOCKET->RcvHandshake(buff_size);
+        break;
 #endif
     }
     
-    return nullptr;
+    if(data != nullptr)
+        session_manager.kserver.stats.add(sock_type, exec_device, BYTES_IN,
+                                          sizeof(uint32_t) * buff_size);
+    
+    return data;
 }
 
 int Session::SendCstr(const char* string)
 {
+    if(async_reply != nullptr)
+        return async_reply->append(string, strlen(string));
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->SendCstr(string);
+        return __count_bytes_out(TCPSOCKET->SendCstr(string));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->SendCstr(string);
+        return __count_bytes_out(UNIXSOCKET->SendCstr(string));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->SendCstr(string);
+        return __count_bytes_out(WEBSOCKET->SendCstr(string));
 #endif
     }
     
@@ -12,6 +12,13 @@
 
 #include <string>
 #include <ctime>
+#include <atomic>
+#include <cstring>
+
+#if KSERVER_HAS_THREADS
+#include <mutex>
+#include <condition_variable>
+#endif
 
 #include "commands.hpp"
 #include "devices_manager.hpp"
@@ -20,6 +27,8 @@
 #include "socket_interface.hpp"
 #include "peer_info.hpp"
 
+#include <signal/kencode.hpp>
+
 #if KSERVER_HAS_PERF
 #include "perf_monitor.hpp"
 #endif
@@ -41,6 +50,34 @@ struct SessionPermissions
 
 class SessionManager;
 
+/// @brief Reply of an asynchronous request
+///
+/// The data sent by the device during the execution are
+/// accumulated, then sent at once after the header:
+/// | req_id (uint32) | status (int32) | length (uint32) | data |
+struct AsyncReply
+{
+    uint32_t req_id;
+    std::string data;
+
+    inline int append(const void *bytes, unsigned int len)
+    {
+        data.append(static_cast<const char*>(bytes), len);
+        return len;
+    }
+
+    template<class T>
+    inline int append(const T& value)
+    {
+        return append(&value, sizeof(T));
+    }
+
+    inline int append(const std::string& str)
+    {
+        return append(str.data(), str.size());
+    }
+};
+
 /// Session
 ///
 /// Receive and parse the client request for execution.
@@ -48,6 +85,16 @@ class SessionManager;
 /// By calling the appropriate socket interface, it offers
 /// an abstract communication layer to the devices. Thus
 /// shielding them from the underlying communication protocol.
+///
+/// A command prefixed by a request ID:
+///     #ID|DEVICE|OPERATION|p1|p2|...|pn|\n
+/// is executed asynchronously by the KServer executor. Its reply
+/// (AsyncReply) is tagged with the ID and sent as soon as the
+/// execution completes, so the replies can arrive out-of-order.
+///
+/// A command prefixed by an encoding (after the request ID if any):
+///     %ENC|DEVICE|OPERATION|p1|p2|...|pn|\n
+/// has its arrays of 32 bits values sent as encoded frames (KEncoder).
 class Session
 {
   public:
@@ -102,6 +149,8 @@ class Session
     /// 2) KServer acknowledges reception readiness by sending
     ///    the number of points to receive to the client
     /// 3) The client send the data buffer
+    ///
+    /// Not available for the asynchronous requests.
     const uint32_t* RcvHandshake(uint32_t buff_size);
     
     /// @brief Send scalar data
@@ -116,7 +165,12 @@ class Session
     template<typename T> int SendArray(const T* data, unsigned int len);
     
     /// @brief Send a KVector
-    template<typename T> int Send(const Klib::KVector<T>& vect);
+    template<typename T, typename A> 
+    int Send(const Klib::KVector<T, A>& vect);
+    
+    /// @brief Send a KVectorView, without copy of the buffer
+    template<typename T, bool V>
+    int Send(const Klib::KVectorView<T, V>& view);
     
     /// @brief Send a std::vector
     template<typename T> int Send(const std::vector<T>& vect);
@@ -141,8 +195,8 @@ class Session
     
     // -------------------
     // Monitoring
-    unsigned int requests_num;
-    unsigned int errors_num;
+    std::atomic<unsigned int> requests_num;
+    std::atomic<unsigned int> errors_num;
     
 #if KSERVER_HAS_PERF
     PerfMonitor perf;
@@ -152,6 +206,31 @@ class Session
     // -------------------
     
     std::vector<Command> cmd_list; ///< Last received commands
+
+    /// Device of the command being executed by the thread
+    static thread_local device_t exec_device;
+
+    /// Reply of the asynchronous request executed by the thread.
+    /// Data sent are appended to it instead of being sent.
+    static thread_local AsyncReply *async_reply;
+
+    /// Encoding of the arrays sent by the command executed by the thread
+    static thread_local Klib::kencoding_t reply_encoding;
+    static thread_local Klib::KEncoder encoder;
+
+#if KSERVER_HAS_THREADS
+    /// Prevents the replies from being interleaved.
+    /// Also protects the operations latencies of perf.
+    std::mutex send_mutex;
+
+    /// Lock of send_mutex of the synchronous command executed by the
+    /// thread, taken at the first data sent (see execute_cmds)
+    static thread_local std::unique_lock<std::mutex> *send_lock;
+
+    std::mutex pending_mutex;
+    std::condition_variable pending_cond;
+    unsigned int pending_num; ///< Asynchronous requests in flight
+#endif
     
     SocketInterface *socket;
     
@@ -172,6 +251,58 @@ class Session
     int parse_input_buffer(void);
     
     void execute_cmds();
+
+    /// Queue an asynchronous command in the executor
+    void post_async_cmd(const Command& cmd);
+
+    /// Execute an asynchronous command and send its reply
+    void execute_async_cmd(Command& cmd);
+
+    /// Send the reply of an asynchronous command
+    int send_async_reply(const AsyncReply& reply, int status);
+
+    /// Wait for the completion of the asynchronous commands
+    void wait_async_cmds();
+    
+    /// Encode an array into encoder if the command requested it
+    /// @return false if the array must be sent as is
+    template<typename T>
+    typename std::enable_if<Klib::KIsEncodable<T>::value, bool>::type
+    encode_array(const T* data, unsigned int len)
+    {
+        if(reply_encoding == Klib::KENC_NONE)
+            return false;
+
+        encoder.Encode<T>(reply_encoding, data, len);
+        return true;
+    }
+
+    template<typename T>
+    typename std::enable_if<!Klib::KIsEncodable<T>::value, bool>::type
+    encode_array(const T*, unsigned int)
+    {
+        return false;
+    }
+
+    /// Take the lock of the replies before sending
+    /// the reply of a synchronous command
+    inline void __lock_send()
+    {
+#if KSERVER_HAS_THREADS
+        if(send_lock != nullptr && !send_lock->owns_lock())
+            send_lock->lock();
+#endif
+    }
+
+    /// Account the bytes sent for the device being executed
+    inline int __count_bytes_out(int bytes_send)
+    {
+        if(bytes_send > 0)
+            session_manager.kserver.stats.add(sock_type, exec_device, 
+                                              BYTES_OUT, bytes_send);
+
+        return bytes_send;
+    }
     
 friend class SessionManager;
 };
@@ -185,18 +316,23 @@ friend class SessionManager;
 template<class T> 
 int Session::Send(const T& data)
 {
+    if(async_reply != nullptr)
+        return async_reply->append(data);
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->template Send<T>(data);
+        return __count_bytes_out(TCPSOCKET->template Send<T>(data));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->template Send<T>(data);
+        return __count_bytes_out(UNIXSOCKET->template Send<T>(data));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->template Send<T>(data);
+        return __count_bytes_out(WEBSOCKET->template Send<T>(data));
 #endif
     }
     
@@ -206,39 +342,84 @@ int Session::Send(const T& data)
 template<typename T> 
 int Session::SendArray(const T* data, unsigned int len)
 {
+    if(encode_array<T>(data, len))
+        return SendArray<char>(encoder.Frame(), encoder.FrameSize());
+
+    if(async_reply != nullptr)
+        return async_reply->append(data, sizeof(T) * len);
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->template SendArray<T>(data, len);
+        return __count_bytes_out(TCPSOCKET->template SendArray<T>(data, len));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->template SendArray<T>(data, len);
+        return __count_bytes_out(UNIXSOCKET->template SendArray<T>(data, len));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->template SendArray<T>(data, len);
+        return __count_bytes_out(WEBSOCKET->template SendArray<T>(data, len));
 #endif
     }
     
     return -1;
 }
 
-template<typename T>
-int Session::Send(const Klib::KVector<T>& vect)
+template<typename T, typename A>
+int Session::Send(const Klib::KVector<T, A>& vect)
+{
+    if(encode_array<T>(vect.get_ptr(), vect.size()))
+        return SendArray<char>(encoder.Frame(), encoder.FrameSize());
+
+    if(async_reply != nullptr)
+        return async_reply->append(vect.get_ptr(), sizeof(T) * vect.size());
+
+    __lock_send();
+
+    switch(sock_type) {
+#if KSERVER_HAS_TCP
+      case TCP:
+        return __count_bytes_out(TCPSOCKET->template Send<T>(vect));
+#endif
+#if KSERVER_HAS_UNIX_SOCKET
+      case UNIX:
+        return __count_bytes_out(UNIXSOCKET->template Send<T>(vect));
+#endif
+#if KSERVER_HAS_WEBSOCKET
+      case WEBSOCK:
+        return __count_bytes_out(WEBSOCKET->template Send<T>(vect));
+#endif
+    }
+    
+    return -1;
+}
+
+template<typename T, bool V>
+int Session::Send(const Klib::KVectorView<T, V>& view)
 {
+    if(encode_array<T>(view.get_ptr(), view.size()))
+        return SendArray<char>(encoder.Frame(), encoder.FrameSize());
+
+    if(async_reply != nullptr)
+        return async_reply->append(view.get_ptr(), sizeof(T) * view.size());
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->template Send<T>(vect);
+        return __count_bytes_out(TCPSOCKET->template Send<T, V>(view));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->template Send<T>(vect);
+        return __count_bytes_out(UNIXSOCKET->template Send<T, V>(view));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->template Send<T>(vect);
+        return __count_bytes_out(WEBSOCKET->template Send<T, V>(view));
 #endif
     }
     
@@ -248,18 +429,26 @@ int Session::Send(const Klib::KVector<T>& vect)
 template<typename T>
 int Session::Send(const std::vector<T>& vect)
 {
+    if(encode_array<T>(vect.data(), vect.size()))
+        return SendArray<char>(encoder.Frame(), encoder.FrameSize());
+
+    if(async_reply != nullptr)
+        return async_reply->append(vect.data(), sizeof(T) * vect.size());
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->template Send<T>(vect);
+        return __count_bytes_out(TCPSOCKET->template Send<T>(vect));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->template Send<T>(vect);
+        return __count_bytes_out(UNIXSOCKET->template Send<T>(vect));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->template Send<T>(vect);
+        return __count_bytes_out(WEBSOCKET->template Send<T>(vect));
 #endif
     }
     
@@ -269,18 +458,27 @@ int Session::Send(const std::vector<T>& vect)
 template<typename... Tp>
 int Session::Send(const std::tuple<Tp...>& t)
 {
+    if(async_reply != nullptr) {
+        std::stringstream ss;
+        stringify_tuple(t, ss);
+        ss << std::endl;
+        return async_reply->append(ss.str());
+    }
+
+    __lock_send();
+
     switch(sock_type) {
 #if KSERVER_HAS_TCP
       case TCP:
-        return TCPSOCKET->template Send<Tp...>(t);
+        return __count_bytes_out(TCPSOCKET->template Send<Tp...>(t));
 #endif
 #if KSERVER_HAS_UNIX_SOCKET
       case UNIX:
-        return UNIXSOCKET->template Send<Tp...>(t);
+        return __count_bytes_out(UNIXSOCKET->template Send<Tp...>(t));
 #endif
 #if KSERVER_HAS_WEBSOCKET
       case WEBSOCK:
-        return WEBSOCKET->template Send<Tp...>(t);
+        return __count_bytes_out(WEBSOCKET->template Send<Tp...>(t));
 #endif
     }
     
@@ -0,0 +1,190 @@
+/// @file kserver_stats.hpp
+///
+/// @brief Server statistics
+///
+/// Counters are split into shards aligned on cache lines.
+/// Each thread increments the counters of its own shard,
+/// thus the request path never contends on a counter nor
+/// on a cache line. Shards are summed when the statistics
+/// are read (GET_STATS).
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __KSERVER_STATS_HPP__
+#define __KSERVER_STATS_HPP__
+
+#include <array>
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+#include "kserver_defs.hpp"
+#include "dev_definitions.hpp"
+
+namespace kserver {
+
+/// Size of a cache line in bytes
+#define KSERVER_CACHE_LINE_SIZE 64
+
+/// Number of shards.
+/// Threads are attributed a shard in a round-robin way.
+#define KSERVER_STATS_SHARDS_NUM 16
+
+/// Statistics counters
+typedef enum {
+    BYTES_IN,           ///< Bytes received from the clients
+    BYTES_OUT,          ///< Bytes sent to the clients
+    REQUESTS,           ///< Executed requests
+    ERRORS,             ///< Requests terminated with an error
+    CONNECTIONS,        ///< Opened sessions
+    DISCONNECTIONS,     ///< Closed sessions
+    stats_counters_num
+} stats_counter_t;
+
+/// Counters descriptions
+const std::array< std::string, stats_counters_num >
+stats_counters_desc = {{
+    "bytes_in",
+    "bytes_out",
+    "requests",
+    "errors",
+    "connections",
+    "disconnections"
+}};
+
+/// Aggregated counters of a listener or a device
+struct StatsCounters
+{
+    std::array<uint64_t, stats_counters_num> values;
+
+    inline uint64_t operator[](stats_counter_t cnt) const
+    {
+        return values[cnt];
+    }
+};
+
+/// Server statistics per listener and per device
+///
+/// Traffic which cannot be attributed to a device
+/// (commands reception, connections, ...) is accounted
+/// for NO_DEVICE.
+template<int listeners_num>
+class ServerStats
+{
+  public:
+    ServerStats()
+    {
+        next_shard.store(0);
+
+        for(auto& shard : shards) {
+            for(auto& listener : shard.listeners)
+                for(auto& counter : listener)
+                    counter.store(0);
+
+            for(auto& device : shard.devices)
+                for(auto& counter : device)
+                    counter.store(0);
+        }
+    }
+
+    /// @brief Add a value to a counter
+    /// @listener Listener type
+    /// @dev Device concerned
+    /// @cnt Counter to increment
+    /// @val Value to add
+    inline void add(int listener, device_t dev, stats_counter_t cnt,
+                    uint64_t val = 1)
+    {
+        Shard& shard = shards[__get_shard_idx()];
+
+        // Commands with an invalid device are attributed to NO_DEVICE
+        if(dev >= device_num)
+            dev = NO_DEVICE;
+
+        shard.listeners[listener][cnt].fetch_add(val,
+                                            std::memory_order_relaxed);
+        shard.devices[dev][cnt].fetch_add(val, std::memory_order_relaxed);
+    }
+
+    /// Sum up the counters of a listener
+    StatsCounters get_listener(int listener) const
+    {
+        StatsCounters res;
+        res.values.fill(0);
+
+        for(auto& shard : shards)
+            for(unsigned int i=0; i<stats_counters_num; i++)
+                res.values[i] += shard.listeners[listener][i]
+                                    .load(std::memory_order_relaxed);
+
+        return res;
+    }
+
+    /// @brief Number of running sessions of a listener
+    ///
+    /// The disconnections are read before the connections, and the
+    /// difference is clamped: a session closing during the read can't
+    /// make the counters read as more disconnections than connections.
+    uint64_t get_sessions(int listener) const
+    {
+        uint64_t disconnections = __sum(listener, DISCONNECTIONS);
+        uint64_t connections = __sum(listener, CONNECTIONS);
+
+        return connections > disconnections ? connections - disconnections : 0;
+    }
+
+    /// Sum up the counters of a device
+    StatsCounters get_device(device_t dev) const
+    {
+        StatsCounters res;
+        res.values.fill(0);
+
+        for(auto& shard : shards)
+            for(unsigned int i=0; i<stats_counters_num; i++)
+                res.values[i] += shard.devices[dev][i]
+                                    .load(std::memory_order_relaxed);
+
+        return res;
+    }
+
+  private:
+    typedef std::array<std::atomic<uint64_t>, stats_counters_num> Counters;
+
+    struct alignas(KSERVER_CACHE_LINE_SIZE) Shard
+    {
+        std::array<Counters, listeners_num> listeners;
+        std::array<Counters, device_num> devices;
+    };
+
+    std::array<Shard, KSERVER_STATS_SHARDS_NUM> shards;
+    std::atomic<unsigned int> next_shard;
+
+    inline uint64_t __sum(int listener, stats_counter_t cnt) const
+    {
+        uint64_t res = 0;
+
+        for(auto& shard : shards)
+            res += shard.listeners[listener][cnt]
+                       .load(std::memory_order_acquire);
+
+        return res;
+    }
+
+    inline unsigned int __get_shard_idx()
+    {
+        static thread_local int shard_idx = -1;
+
+        if(shard_idx < 0)
+            shard_idx = next_shard.fetch_add(1, std::memory_order_relaxed)
+                        % KSERVER_STATS_SHARDS_NUM;
+
+        return shard_idx;
+    }
+}; // ServerStats
+
+} // namespace kserver
+
+#endif // __KSERVER_STATS_HPP__
+
@@ -14,10 +14,6 @@
 #include <cstdarg>
 #include <cstring>
 
-#if KSERVER_HAS_THREADS
-#  include <thread>
-#endif
-
 #include "kserver_defs.hpp"
 
 namespace kserver {
@@ -25,8 +21,6 @@ namespace kserver {
 SysLog::SysLog(KServerConfig *config_)
 : config(config_)
 {
-    memset(fmt_buffer, 0, FMT_BUFF_LEN);
-
     if(config->syslog) {
         setlogmask(LOG_UPTO(KSERVER_SYSLOG_UPTO));
         openlog("KServer", LOG_CONS | LOG_PID | LOG_NDELAY, LOG_USER);
@@ -49,11 +43,12 @@ void SysLog::close()
     }
 }
 
-int SysLog::print_stderr(const char *header, const char *message, ...)
+int SysLog::print_stderr(const char *header, const char *message, 
+                         va_list argptr)
 {
-    va_list argptr;
-    va_start(argptr, message);
-    
+    // On the stack: concurrent sessions don't share the buffer
+    char fmt_buffer[FMT_BUFF_LEN];
+
     int ret = snprintf(fmt_buffer, FMT_BUFF_LEN, "%s: %s", header, message);
 
     if(ret < 0) {
@@ -67,16 +62,17 @@ int SysLog::print_stderr(const char *header, const char *message, ...)
     }
     
     vfprintf(stderr, fmt_buffer, argptr);
-    va_end(argptr);
-    
     return 0;
 }
 
 void SysLog::print(unsigned int severity, const char *message, ...)
 {    
-#if KSERVER_HAS_THREADS
-    std::lock_guard<std::mutex> lock(mutex);
-#endif
+    // No lock is required: stdio and syslog calls are thread-safe.
+    // The debug messages of the requests path are dropped here
+    // when neither the verbose mode nor syslog are enabled.
+    if(severity >= INFO && !config->verbose && !config->syslog) {
+        return;
+    }
 
     va_list argptr, argptr2;
     va_start(argptr, message);
@@ -10,11 +10,9 @@
 #ifndef __KSERVER_SYSLOG_HPP__
 #define __KSERVER_SYSLOG_HPP__
 
-#include "config.hpp"
+#include <cstdarg>
 
-#if KSERVER_HAS_THREADS
-#  include <mutex>
-#endif
+#include "config.hpp"
 
 namespace kserver {
 
@@ -42,13 +40,8 @@ struct SysLog
 private:
     KServerConfig *config;
     
-    char fmt_buffer[FMT_BUFF_LEN];
-    
-    int print_stderr(const char *header, const char *message, ...);
-    
-#if KSERVER_HAS_THREADS
-    std::mutex mutex;
-#endif
+    int print_stderr(const char *header, const char *message, 
+                     va_list argptr);
 };
 
 } // namespace kserver
@@ -139,8 +139,25 @@ void session_thread_call(int comm_fd, PeerInfo peer_info,
                          ListeningChannel<sock_type> *listener)
 {
     listener->inc_thread_num();
-    listener->stats.opened_sessions_num++;
-    listener->stats.total_sessions_num++;
+
+#if KSERVER_HAS_WEBSOCKET
+    // A metrics scrape is served without a session: it doesn't take
+    // the write permission, nor appear in the statistics
+    if(sock_type == WEBSOCK && WebSocket::is_metrics_request(comm_fd)) {
+        WebSocket http(listener->kserver->config, listener->kserver);
+        http.set_id(comm_fd);
+
+        if(http.authenticate() < 0)
+            listener->kserver->syslog.print(SysLog::ERROR, 
+                                            "Cannot serve the metrics\n");
+
+        close(comm_fd);
+        listener->dec_thread_num();
+        return;
+    }
+#endif
+
+    listener->kserver->stats.add(sock_type, NO_DEVICE, CONNECTIONS);
           
     Session *session
         = listener->kserver->session_manager.CreateSession(
@@ -164,13 +181,12 @@ void session_thread_call(int comm_fd, PeerInfo peer_info,
         listener->kserver->syslog.print(SysLog::INFO, 
                     "Close session id = %u with #req = %u. #err = %u\n", 
                     sid, session->RequestNum(), session->ErrorNum());
-                              
-        listener->stats.total_requests_num += session->RequestNum();
+
         listener->kserver->session_manager.DeleteSession(sid); 
     }
        
     listener->dec_thread_num();
-    listener->stats.opened_sessions_num--;
+    listener->kserver->stats.add(sock_type, NO_DEVICE, DISCONNECTIONS);
 }
 
 template<int sock_type>
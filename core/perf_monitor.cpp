@@ -9,43 +9,173 @@
 
 #include "perf_monitor.hpp"
 
+#include <cmath>
+
 namespace kserver {
 
+// ---------------------------------------------
+// LatencyHistogram
+// ---------------------------------------------
+
+LatencyHistogram::LatencyHistogram()
+: count(0)
+, sum(0)
+, max(0)
+{
+    for(auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+}
+
+/// Add to a counter having a single writer
+static inline void __add(std::atomic<uint64_t>& counter, uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+}
+
+unsigned int LatencyHistogram::__bucket_index(uint64_t duration)
+{
+    if(duration < HIST_SUB_NUM)
+        return static_cast<unsigned int>(duration);
+
+    // Position of the most significant bit
+    unsigned int exp = 63 - __builtin_clzll(duration);
+
+    if(exp > HIST_MAX_EXP)
+        return HIST_BUCKETS_NUM - 1;
+
+    // Sub-bucket given by the HIST_SUB_BITS bits following the MSB
+    unsigned int sub = (duration >> (exp - HIST_SUB_BITS)) - HIST_SUB_NUM;
+
+    return (exp - HIST_SUB_BITS + 1) * HIST_SUB_NUM + sub;
+}
+
+uint64_t LatencyHistogram::__bucket_upper_bound(unsigned int index)
+{
+    if(index < HIST_SUB_NUM)
+        return index;
+
+    unsigned int exp = index / HIST_SUB_NUM + HIST_SUB_BITS - 1;
+    unsigned int sub = index % HIST_SUB_NUM;
+    uint64_t width = 1ULL << (exp - HIST_SUB_BITS);
+
+    return (HIST_SUB_NUM + sub) * width + width - 1;
+}
+
+void LatencyHistogram::record(uint64_t duration)
+{
+    __add(buckets[__bucket_index(duration)], 1);
+    __add(count, 1);
+    __add(sum, duration);
+
+    if(duration > max.load(std::memory_order_relaxed))
+        max.store(duration, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& hist)
+{
+    for(unsigned int i=0; i<HIST_BUCKETS_NUM; i++)
+        __add(buckets[i], hist.buckets[i].load(std::memory_order_relaxed));
+
+    __add(count, hist.get_count());
+    __add(sum, hist.get_sum());
+
+    if(hist.get_max() > get_max())
+        max.store(hist.get_max(), std::memory_order_relaxed);
+}
+
+float LatencyHistogram::get_mean() const
+{
+    uint64_t count_ = get_count();
+
+    if(count_ == 0)
+        return 0.0;
+
+    return static_cast<float>(get_sum()) / count_;
+}
+
+uint64_t LatencyHistogram::get_percentile(float pct) const
+{
+    assert(pct >= 0.0 && pct <= 100.0);
+
+    // The counters can be updated while read:
+    // the rank is taken on the count read once
+    uint64_t count_ = get_count();
+    uint64_t max_ = get_max();
+
+    if(count_ == 0)
+        return 0;
+
+    // Rank of the percentile, in [1, count]
+    uint64_t rank = static_cast<uint64_t>(std::ceil(pct / 100.0 * count_));
+
+    if(rank == 0)
+        rank = 1;
+
+    uint64_t acc = 0;
+
+    for(unsigned int i=0; i<HIST_BUCKETS_NUM; i++) {
+        acc += buckets[i].load(std::memory_order_relaxed);
+
+        if(acc >= rank) {
+            uint64_t upper_bound = __bucket_upper_bound(i);
+            return upper_bound < max_ ? upper_bound : max_;
+        }
+    }
+
+    return max_;
+}
+
+// ---------------------------------------------
+// OpsLatencies
+// ---------------------------------------------
+
+void OpsLatencies::merge(const OpsLatencies& ops)
+{
+    for(unsigned int dev=0; dev<device_num; dev++)
+        for(unsigned int op=0; op<MAX_OP_NUM; op++)
+            histograms[dev][op].merge(ops.histograms[dev][op]);
+}
+
+// ---------------------------------------------
+// PerfMonitor
+// ---------------------------------------------
+
 PerfMonitor::PerfMonitor()
 {
     num_sess_loop = -1;
-        
-    for(int time_pt=0; time_pt<timing_points_num; time_pt++)
+
+    for(int time_pt=0; time_pt<timing_points_num; time_pt++) {
         durations[time_pt] = 0;
-        
-    min_duration = -1;
-    max_duration = -1;
+        min_durations[time_pt] = -1;
+        max_durations[time_pt] = -1;
+    }
 }
 
 void PerfMonitor::tic(timing_point_t time_pt)
-{    
+{
     assert(time_pt < timing_points_num);
-    assert((num_sess_loop == -1 && time_pt == READY_TO_READ) 
+    assert((num_sess_loop == -1 && time_pt == READY_TO_READ)
            || (num_sess_loop >= 0));
-    
+
     auto now = std::chrono::steady_clock::now();
-        
+
     if(num_sess_loop != -1) {
         int duration = std::chrono::duration_cast<std::chrono::microseconds>
                                                 (now - prev_time).count();
-        
+
         // We sum up the durations to provide
         // an average duration time dividing
         // by num_sess_loop afterwards.
         durations[time_pt] += duration;
-        
-        if(min_duration < 0 || duration < min_duration) 
-            min_duration = duration;
-            
-        if(duration > max_duration) 
-            max_duration = duration;
+
+        if(min_durations[time_pt] < 0 || duration < min_durations[time_pt])
+            min_durations[time_pt] = duration;
+
+        if(duration > max_durations[time_pt])
+            max_durations[time_pt] = duration;
     }
-                    
+
     prev_time = now;
 
     if(time_pt == READY_TO_READ)
@@ -59,3 +189,4 @@ float PerfMonitor::get_mean_duration(timing_point_t time_pt) const
 }
 
 } // namespace kserver
+
@@ -12,8 +12,13 @@
 
 #include <chrono>
 #include <array>
+#include <atomic>
+#include <string>
+#include <cstdint>
 #include <cassert>
 
+#include "dev_definitions.hpp"
+
 namespace kserver {
 
 typedef long long counts_t;
@@ -27,60 +32,199 @@ typedef enum timing_points {
 } timing_point_t;
 
 /// Timing points descriptions
-const std::array< std::string, timing_points_num > 
+const std::array< std::string, timing_points_num >
 timing_points_desc = {{
 	"Ready to read",
 	"Parse",
 	"Execute"
 }};
 
+// ---------------------------------------------
+// Latency histogram
+// ---------------------------------------------
+
+// Log-linear bucketing:
+// Durations below 2^HIST_SUB_BITS ns have their own bucket.
+// Above, each power of two is divided into 2^HIST_SUB_BITS
+// linear sub-buckets, which bounds the relative error of
+// the reported percentiles to 2^-HIST_SUB_BITS (12.5 %).
+
+#define HIST_SUB_BITS 3
+#define HIST_SUB_NUM  (1 << HIST_SUB_BITS)
+
+/// Durations above 2^(HIST_MAX_EXP+1) ns (~36 min) are saturated
+#define HIST_MAX_EXP 40
+
+#define HIST_BUCKETS_NUM ((HIST_MAX_EXP - HIST_SUB_BITS + 2) * HIST_SUB_NUM)
+
+/// @brief Histogram of durations in nanoseconds
+///
+/// The counters are relaxed atomics: the histograms of a session are
+/// read by the other sessions (GET_OPS_PERFS, metrics) while the
+/// session records. The records of a session are serialized by its
+/// send mutex, so a counter has a single writer at a time.
+class LatencyHistogram
+{
+  public:
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t duration);
+
+    /// Add the counts of another histogram
+    void merge(const LatencyHistogram& hist);
+
+    /// Number of recorded durations
+    inline uint64_t get_count() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    /// Maximum recorded duration
+    inline uint64_t get_max() const
+    {
+        return max.load(std::memory_order_relaxed);
+    }
+
+    /// Sum of the recorded durations
+    inline uint64_t get_sum() const
+    {
+        return sum.load(std::memory_order_relaxed);
+    }
+
+    /// Return the mean duration
+    float get_mean() const;
+
+    /// @brief Return a percentile of the durations
+    /// @pct Percentile in [0, 100]
+    ///
+    /// The value returned is the upper bound of the bucket
+    /// containing the percentile, limited by the maximum.
+    uint64_t get_percentile(float pct) const;
+
+  private:
+    std::array<std::atomic<uint64_t>, HIST_BUCKETS_NUM> buckets;
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+
+    static unsigned int __bucket_index(uint64_t duration);
+    static uint64_t __bucket_upper_bound(unsigned int index);
+}; // LatencyHistogram
+
+/// @brief Latency histograms of each (device, operation)
+///
+/// About 300 kB: allocate it on the heap, not on a thread stack.
+class OpsLatencies
+{
+  public:
+    inline void record(device_t dev, operation_t op, uint64_t duration)
+    {
+        // Invalid commands are rejected before execution,
+        // but the client can still send any operation number
+        if(dev < device_num && op < MAX_OP_NUM)
+            histograms[dev][op].record(duration);
+    }
+
+    void merge(const OpsLatencies& ops);
+
+    inline const LatencyHistogram& get(device_t dev, operation_t op) const
+    {
+        assert(dev < device_num && op < MAX_OP_NUM);
+        return histograms[dev][op];
+    }
+
+  private:
+    std::array< std::array<LatencyHistogram, MAX_OP_NUM>, device_num >
+    histograms;
+}; // OpsLatencies
+
+// ---------------------------------------------
+// Session perfs
+// ---------------------------------------------
+
 // Timing points:
 // t(0) --> ... --> t(i-1) --> t(i) --> ... --> t(N-1)
 //
 // Durations:
-// Dt(i) = t(i) - t(i-1) 
+// Dt(i) = t(i) - t(i-1)
 
 class PerfMonitor
 {
   public:
     PerfMonitor();
-    
+
     void tic(timing_point_t time_pt);
-    
+
     /// Return the mean duration of a given step
     float get_mean_duration(timing_point_t time_pt) const;
-    
+
     /// Return the minimum duration of a given step
     inline int get_min_duration(timing_point_t time_pt) const
     {
         assert(time_pt < timing_points_num);
-        return min_duration;
+        return min_durations[time_pt];
     }
-    
+
     /// Return the maximum duration of a given step
     inline int get_max_duration(timing_point_t time_pt) const
     {
         assert(time_pt < timing_points_num);
-        return max_duration;
+        return max_durations[time_pt];
+    }
+
+    /// Start timing the execution of an operation
+    inline void op_start()
+    {
+        op_start_time = std::chrono::steady_clock::now();
+    }
+
+    /// Record the execution duration of an operation
+    inline void op_stop(device_t dev, operation_t op)
+    {
+        auto now = std::chrono::steady_clock::now();
+        op_record(dev, op,
+                  std::chrono::duration_cast<std::chrono::nanoseconds>
+                                            (now - op_start_time).count());
+    }
+
+    /// Record an execution duration measured by the caller.
+    /// Used for the operations executed asynchronously.
+    inline void op_record(device_t dev, operation_t op, uint64_t duration)
+    {
+        ops_latencies.record(dev, op, duration);
+    }
+
+    inline const OpsLatencies& get_ops_latencies() const
+    {
+        return ops_latencies;
     }
-    
+
   private:
     /// Number of times we closed the session loop,
     /// i.e. when we came back to READY_TO_READ
     int num_sess_loop;
-  
+
     /// Previous time
     std::chrono::steady_clock::time_point prev_time;
-    
+
     /// Durations inbetween timing points
     std::array<counts_t, timing_points_num> durations;
-    
-    /// Minimum duration
-    int min_duration;
-    
-    /// Maximum duration
-    int max_duration;
-    
+
+    /// Minimum durations
+    std::array<int, timing_points_num> min_durations;
+
+    /// Maximum durations
+    std::array<int, timing_points_num> max_durations;
+
+    /// Start time of the operation being executed
+    std::chrono::steady_clock::time_point op_start_time;
+
+    /// Execution durations of the operations
+    OpsLatencies ops_latencies;
+
 }; // PerfMonitor
 
 } // namespace kserver
@@ -20,7 +20,8 @@ namespace kserver {
 
 SessionManager::SessionManager(KServer& kserver_, DeviceManager& dev_manager_, 
                                int perm_policy_)
-: kserver(kserver_), 
+: num_sess(0),
+  kserver(kserver_), 
   dev_manager(dev_manager_),
   perm_policy(perm_policy_),
   fcfs_id(-1),
@@ -39,8 +40,6 @@ size_t SessionManager::GetNumSess() const
     return session_pool.size();
 }
 
-unsigned int SessionManager::num_sess = 0;
-
 Session* SessionManager::CreateSession(KServerConfig *config_, int comm_fd,
                                        int sock_type, PeerInfo peer_info)
 {
@@ -190,40 +189,122 @@ void SessionManager::__reset_permissions(SessID id)
 }
 
 void SessionManager::DeleteSession(SessID id)
+{
+    {
+#if KSERVER_HAS_THREADS
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+        if(__delete_session(id) < 0)
+            return;
+    }
+
+    __release_session(id);
+}
+
+int SessionManager::__delete_session(SessID id)
 {
     if(!__is_current_id(id)) {
         kserver.syslog.print(SysLog::INFO, 
                              "Not allocated session ID: %u\n", id);
-        return;
+        return -1;
     }
     
     if(session_pool[id] != NULL) {
+#if KSERVER_HAS_PERF
+        closed_sess_latencies.merge(
+                session_pool[id]->GetPerf()->get_ops_latencies());
+#endif
+
         close(session_pool[id]->comm_fd);
         delete session_pool[id];
     }
-    
+
     __reset_permissions(id);
 
     session_pool.erase(id);
+    return 0;
+}
+
+void SessionManager::__release_session(SessID id)
+{
+    // Called without the lock of the sessions: releasing the
+    // memory maps waits for the operations running on DEV_MEM
+    kserver.dev_manager.ReleaseSession(id);
+
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+    // The session ID can be reused
     reusable_ids.push_back(id);
     num_sess--;
 }
 
 void SessionManager::DeleteAll()
 {
-    assert(num_sess == session_pool.size());
-    
-    if(!session_pool.empty()) {
-        std::vector<SessID> ids = GetCurrentIDs();
-        
-        for(size_t i=0; i<ids.size(); i++) {
-            kserver.syslog.print(SysLog::INFO, "Delete session %u\n", ids[i]);            
-            DeleteSession(ids[i]);
+    std::vector<SessID> ids;
+
+    {
+#if KSERVER_HAS_THREADS
+        std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+        if(!session_pool.empty()) {
+            ids = GetCurrentIDs();
+            
+            for(size_t i=0; i<ids.size(); i++) {
+                kserver.syslog.print(SysLog::INFO, "Delete session %u\n", ids[i]);            
+                __delete_session(ids[i]);
+            }
         }
+
+        assert(session_pool.empty());
     }
-    
-    assert(num_sess == 0);
+
+    for(size_t i=0; i<ids.size(); i++)
+        __release_session(ids[i]);
+}
+
+void SessionManager::ForEachSession(std::function<void(const Session&)> func)
+{
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+    for(auto it = session_pool.begin(); it != session_pool.end(); ++it)
+        func(*(it->second));
+}
+
+#if KSERVER_HAS_PERF
+void SessionManager::GetOpsLatencies(OpsLatencies& ops_latencies)
+{
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+    ops_latencies.merge(closed_sess_latencies);
+    std::vector<SessID> ids = GetCurrentIDs();
+
+    for(size_t i=0; i<ids.size(); i++)
+        ops_latencies.merge(session_pool[ids[i]]->GetPerf()
+                                               ->get_ops_latencies());
+}
+
+int SessionManager::GetOpsLatencies(SessID id, OpsLatencies& ops_latencies)
+{
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+
+    // The session can't be deleted during the merge
+    if(!__is_current_id(id))
+        return -1;
+
+    ops_latencies.merge(session_pool[id]->GetPerf()->get_ops_latencies());
+    return 0;
 }
+#endif
 
 } // namespace kserver
 
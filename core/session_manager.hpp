@@ -13,6 +13,8 @@
 #include <map>
 #include <vector>
 #include <stack>
+#include <atomic>
+#include <functional>
 
 #include "kserver_defs.hpp"
 #include "config.hpp"
@@ -21,6 +23,10 @@
 #  include <mutex>
 #endif
 
+#if KSERVER_HAS_PERF
+#  include "perf_monitor.hpp"
+#endif
+
 namespace kserver {
 
 class Session;
@@ -36,7 +42,9 @@ class SessionManager
     
     ~SessionManager();
     
-    static unsigned int num_sess;
+    /// Number of session IDs in use: the running sessions
+    /// and the deleted ones whose resources are being released
+    std::atomic<unsigned int> num_sess;
     
     size_t GetNumSess() const;
     
@@ -52,6 +60,21 @@ class SessionManager
     void DeleteSession(SessID id);
     
     void DeleteAll();
+    
+    /// @brief Call @func on each running session
+    /// The sessions cannot be deleted during the iteration
+    void ForEachSession(std::function<void(const Session&)> func);
+
+#if KSERVER_HAS_PERF
+    /// @brief Server-wide operations latencies
+    /// Closed sessions and running sessions are merged into @ops_latencies
+    void GetOpsLatencies(OpsLatencies& ops_latencies);
+
+    /// @brief Operations latencies of the session @id
+    /// Merged into @ops_latencies
+    /// @return -1 if the session doesn't exist
+    int GetOpsLatencies(SessID id, OpsLatencies& ops_latencies);
+#endif
 
     KServer& kserver;
     DeviceManager& dev_manager;
@@ -86,6 +109,21 @@ class SessionManager
     std::map<SessID, Session*> session_pool;
     std::vector<SessID> reusable_ids;
     
+#if KSERVER_HAS_PERF
+    /// Operations latencies of the closed sessions
+    OpsLatencies closed_sess_latencies;
+#endif
+    
+    /// @brief Close a session and remove it from the pool
+    /// @return -1 if the session doesn't exist
+    int __delete_session(SessID id);
+
+    /// @brief Release the resources of a deleted session,
+    ///        then let its ID be reused
+    ///
+    /// Must be called without the lock of the sessions.
+    void __release_session(SessID id);
+
     void __apply_permissions(Session *last_created_session);
     void __reset_permissions(SessID id);
     void __print_reusable_ids();
@@ -66,7 +66,7 @@ int TCPSocketInterface::read_data(char *buff_str, char *remain_str)
     }
 
     if(nb_bytes_rcvd == 0) {
-        return 1; // Connection closed by client
+        return 0; // Connection closed by client
     }
         
     kserver->syslog.print(SysLog::DEBUG, "[R@%u] [%d bytes]\n", 
@@ -90,7 +90,7 @@ int TCPSocketInterface::read_data(char *buff_str, char *remain_str)
         return -1;
     }
     
-    return 0;
+    return nb_bytes_rcvd;
 }
 
 int TCPSocketInterface::RcvDataBuffer(uint32_t n_bytes)
@@ -174,14 +174,16 @@ SEND_SPECIALIZE_IMPL(WebSocketInterface)
 int WebSocketInterface::init(void)
 {    
     websock.set_id(comm_fd);
+    
+    int err = websock.authenticate();
             
-    if(websock.authenticate() < 0) {
+    if(err < 0) {
         kserver->syslog.print(SysLog::CRITICAL, 
                               "Cannot connect websocket to client\n");	
         return -1;
     }
 	
-	return 0;
+	return err;
 }
 
 int WebSocketInterface::exit(void) {return 0;}
@@ -190,18 +192,25 @@ int WebSocketInterface::read_data(char *buff_str, char *remain_str)
 {
     bzero(buff_str, 2*KSERVER_READ_STR_LEN);
     
-    if(websock.receive() < 0) { 
-        if(websock.is_closed())
-            return 1; // Connection closed by client
-        else
-            return -1;
-    }
+    int payload_size;
+    
+    // Skip empty frames: 0 is reserved for connection closed
+    do {
+        payload_size = websock.receive();
+    
+        if(payload_size < 0) { 
+            if(websock.is_closed())
+                return 0; // Connection closed by client
+            else
+                return -1;
+        }
+    } while(payload_size == 0);
         
     if(websock.get_payload(buff_str, 2*KSERVER_READ_STR_LEN) < 0) {
         return -1;                                  
     }
     
-    return 0;
+    return payload_size;
 }
 
 const uint32_t* WebSocketInterface::RcvHandshake(uint32_t buff_size)
@@ -22,6 +22,7 @@
 #endif
 
 #include <signal/kvector.hpp>
+#include <signal/kvector_view.hpp>
 
 namespace kserver {
 
@@ -84,19 +85,29 @@ class SocketInterface
     const uint32_t* RcvHandshake(uint32_t buff_size);                   \
                                                                         \
     template<class T> int Send(const T& data);                          \
-    template<typename T> int Send(const Klib::KVector<T>& vect);        \
+    template<typename T, typename A>                                    \
+    int Send(const Klib::KVector<T, A>& vect);                          \
+    template<typename T, bool V>                                        \
+    int Send(const Klib::KVectorView<T, V>& view);                      \
     template<typename T> int Send(const std::vector<T>& vect);          \
     int SendCstr(const char *string);                                   \
     template<class T> int SendArray(const T *data, unsigned int len);   \
     template<typename... Tp> int Send(const std::tuple<Tp...>& t);
 
 #define SEND_KVECTOR(sock_interf)                       \
-  template<typename T>                                  \
-  int sock_interf::Send(const Klib::KVector<T>& vect)   \
+  template<typename T, typename A>                      \
+  int sock_interf::Send(const Klib::KVector<T, A>& vect) \
   {                                                     \
       return SendArray<T>(vect.get_ptr(), vect.size()); \
   } 
   
+#define SEND_KVECTOR_VIEW(sock_interf)                          \
+  template<typename T, bool V>                                  \
+  int sock_interf::Send(const Klib::KVectorView<T, V>& view)    \
+  {                                                             \
+      return SendArray<T>(view.get_ptr(), view.size());         \
+  }
+
 #define SEND_STD_VECTOR(sock_interf)                    \
   template<typename T>                                  \
   int sock_interf::Send(const std::vector<T>& vect)     \
@@ -145,6 +156,7 @@ class TCPSocketInterface : public SocketInterface
 }; // TCPSocketInterface
 
 SEND_KVECTOR(TCPSocketInterface)
+SEND_KVECTOR_VIEW(TCPSocketInterface)
 SEND_STD_VECTOR(TCPSocketInterface)
 SEND_TUPLE(TCPSocketInterface)
 SEND_SPECIALIZE(TCPSocketInterface)
@@ -203,6 +215,7 @@ class WebSocketInterface : public SocketInterface
 }; // WebSocketInterface
 
 SEND_KVECTOR(WebSocketInterface)
+SEND_KVECTOR_VIEW(WebSocketInterface)
 SEND_STD_VECTOR(WebSocketInterface)
 SEND_TUPLE(WebSocketInterface)
 SEND_SPECIALIZE(WebSocketInterface)
@@ -26,6 +26,7 @@ extern "C" {
 #include "crypto/base64.hpp"
 #include "crypto/sha1.h"
 #include "kserver.hpp"
+#include "kserver_metrics.hpp"
 
 namespace kserver {
 
@@ -47,11 +48,44 @@ void WebSocket::set_id(int comm_fd_)
     comm_fd = comm_fd_;
 }
 
+/// Request line of the metrics, followed by ' ' or '?'
+static const std::string MetricsRequest("GET " KSERVER_METRICS_PATH);
+
+static bool __is_metrics_request(const char *request, size_t len)
+{
+    return len > MetricsRequest.length()
+           && MetricsRequest.compare(0, MetricsRequest.length(), 
+                                     request, MetricsRequest.length()) == 0
+           && (request[MetricsRequest.length()] == ' ' 
+               || request[MetricsRequest.length()] == '?');
+}
+
+bool WebSocket::is_metrics_request(int comm_fd_)
+{
+    char request[32];
+    size_t len = MetricsRequest.length() + 1;
+    
+    // Any HTTP request is longer: wait for the whole prefix
+    ssize_t bytes = recv(comm_fd_, request, len, MSG_PEEK | MSG_WAITALL);
+    
+    return bytes == static_cast<ssize_t>(len)
+           && __is_metrics_request(request, len);
+}
+
 int WebSocket::authenticate()
 {
     if(read_http_packet() < 0) {
         return -1;
     }
+    
+    // Plain HTTP request for the server metrics
+    if(__is_metrics_request(http_packet.c_str(), http_packet.length())) {
+        if(send_metrics() < 0) {
+            return -1;
+        }
+        
+        return 1;
+    }
 
     static const std::string WSKeyIdentifier("Sec-WebSocket-Key: ");
     static const std::string WSProtocolIdentifier("Sec-WebSocket-Protocol: ");
@@ -103,6 +137,27 @@ int WebSocket::authenticate()
     return 0;
 }
 
+int WebSocket::send_metrics()
+{
+    std::string metrics = get_metrics(kserver);
+    
+    std::ostringstream oss;
+    oss << "HTTP/1.1 200 OK\r\n";
+    oss << "Content-Type: text/plain; version=0.0.4\r\n";
+    oss << "Content-Length: " << metrics.length() << "\r\n";
+    oss << "Connection: close\r\n";
+    oss << "\r\n";
+    oss << metrics;
+    
+    if(send_request(oss.str()) < 0) {
+        return -1;
+    }
+    
+    kserver->syslog.print(SysLog::DEBUG, "[S] HTTP metrics\n");
+    
+    return 0;
+}
+
 int WebSocket::read_http_packet()
 {
     reset_read_buff();
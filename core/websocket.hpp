@@ -70,8 +70,16 @@ class WebSocket
     
     void set_id(int comm_fd_);
     
+    /// @brief Answer the HTTP opening request
+    /// @return 0 if the WebSocket connection is established,
+    ///         1 if a plain HTTP request (metrics) has been served,
+    ///         -1 on failure
     int authenticate();
     
+    /// @brief True if the HTTP request waiting on @comm_fd_ is a
+    ///        metrics request. The request is not consumed.
+    static bool is_metrics_request(int comm_fd_);
+    
     int receive();
     
     int send(const std::string& stream);
@@ -106,6 +114,7 @@ class WebSocket
     
     // Internal functions
     int read_http_packet();
+    int send_metrics();
     int decode_raw_stream();
     int read_stream();
     int read_header();
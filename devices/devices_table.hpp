@@ -9,25 +9,28 @@
 #include <array>
 
 #define DEVICES_TABLE(ENTRY)    \
-  ENTRY(DEV_MEM, KS_Dev_mem, "OPEN", "ADD_MEMORY_MAP", "RM_MEMORY_MAP", "READ", "WRITE", "WRITE_BUFFER", "READ_BUFFER", "SET_BIT", "CLEAR_BIT", "TOGGLE_BIT", "MASK_AND", "MASK_OR")
+  ENTRY(DEV_MEM, KS_Dev_mem, "OPEN", "ADD_MEMORY_MAP", "RM_MEMORY_MAP", "READ", "WRITE", "WRITE_BUFFER", "READ_BUFFER", "SET_BIT", "CLEAR_BIT", "TOGGLE_BIT", "MASK_AND", "MASK_OR", "READ_REGS", "WRITE_REGS", "LOAD_PROGRAM", "RUN_PROGRAM", "WAIT_BIT", "WAIT_VALUE", "SET_ACCESS", "ADD_SNAPSHOT", "RM_SNAPSHOT", "ACQUIRE_SNAPSHOT", "READ_SNAPSHOT", "ADD_MEMORY_MAP_FLAGS", "WAIT_IRQ", "PSD", "DECIMATE", "AVERAGE", "SET_CONVERSION", "READ_CONVERTED") \
+  ENTRY(SIM_FPGA, KS_Sim_fpga, "START", "STOP", "GET_STATUS")
 
 /// Maximum number of operations
-#define MAX_OP_NUM 12
+#define MAX_OP_NUM 30
 
 /// Devices #
 typedef enum {
     NO_DEVICE,
     KSERVER,
     DEV_MEM,
+    SIM_FPGA,
     device_num
 } device_t;
 
 /// String descriptions of the devices and their related operations
 static const std::array< std::array< std::string, MAX_OP_NUM+1 >, device_num >
 device_desc = {{
-  {{"NO_DEVICE", "", "", "", "", "", "", "", "", "", "", "", ""}},
-  {{"KSERVER", "GET_ID", "GET_CMDS","GET_STATS", "GET_DEV_STATUS", "GET_RUNNING_SESSIONS", "KILL_SESSION" , "GET_SESSION_PERFS", "", "", "", "", ""}},
-  {{"DEV_MEM", "OPEN", "ADD_MEMORY_MAP", "RM_MEMORY_MAP", "READ", "WRITE", "WRITE_BUFFER", "READ_BUFFER", "SET_BIT", "CLEAR_BIT", "TOGGLE_BIT", "MASK_AND", "MASK_OR"}},
+  {{"NO_DEVICE", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", ""}},
+  {{"KSERVER", "GET_ID", "GET_CMDS", "GET_STATS", "GET_DEV_STATUS", "GET_RUNNING_SESSIONS", "KILL_SESSION", "GET_SESSION_PERFS", "GET_OPS_PERFS", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", ""}},
+  {{"DEV_MEM", "OPEN", "ADD_MEMORY_MAP", "RM_MEMORY_MAP", "READ", "WRITE", "WRITE_BUFFER", "READ_BUFFER", "SET_BIT", "CLEAR_BIT", "TOGGLE_BIT", "MASK_AND", "MASK_OR", "READ_REGS", "WRITE_REGS", "LOAD_PROGRAM", "RUN_PROGRAM", "WAIT_BIT", "WAIT_VALUE", "SET_ACCESS", "ADD_SNAPSHOT", "RM_SNAPSHOT", "ACQUIRE_SNAPSHOT", "READ_SNAPSHOT", "ADD_MEMORY_MAP_FLAGS", "WAIT_IRQ", "PSD", "DECIMATE", "AVERAGE", "SET_CONVERSION", "READ_CONVERTED"}},
+  {{"SIM_FPGA", "START", "STOP", "GET_STATUS", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", "", ""}},
 }};
 
 #endif // __DEVICES_TABLE_HPP__
@@ -5,89 +5,178 @@
 
 #include "ks_dev_mem.hpp"
 
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+#include <signal/kfft.hpp>
+#include <signal/kaccumulator.hpp>
+
 #include "../core/commands.hpp"
 #include "../core/kserver.hpp"
 #include "../core/kserver_session.hpp"
+#include "../core/args_parser.hpp"
 
 namespace kserver {
 
 #define THIS (static_cast<KS_Dev_mem*>(this))
 
-/////////////////////////////////////
-// OPEN
+#if KSERVER_HAS_THREADS
+#  define LOCK_MMAP(mmap_idx) \
+    std::lock_guard<std::mutex> lock(THIS->mmap_mutex(mmap_idx));
+#  define LOCK_MMAPS(mmaps_mask)   THIS->lock_mmaps(mmaps_mask);
+#  define UNLOCK_MMAPS(mmaps_mask) THIS->unlock_mmaps(mmaps_mask);
+// Release the device lock before sending data
+// which don't depend on the device anymore
+#  define RELEASE_DEVICE_LOCK      SharedLockGuard::release();
+// Take back the device lock released during a wait
+#  define ACQUIRE_DEVICE_LOCK      SharedLockGuard::reacquire();
+#else
+#  define LOCK_MMAP(mmap_idx)
+#  define LOCK_MMAPS(mmaps_mask)
+#  define UNLOCK_MMAPS(mmaps_mask)
+#  define RELEASE_DEVICE_LOCK
+#  define ACQUIRE_DEVICE_LOCK
+#endif
+
+/// Base address of the memory map of the operation,
+/// the operation fails if the memory map doesn't exist
+#define GET_BASE_ADDR(op_name)                                              \
+    intptr_t base_addr = THIS->dev_mem.GetBaseAddr(args.mmap_idx);          \
+                                                                            \
+    if(base_addr == 0) {                                                    \
+        kserver->syslog.print(SysLog::ERROR,                                \
+                              op_name ": Invalid memory map %u\n",          \
+                              args.mmap_idx);                               \
+        return -1;                                                          \
+    }
 
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::OPEN> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::OPEN>& args)
+/// @brief Let the exclusive operations run in between two slices of a wait
+/// @return The base address of the memory map, which may have been
+///         remapped meanwhile, or 0 if it has been removed
+static intptr_t yield_device(Klib::DevMem& dev_mem, Klib::MemMapID mmap_idx)
 {
-    return 0;
+    RELEASE_DEVICE_LOCK
+    ACQUIRE_DEVICE_LOCK
+    return dev_mem.GetBaseAddr(mmap_idx);
 }
 
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::OPEN> 
-        (const Argument<KS_Dev_mem::OPEN>& args, SessID sess_id)
+void KS_Dev_mem::rm_snapshots(Klib::MemMapID mmap_idx)
 {
-    return 0;
+    for(auto it = snapshots.begin(); it != snapshots.end(); ) {
+        if(it->second.mmap_idx == mmap_idx)
+            it = snapshots.erase(it);
+        else
+            ++it;
+    }
 }
 
-/////////////////////////////////////
-// ADD_MEMORY_MAP
+void KS_Dev_mem::DecimStream::reset(uint32_t filter_, uint32_t decim_)
+{
+    if(filter_ == filter && decim_ == decim) {
+        if(average) average->Reset();
+        if(cic) cic->Reset();
+        if(fir) fir->Reset();
+        return;
+    }
 
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::ADD_MEMORY_MAP> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::ADD_MEMORY_MAP>& args)
+    average.reset();
+    cic.reset();
+    fir.reset();
+
+    switch(filter_) {
+      case DECIM_AVERAGE:
+        average.reset(new Klib::KMovingAverage<float>(decim_, decim_));
+        break;
+      case DECIM_CIC:
+        cic.reset(new Klib::KCicDecimator<float>(KS_DEV_MEM_CIC_ORDER, decim_));
+        break;
+      default:
+        fir.reset(new Klib::KFirDecimator<float>(
+                          Klib::KDecimationTaps<float>(decim_), decim_));
+        break;
+    }
+
+    filter = filter_;
+    decim = decim_;
+}
+
+/// Convert @n registers of format KS_Dev_mem::SampleFormat to floats
+static void samples_to_float(const uint32_t *regs, uint32_t n,
+                             uint32_t format, float *samples)
+{
+    switch(format) {
+      case KS_Dev_mem::SAMPLES_INT32:
+        for(uint32_t i=0; i<n; i++)
+            samples[i] = static_cast<int32_t>(regs[i]);
+        break;
+      case KS_Dev_mem::SAMPLES_UINT32:
+        for(uint32_t i=0; i<n; i++)
+            samples[i] = regs[i];
+        break;
+      default:
+        memcpy(samples, regs, n * sizeof(float));
+        break;
+    }
+}
+
+/// @brief Average the traces of AVERAGE
+/// @acquire Copies the next trace into @regs, returns false on timeout
+/// @reply Status, number of traces, mean and envelopes
+template<typename T, typename Acquire>
+static void average_traces(Acquire acquire, uint32_t traces_num, 
+                           uint32_t buff_size, bool envelopes, 
+                           uint32_t *regs, std::vector<uint32_t>& reply)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    static_assert(sizeof(T) == sizeof(uint32_t), "Samples of 32 bits");
+
+    static thread_local std::vector<T> trace;
+    static thread_local std::vector<float> mean;
+    Klib::KTraceAccumulator<T> acc(buff_size, envelopes);
+    uint32_t status = 0;
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    if(trace.size() < buff_size) {
+        trace.resize(buff_size);
+        mean.resize(buff_size);
+    }
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
+    for(uint32_t i=0; i<traces_num; i++) {
+        if(!acquire(regs)) {
+            status = 1;
             break;
         }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.device_addr = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 1: {
-                  args.map_size = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+        memcpy(trace.data(), regs, buff_size * sizeof(T));
+        acc.Add(trace.data());
     }
 
-    if(param_num == 0 || param_num > 2) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
-        return -1;
+    reply.assign(2 + buff_size * (envelopes ? 3 : 1), 0);
+    reply[0] = status;
+    reply[1] = acc.TracesNum();
+    acc.Mean(mean.data());
+    memcpy(&reply[2], mean.data(), buff_size * sizeof(float));
+
+    if(envelopes && acc.TracesNum() > 0) {
+        memcpy(&reply[2 + buff_size], acc.Min(), buff_size * sizeof(T));
+        memcpy(&reply[2 + 2 * buff_size], acc.Max(), buff_size * sizeof(T));
     }
+}
 
+/////////////////////////////////////
+// OPEN
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::OPEN> 
+        (const Argument<KS_Dev_mem::OPEN>& args, SessID sess_id)
+{
     return 0;
 }
 
+/////////////////////////////////////
+// ADD_MEMORY_MAP
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
@@ -95,9 +184,10 @@ int KDevice<KS_Dev_mem,DEV_MEM>::
         (const Argument<KS_Dev_mem::ADD_MEMORY_MAP>& args, SessID sess_id)
 {
     Klib::MemMapID map_id = THIS->dev_mem.AddMemoryMap(args.device_addr, 
-                                                       args.map_size);
+                                                       args.map_size, 0,
+                                                       sess_id);
     
-    if(static_cast<int>(map_id) < 0) {
+    if(map_id == MEMMAP_INVALID_ID) {
         if(SEND_CSTR("ERR\n") < 0) {
             return -1;
         }
@@ -112,7 +202,7 @@ int KDevice<KS_Dev_mem,DEV_MEM>::
                               static_cast<uint32_t>(map_id));
     }
     
-    return static_cast<int>(map_id);
+    return map_id == MEMMAP_INVALID_ID ? -1 : 0;
 }
 
 /////////////////////////////////////
@@ -121,682 +211,1284 @@ int KDevice<KS_Dev_mem,DEV_MEM>::
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::RM_MEMORY_MAP> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::RM_MEMORY_MAP>& args)
+        execute_op<KS_Dev_mem::RM_MEMORY_MAP> 
+        (const Argument<KS_Dev_mem::RM_MEMORY_MAP>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    if(THIS->dev_mem.RmMemoryMap(args.mmap_idx, sess_id) < 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "RM_MEMORY_MAP: Memory map %u not added "
+                              "by the session\n", args.mmap_idx);
+        return -1;
+    }
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    // Released by all the sessions
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx))
+        THIS->rm_snapshots(args.mmap_idx);
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
+    return 0;
+}
 
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-            }
+/////////////////////////////////////
+// ADD_MEMORY_MAP_FLAGS
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS> 
+        (const Argument<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS>& args, 
+         SessID sess_id)
+{
+    if((args.flags & ~MEMMAP_FLAGS_MASK) != 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "ADD_MEMORY_MAP_FLAGS: Invalid flags 0x%x\n",
+                              args.flags);
+        return -1;
     }
 
-    if(param_num == 0 || param_num > 1) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    Klib::MemMapID map_id = THIS->dev_mem.AddMemoryMap(args.device_addr, 
+                                                       args.map_size, 
+                                                       args.flags, sess_id);
+
+    // Reply: map ID, or -1 if failure
+    if(SEND<uint32_t>(static_cast<uint32_t>(map_id)) < 0) {
         return -1;
     }
 
-    return 0;
+    kserver->syslog.print(SysLog::DEBUG, "[S] %u\n", 
+                          static_cast<uint32_t>(map_id));
+
+    return map_id == MEMMAP_INVALID_ID ? -1 : 0;
 }
 
+/////////////////////////////////////
+// READ
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::RM_MEMORY_MAP> 
-        (const Argument<KS_Dev_mem::RM_MEMORY_MAP>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::READ> 
+        (const Argument<KS_Dev_mem::READ>& args, SessID sess_id)
 {
-    THIS->dev_mem.RmMemoryMap(args.mmap_idx);
+    GET_BASE_ADDR("READ")
+    uint32_t reg_val = Klib::ReadReg32(base_addr + args.offset);
+
+    if(SEND<uint32_t>(reg_val) < 0) {
+        return -1;
+    }
+        
+    kserver->syslog.print(SysLog::DEBUG, "[S] %u\n", reg_val);
+
     return 0;
 }
 
 /////////////////////////////////////
-// READ
+// WRITE
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::READ> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::READ>& args)
+        execute_op<KS_Dev_mem::WRITE> 
+        (const Argument<KS_Dev_mem::WRITE>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    GET_BASE_ADDR("WRITE")
+    Klib::WriteReg32(base_addr + args.offset, args.reg_val);
+    return 0;
+}
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+/////////////////////////////////////
+// WRITE_BUFFER
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::WRITE_BUFFER> 
+        (const Argument<KS_Dev_mem::WRITE_BUFFER>& args, SessID sess_id)
+{
+    const uint32_t* data_ptr = RCV_HANDSHAKE(args.len_data);
+    
+    if(data_ptr == nullptr) {
+        return -1;
+    }
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WRITE_BUFFER: Invalid memory map %u\n",
+                              args.mmap_idx);
+        return -1;
     }
 
-    if(param_num == 0 || param_num > 2) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    if(!THIS->check_range(args.mmap_idx, args.offset, args.len_data)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WRITE_BUFFER: Buffer outside the map\n");
         return -1;
     }
 
+    Klib::DevMem& dev_mem = THIS->dev_mem;
+    Klib::WriteBuff(dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, data_ptr,
+                    args.len_data, dev_mem.GetAccess(args.mmap_idx));
+    
     return 0;
 }
 
+/////////////////////////////////////
+// READ_BUFFER
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::READ> 
-        (const Argument<KS_Dev_mem::READ>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::READ_BUFFER> 
+        (const Argument<KS_Dev_mem::READ_BUFFER>& args, SessID sess_id)
 {
-    uint32_t reg_val = Klib::ReadReg32(THIS->dev_mem.GetBaseAddr(args.mmap_idx) 
-                                       + args.offset);
+    // The registers are copied with the access mode of the memory map
+    // before sending, the socket doesn't access the device memory.
+    static thread_local std::vector<uint32_t> buffer;
+
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_BUFFER: Invalid memory map %u\n",
+                              args.mmap_idx);
+        return -1;
+    }
 
-    if(SEND<uint32_t>(reg_val) < 0) {
+    Klib::DevMem& dev_mem = THIS->dev_mem;
+
+    if(!THIS->check_range(args.mmap_idx, args.offset, args.buff_size)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_BUFFER: Buffer outside the map\n");
         return -1;
     }
-        
-    kserver->syslog.print(SysLog::DEBUG, "[S] %u\n", reg_val);
 
+    if(buffer.size() < args.buff_size)
+        buffer.resize(args.buff_size);
+
+    Klib::ReadBuff(dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
+                   buffer.data(), args.buff_size, 
+                   dev_mem.GetAccess(args.mmap_idx));
+
+    RELEASE_DEVICE_LOCK
+    int n_bytes_send = SEND_ARRAY<uint32_t>(buffer.data(), args.buff_size);
+
+    if(n_bytes_send < 0) {
+        return -1;
+    }
+    
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
+    
     return 0;
 }
 
 /////////////////////////////////////
-// WRITE
+// SET_BIT
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::SET_BIT> 
+        (const Argument<KS_Dev_mem::SET_BIT>& args, SessID sess_id)
+{
+    GET_BASE_ADDR("SET_BIT")
+    LOCK_MMAP(args.mmap_idx)
+    Klib::SetBit(base_addr + args.offset, args.index);
+    return 0;
+}
+
+/////////////////////////////////////
+// CLEAR_BIT
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::WRITE> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::WRITE>& args)
+        execute_op<KS_Dev_mem::CLEAR_BIT> 
+        (const Argument<KS_Dev_mem::CLEAR_BIT>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    GET_BASE_ADDR("CLEAR_BIT")
+    LOCK_MMAP(args.mmap_idx)
+    Klib::ClearBit(base_addr + args.offset, args.index);
+    return 0;
+}
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+/////////////////////////////////////
+// TOGGLE_BIT
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.reg_val = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::TOGGLE_BIT> 
+        (const Argument<KS_Dev_mem::TOGGLE_BIT>& args, SessID sess_id)
+{
+    GET_BASE_ADDR("TOGGLE_BIT")
+    LOCK_MMAP(args.mmap_idx)
+    Klib::ToggleBit(base_addr + args.offset, args.index);
+    return 0;
+}
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+/////////////////////////////////////
+// MASK_AND
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::MASK_AND> 
+        (const Argument<KS_Dev_mem::MASK_AND>& args, SessID sess_id)
+{
+    GET_BASE_ADDR("MASK_AND")
+    LOCK_MMAP(args.mmap_idx)
+    Klib::MaskAnd(base_addr + args.offset, args.mask);
+    return 0;
+}
+
+/////////////////////////////////////
+// MASK_OR
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::MASK_OR> 
+        (const Argument<KS_Dev_mem::MASK_OR>& args, SessID sess_id)
+{
+    GET_BASE_ADDR("MASK_OR")
+    LOCK_MMAP(args.mmap_idx)
+    Klib::MaskOr(base_addr + args.offset, args.mask);
+    return 0;
+}
+
+/////////////////////////////////////
+// Registers batches
+
+/// @brief Resolve the addresses of a batch of registers
+/// @regs Registers description (mmap_idx, offset[, value])
+/// @regs_num Number of registers
+/// @stride Number of words describing a register
+/// @addrs Addresses of the registers
+/// @mmaps_mask Mask of the locks of the memory maps used
+/// @return -1 if success, else the index of the register
+///         with an invalid memory map or outside its memory map
+static int get_regs_addr(KS_Dev_mem *dev, const uint32_t *regs, 
+                         unsigned int regs_num, unsigned int stride,
+                         std::vector<intptr_t>& addrs, uint32_t& mmaps_mask)
+{
+    addrs.resize(regs_num);
+    mmaps_mask = 0;
+
+    for(unsigned int i=0; i<regs_num; i++) {
+        Klib::MemMapID mmap_idx = regs[stride*i];
+
+        if(!dev->check_range(mmap_idx, regs[stride*i + 1], 1))
+            return i;
+
+        addrs[i] = dev->dev_mem.GetBaseAddr(mmap_idx) + regs[stride*i + 1];
+        mmaps_mask |= KS_Dev_mem::mmap_lock_mask(mmap_idx);
+    }
+
+    return -1;
+}
+
+/////////////////////////////////////
+// READ_REGS
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::READ_REGS> 
+        (const Argument<KS_Dev_mem::READ_REGS>& args, SessID sess_id)
+{
+    if(args.regs_num == 0 || args.regs_num > KS_DEV_MEM_MAX_REGS) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_REGS: Invalid number of registers %u\n", 
+                              args.regs_num);
+        return -1;
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    const uint32_t* regs = RCV_HANDSHAKE(2 * args.regs_num);
+
+    if(regs == nullptr) {
+        return -1;
+    }
+
+    std::vector<intptr_t> addrs;
+    uint32_t mmaps_mask;
+    int invalid_reg = get_regs_addr(THIS, regs, args.regs_num, 2,
+                                    addrs, mmaps_mask);
+
+    if(invalid_reg >= 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_REGS: Invalid register %u:0x%x (register #%i)\n",
+                              regs[2 * invalid_reg], regs[2 * invalid_reg + 1],
+                              invalid_reg);
         return -1;
     }
 
+    std::vector<uint32_t> values(args.regs_num);
+
+    LOCK_MMAPS(mmaps_mask)
+
+    for(unsigned int i=0; i<args.regs_num; i++)
+        values[i] = Klib::ReadReg32(addrs[i]);
+
+    UNLOCK_MMAPS(mmaps_mask)
+
+    int n_bytes_send = SEND_ARRAY<uint32_t>(values.data(), args.regs_num);
+
+    if(n_bytes_send < 0) {
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
+
     return 0;
 }
 
+/////////////////////////////////////
+// WRITE_REGS
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::WRITE> 
-        (const Argument<KS_Dev_mem::WRITE>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::WRITE_REGS> 
+        (const Argument<KS_Dev_mem::WRITE_REGS>& args, SessID sess_id)
 {
-    Klib::WriteReg32(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                     args.reg_val);
+    if(args.regs_num == 0 || args.regs_num > KS_DEV_MEM_MAX_REGS) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WRITE_REGS: Invalid number of registers %u\n", 
+                              args.regs_num);
+        return -1;
+    }
+
+    const uint32_t* regs = RCV_HANDSHAKE(3 * args.regs_num);
+
+    if(regs == nullptr) {
+        return -1;
+    }
+
+    // All the addresses are checked before writing:
+    // an invalid batch leaves the registers untouched.
+    std::vector<intptr_t> addrs;
+    uint32_t mmaps_mask;
+    int invalid_reg = get_regs_addr(THIS, regs, args.regs_num, 3,
+                                    addrs, mmaps_mask);
+
+    if(invalid_reg >= 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WRITE_REGS: Invalid register %u:0x%x (register #%i)\n",
+                              regs[3 * invalid_reg], regs[3 * invalid_reg + 1],
+                              invalid_reg);
+        return -1;
+    }
+
+    LOCK_MMAPS(mmaps_mask)
+
+    for(unsigned int i=0; i<args.regs_num; i++)
+        Klib::WriteReg32(addrs[i], regs[3*i + 2]);
+
+    UNLOCK_MMAPS(mmaps_mask)
+
     return 0;
 }
 
 /////////////////////////////////////
-// WRITE_BUFFER
+// LOAD_PROGRAM
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::WRITE_BUFFER> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::WRITE_BUFFER>& args)
+        execute_op<KS_Dev_mem::LOAD_PROGRAM> 
+        (const Argument<KS_Dev_mem::LOAD_PROGRAM>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    if(args.len_code == 0 || args.len_code > REG_PROGRAM_MAX_LEN) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "LOAD_PROGRAM: Invalid program length %u\n", 
+                              args.len_code);
+        return -1;
+    }
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    const uint32_t* code = RCV_HANDSHAKE(args.len_code);
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.len_data = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+    if(code == nullptr) {
+        return -1;
+    }
+
+    auto& programs = THIS->programs;
+
+    if(programs.size() >= KS_DEV_MEM_MAX_PROGRAMS 
+       && programs.find(args.prog_id) == programs.end()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "LOAD_PROGRAM: Too many programs\n");
+        return -1;
+    }
+
+    std::shared_ptr<Klib::RegProgram> program(new Klib::RegProgram());
+    int rejected_word = program->Load(code, args.len_code);
+
+    // Reply 0 if the program is loaded,
+    // else the position of the rejected word
+    if(SEND<uint32_t>(static_cast<uint32_t>(rejected_word + 1)) < 0) {
+        return -1;
+    }
+
+    if(rejected_word >= 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "LOAD_PROGRAM: Invalid bytecode at word %i\n", 
+                              rejected_word);
+        return -1;
+    }
+
+    programs[args.prog_id] = std::move(program);
+    return 0;
+}
+
+/////////////////////////////////////
+// RUN_PROGRAM
+
+#if KSERVER_HAS_THREADS
+/// Locks of the memory maps for the programs
+struct MmapLocker : public Klib::RegLocker
+{
+    MmapLocker(KS_Dev_mem *dev_)
+    : dev(dev_)
+    {}
+
+    void lock(Klib::MemMapID mmap_idx)   {dev->mmap_mutex(mmap_idx).lock();}
+    void unlock(Klib::MemMapID mmap_idx) {dev->mmap_mutex(mmap_idx).unlock();}
+    void release()   {RELEASE_DEVICE_LOCK}
+    void reacquire() {ACQUIRE_DEVICE_LOCK}
+
+    KS_Dev_mem *dev;
+};
+#endif
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::RUN_PROGRAM> 
+        (const Argument<KS_Dev_mem::RUN_PROGRAM>& args, SessID sess_id)
+{
+    if(args.params_num > REG_PROGRAM_MAX_PARAMS) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "RUN_PROGRAM: Invalid number of parameters %u\n",
+                              args.params_num);
+        return -1;
+    }
+
+    const uint32_t* params = nullptr;
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
+    if(args.params_num > 0) {
+        params = RCV_HANDSHAKE(args.params_num);
+
+        if(params == nullptr) {
+            return -1;
         }
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    // Reply: status | number of values read | values read
+    std::vector<uint32_t> reply(2, 0);
+    auto it = THIS->programs.find(args.prog_id);
+
+    if(it == THIS->programs.end()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "RUN_PROGRAM: Unknown program %u\n", 
+                              args.prog_id);
+        reply[0] = Klib::REG_PROGRAM_INVALID;
+    } else {
+#if KSERVER_HAS_THREADS
+        MmapLocker locker(THIS);
+        Klib::RegLocker *locker_ptr = &locker;
+#else
+        Klib::RegLocker *locker_ptr = nullptr;
+#endif
+        // The program may be replaced while the device lock is released
+        std::shared_ptr<Klib::RegProgram> program = it->second;
+        reply[0] = program->Run(THIS->dev_mem, params, args.params_num,
+                                reply, locker_ptr);
+        reply[1] = reply.size() - 2;
+    }
+
+    RELEASE_DEVICE_LOCK
+
+    if(SEND_ARRAY<uint32_t>(reply.data(), reply.size()) < 0) {
         return -1;
     }
 
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u values]\n", reply[1]);
+
+    return reply[0] == Klib::REG_PROGRAM_OK ? 0 : -1;
+}
+
+/////////////////////////////////////
+// Waits
+
+/// @brief Send the result of a wait
+/// @duration Waiting duration in microseconds, or -1 if timeout
+/// @reg_val Last value read in the register
+///
+/// Reply: status (0 if done, 1 if timeout) | duration (us) | register value
+#define SEND_WAIT_RESULT(duration, reg_val)                                 \
+    {                                                                       \
+        uint32_t result[3];                                                 \
+        result[0] = (duration) < 0 ? 1 : 0;                                 \
+        result[1] = (duration) < 0 ? args.timeout_us                        \
+                                   : static_cast<uint32_t>(duration);       \
+        result[2] = reg_val;                                                \
+                                                                            \
+        if(SEND_ARRAY<uint32_t>(result, 3) < 0) {                           \
+            return -1;                                                      \
+        }                                                                   \
+                                                                            \
+        kserver->syslog.print(SysLog::DEBUG, "[S] %u %u %u\n",              \
+                              result[0], result[1], result[2]);             \
+    }
+
+/////////////////////////////////////
+// WAIT_BIT
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::WAIT_BIT> 
+        (const Argument<KS_Dev_mem::WAIT_BIT>& args, SessID sess_id)
+{
+    if(!THIS->check_range(args.mmap_idx, args.offset, 1) || args.index >= 32
+       || args.level > 1 || args.timeout_us > KS_DEV_MEM_MAX_WAIT) {
+        kserver->syslog.print(SysLog::ERROR, "WAIT_BIT: Invalid arguments\n");
+        return -1;
+    }
+
+    uint32_t mask = 1U << args.index;
+    uint32_t reg_val;
+    int64_t duration = Klib::PollReg32(
+            THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
+            [mask, &args](uint32_t val) {
+                return (val & mask) == (args.level << args.index);
+            }, args.timeout_us, reg_val, KS_DEV_MEM_WAIT_SLICE, [&]() {
+                intptr_t base_addr = yield_device(THIS->dev_mem, args.mmap_idx);
+                return base_addr == 0 ? 0 : base_addr + args.offset;
+            });
+
+    if(duration == -2) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WAIT_BIT: Memory map %u removed\n",
+                              args.mmap_idx);
+        return -1;
+    }
+
+    RELEASE_DEVICE_LOCK
+    SEND_WAIT_RESULT(duration, reg_val)
     return 0;
 }
 
+/////////////////////////////////////
+// WAIT_VALUE
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::WRITE_BUFFER> 
-        (const Argument<KS_Dev_mem::WRITE_BUFFER>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::WAIT_VALUE> 
+        (const Argument<KS_Dev_mem::WAIT_VALUE>& args, SessID sess_id)
 {
-    const uint32_t* data_ptr = RCV_HANDSHAKE(args.len_data);
-    
-    if(data_ptr == nullptr) {
+    if(!THIS->check_range(args.mmap_idx, args.offset, 1)
+       || args.condition >= KS_Dev_mem::wait_conditions_num
+       || args.timeout_us > KS_DEV_MEM_MAX_WAIT) {
+        kserver->syslog.print(SysLog::ERROR, "WAIT_VALUE: Invalid arguments\n");
         return -1;
     }
 
-    uint32_t base_add = THIS->dev_mem.GetBaseAddr(args.mmap_idx);
-    Klib::WriteBuff32(base_add + args.offset, data_ptr, args.len_data);
-    
+    intptr_t addr = THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset;
+    uint32_t mask = args.mask;
+    uint32_t ref = args.value & mask;
+
+    if(args.condition == KS_Dev_mem::WAIT_CHANGE)
+        ref = Klib::ReadReg32(addr) & mask;
+
+    bool equal = (args.condition == KS_Dev_mem::WAIT_EQUAL);
+    uint32_t reg_val;
+    int64_t duration = Klib::PollReg32(addr, [mask, ref, equal](uint32_t val) {
+        return ((val & mask) == ref) == equal;
+    }, args.timeout_us, reg_val, KS_DEV_MEM_WAIT_SLICE, [&]() {
+        intptr_t base_addr = yield_device(THIS->dev_mem, args.mmap_idx);
+        return base_addr == 0 ? 0 : base_addr + args.offset;
+    });
+
+    if(duration == -2) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WAIT_VALUE: Memory map %u removed\n",
+                              args.mmap_idx);
+        return -1;
+    }
+
+    RELEASE_DEVICE_LOCK
+    SEND_WAIT_RESULT(duration, reg_val)
     return 0;
 }
 
 /////////////////////////////////////
-// READ_BUFFER
+// WAIT_IRQ
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::READ_BUFFER> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::READ_BUFFER>& args)
+        execute_op<KS_Dev_mem::WAIT_IRQ> 
+        (const Argument<KS_Dev_mem::WAIT_IRQ>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    Klib::MemBackend *backend = THIS->dev_mem.GetBackend();
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    if(backend == nullptr || args.timeout_us > KS_DEV_MEM_MAX_WAIT) {
+        kserver->syslog.print(SysLog::ERROR, "WAIT_IRQ: Invalid arguments\n");
+        return -1;
+    }
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.buff_size = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+    // The backend is opened once at startup, it remains
+    // valid without the device lock
+    RELEASE_DEVICE_LOCK
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+    auto start = std::chrono::steady_clock::now();
+    int64_t count = backend->WaitInterrupt(args.timeout_us);
+
+    if(count < 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "WAIT_IRQ: No interrupt on backend %s\n",
+                              backend->Name());
+        return -1;
     }
 
-    if(param_num == 0 || param_num > 4) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    int64_t duration = count == 0 ? -1 :
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+    SEND_WAIT_RESULT(duration, static_cast<uint32_t>(count))
+    return 0;
+}
+
+/////////////////////////////////////
+// SET_ACCESS
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::SET_ACCESS> 
+        (const Argument<KS_Dev_mem::SET_ACCESS>& args, SessID sess_id)
+{
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx) 
+       || args.access >= Klib::access_modes_num) {
+        kserver->syslog.print(SysLog::ERROR, "SET_ACCESS: Invalid arguments\n");
         return -1;
     }
 
+    THIS->dev_mem.SetAccess(args.mmap_idx, args.access);
     return 0;
 }
 
+/////////////////////////////////////
+// ADD_SNAPSHOT
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::READ_BUFFER> 
-        (const Argument<KS_Dev_mem::READ_BUFFER>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::ADD_SNAPSHOT> 
+        (const Argument<KS_Dev_mem::ADD_SNAPSHOT>& args, SessID sess_id)
 {
-    int n_bytes_send = SEND_ARRAY<uint32_t>(
-            reinterpret_cast<uint32_t*>(THIS->dev_mem.GetBaseAddr(args.mmap_idx) 
-                                        + args.offset), args.buff_size);
-    
-    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
-    
+    auto& snapshots = THIS->snapshots;
+
+    if(args.buff_size == 0
+       || !THIS->check_range(args.mmap_idx, args.offset, args.buff_size)
+       || args.buffers_num < SNAPSHOT_MIN_BUFFERS 
+       || args.buffers_num > SNAPSHOT_MAX_BUFFERS) {
+        kserver->syslog.print(SysLog::ERROR, "ADD_SNAPSHOT: Invalid arguments\n");
+        return -1;
+    }
+
+    if(snapshots.size() >= KS_DEV_MEM_MAX_SNAPSHOTS 
+       && snapshots.find(args.snap_id) == snapshots.end()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "ADD_SNAPSHOT: Too many snapshots\n");
+        return -1;
+    }
+
+    std::shared_ptr<Klib::SnapshotPool> pool = 
+        std::make_shared<Klib::SnapshotPool>(args.buff_size, args.buffers_num);
+
+    if(!pool->IsValid()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "ADD_SNAPSHOT: Cannot allocate the buffers\n");
+        return -1;
+    }
+
+    // The sessions reading the previous snapshot keep their buffers
+    snapshots[args.snap_id] = {args.mmap_idx, args.offset, pool};
     return 0;
 }
 
 /////////////////////////////////////
-// SET_BIT
+// RM_SNAPSHOT
+
+template<>
+template<>
+int KDevice<KS_Dev_mem,DEV_MEM>::
+        execute_op<KS_Dev_mem::RM_SNAPSHOT> 
+        (const Argument<KS_Dev_mem::RM_SNAPSHOT>& args, SessID sess_id)
+{
+    THIS->snapshots.erase(args.snap_id);
+    return 0;
+}
+
+/// @brief Acquire a snapshot
+/// @return The sequence number, or 0 if no buffer is available
+///         or the memory map was released
+static uint32_t acquire_snapshot(KS_Dev_mem *dev, 
+                                 const KS_Dev_mem::SnapshotRegion& region)
+{
+    Klib::DevMem& dev_mem = dev->dev_mem;
+
+    if(!dev_mem.HasMemMap(region.mmap_idx))
+        return 0;
+
+    return region.pool->Acquire(dev_mem.GetBaseAddr(region.mmap_idx) 
+                                + region.offset,
+                                dev_mem.GetAccess(region.mmap_idx));
+}
+
+/////////////////////////////////////
+// ACQUIRE_SNAPSHOT
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::SET_BIT> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::SET_BIT>& args)
+        execute_op<KS_Dev_mem::ACQUIRE_SNAPSHOT> 
+        (const Argument<KS_Dev_mem::ACQUIRE_SNAPSHOT>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    auto it = THIS->snapshots.find(args.snap_id);
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
-
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.index = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
-
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+    if(it == THIS->snapshots.end()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "ACQUIRE_SNAPSHOT: Unknown snapshot %u\n",
+                              args.snap_id);
+        return -1;
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    uint32_t seq = acquire_snapshot(THIS, it->second);
+    RELEASE_DEVICE_LOCK
+
+    if(SEND<uint32_t>(seq) < 0) {
         return -1;
     }
 
-    return 0;
-}
-
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::SET_BIT> 
-        (const Argument<KS_Dev_mem::SET_BIT>& args, SessID sess_id)
-{
-    Klib::SetBit(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                 args.index);
+    kserver->syslog.print(SysLog::DEBUG, "[S] %u\n", seq);
     return 0;
 }
 
 /////////////////////////////////////
-// CLEAR_BIT
+// READ_SNAPSHOT
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::CLEAR_BIT> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::CLEAR_BIT>& args)
+        execute_op<KS_Dev_mem::READ_SNAPSHOT> 
+        (const Argument<KS_Dev_mem::READ_SNAPSHOT>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    auto it = THIS->snapshots.find(args.snap_id);
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    if(it == THIS->snapshots.end()) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_SNAPSHOT: Unknown snapshot %u\n",
+                              args.snap_id);
+        return -1;
+    }
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.index = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+    const KS_Dev_mem::SnapshotRegion& region = it->second;
+    std::shared_ptr<const Klib::Snapshot> snapshot = region.pool->Latest();
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+    // If all the buffers are being sent, the latest snapshot is sent
+    if(args.acquire || snapshot == nullptr) {
+        if(acquire_snapshot(THIS, region) > 0 || snapshot == nullptr)
+            snapshot = region.pool->Latest();
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    // The snapshot buffer is held until sent: neither 
+    // the acquisitions nor RM_SNAPSHOT can modify it.
+    RELEASE_DEVICE_LOCK
+
+    if(snapshot == nullptr) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_SNAPSHOT: No buffer available\n");
         return -1;
     }
 
-    return 0;
-}
+    int n_bytes_send = SEND_ARRAY<uint32_t>(snapshot->data, snapshot->size);
 
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::CLEAR_BIT> 
-        (const Argument<KS_Dev_mem::CLEAR_BIT>& args, SessID sess_id)
-{
-    Klib::ClearBit(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                   args.index);
+    if(n_bytes_send < 0) {
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
     return 0;
 }
 
 /////////////////////////////////////
-// TOGGLE_BIT
+// PSD
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::TOGGLE_BIT> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::TOGGLE_BIT>& args)
+        execute_op<KS_Dev_mem::PSD> 
+        (const Argument<KS_Dev_mem::PSD>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    // The samples are copied as with READ_BUFFER, the
+    // spectrum is computed after releasing the device lock.
+    static thread_local std::vector<uint32_t> buffer;
+    static thread_local std::vector<float> samples;
+    static thread_local std::vector<float> psd;
+    static thread_local std::unique_ptr< Klib::KWelch<float> > welch;
+
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "PSD: Invalid memory map %u\n",
+                              args.mmap_idx);
+        return -1;
+    }
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    if(args.format >= KS_Dev_mem::sample_formats_num
+       || args.window >= Klib::kwindows_num
+       || args.nfft < 4 || args.nfft > KS_DEV_MEM_MAX_NFFT
+       || !Klib::KIsPowerOf2(args.nfft) || args.buff_size < args.nfft
+       || args.decim == 0
+       || static_cast<uint64_t>(args.first_bin) + args.bins_num
+          > args.nfft / 2 + 1) {
+        kserver->syslog.print(SysLog::ERROR, "PSD: Invalid arguments\n");
+        return -1;
+    }
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.index = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+    Klib::DevMem& dev_mem = THIS->dev_mem;
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
-        }
+    if(!THIS->check_range(args.mmap_idx, args.offset, args.buff_size)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "PSD: Buffer outside the map\n");
+        return -1;
+    }
+
+    if(buffer.size() < args.buff_size)
+        buffer.resize(args.buff_size);
+
+    Klib::ReadBuff(dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
+                   buffer.data(), args.buff_size, 
+                   dev_mem.GetAccess(args.mmap_idx));
+
+    RELEASE_DEVICE_LOCK
+
+    if(samples.size() < args.buff_size)
+        samples.resize(args.buff_size);
+
+    samples_to_float(buffer.data(), args.buff_size, args.format, samples.data());
+
+    // The twiddles and the window are kept between
+    // two requests with the same parameters
+    if(welch == nullptr || welch->Nfft() != args.nfft 
+       || welch->Window() != args.window)
+        welch.reset(new Klib::KWelch<float>(args.nfft, 
+                            static_cast<Klib::kwindow_t>(args.window)));
+
+    psd.resize(welch->BinsNum());
+    welch->Compute(samples.data(), args.buff_size, psd.data());
+
+    // Band sent: bins_num bins from first_bin, averaged by decim
+    uint32_t band_size = args.bins_num == 0 ? psd.size() - args.first_bin
+                                            : args.bins_num;
+    uint32_t band_end = args.first_bin + band_size;
+    uint32_t res_size = (band_size + args.decim - 1) / args.decim;
+
+    for(uint32_t i=0; i<res_size; i++) {
+        uint32_t begin = args.first_bin + i * args.decim;
+        uint32_t end = std::min(begin + args.decim, band_end);
+        float sum = 0;
+
+        for(uint32_t k=begin; k<end; k++)
+            sum += psd[k];
+
+        psd[i] = sum / (end - begin); // i <= begin: in place
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    int n_bytes_send = SEND_ARRAY<float>(psd.data(), res_size);
+
+    if(n_bytes_send < 0) {
         return -1;
     }
 
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
     return 0;
 }
 
+/////////////////////////////////////
+// DECIMATE
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::TOGGLE_BIT> 
-        (const Argument<KS_Dev_mem::TOGGLE_BIT>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::DECIMATE> 
+        (const Argument<KS_Dev_mem::DECIMATE>& args, SessID sess_id)
 {
-    Klib::ToggleBit(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                    args.index);
+    // The samples are copied as with READ_BUFFER, and
+    // filtered after releasing the device lock.
+    static thread_local std::vector<uint32_t> buffer;
+    static thread_local std::vector<float> samples;
+    static thread_local std::vector<float> res;
+
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "DECIMATE: Invalid memory map %u\n",
+                              args.mmap_idx);
+        return -1;
+    }
+
+    if(args.stream_id >= KS_DEV_MEM_MAX_STREAMS
+       || args.format >= KS_Dev_mem::sample_formats_num
+       || args.filter >= KS_Dev_mem::decim_filters_num
+       || args.decim == 0 || args.decim > KS_DEV_MEM_MAX_DECIM
+       || args.buff_size % args.decim != 0
+       || (args.filter == KS_Dev_mem::DECIM_CIC 
+           && args.format == KS_Dev_mem::SAMPLES_FLOAT32)) {
+        kserver->syslog.print(SysLog::ERROR, "DECIMATE: Invalid arguments\n");
+        return -1;
+    }
+
+    Klib::DevMem& dev_mem = THIS->dev_mem;
+
+    if(!THIS->check_range(args.mmap_idx, args.offset, args.buff_size)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "DECIMATE: Buffer outside the map\n");
+        return -1;
+    }
+
+    if(buffer.size() < args.buff_size)
+        buffer.resize(args.buff_size);
+
+    Klib::ReadBuff(dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
+                   buffer.data(), args.buff_size, 
+                   dev_mem.GetAccess(args.mmap_idx));
+
+    RELEASE_DEVICE_LOCK
+
+    // The buffer size being a multiple of decim,
+    // each request gives buff_size / decim outputs
+    uint32_t res_size = args.buff_size / args.decim;
+
+    if(res.size() < res_size)
+        res.resize(res_size);
+
+    if(args.filter != KS_Dev_mem::DECIM_CIC) {
+        if(samples.size() < args.buff_size)
+            samples.resize(args.buff_size);
+
+        samples_to_float(buffer.data(), args.buff_size, 
+                         args.format, samples.data());
+    }
+
+    {
+        KS_Dev_mem::DecimStream& stream = THIS->decim_streams[args.stream_id];
+#if KSERVER_HAS_THREADS
+        std::lock_guard<std::mutex> lock(stream.mutex);
+#endif
+
+        if(args.restart || stream.filter != args.filter 
+           || stream.decim != args.decim)
+            stream.reset(args.filter, args.decim);
+
+        switch(args.filter) {
+          case KS_Dev_mem::DECIM_AVERAGE:
+            stream.average->Process(samples.data(), args.buff_size, res.data());
+            break;
+          case KS_Dev_mem::DECIM_CIC:
+            if(args.format == KS_Dev_mem::SAMPLES_INT32)
+                stream.cic->Process(
+                    reinterpret_cast<const int32_t*>(buffer.data()),
+                    args.buff_size, res.data());
+            else
+                stream.cic->Process(buffer.data(), args.buff_size, res.data());
+            break;
+          default:
+            stream.fir->Process(samples.data(), args.buff_size, res.data());
+            break;
+        }
+    }
+
+    int n_bytes_send = SEND_ARRAY<float>(res.data(), res_size);
+
+    if(n_bytes_send < 0) {
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
     return 0;
 }
 
 /////////////////////////////////////
-// MASK_AND
+// AVERAGE
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::MASK_AND> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::MASK_AND>& args)
+        execute_op<KS_Dev_mem::AVERAGE> 
+        (const Argument<KS_Dev_mem::AVERAGE>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    static thread_local std::vector<uint32_t> buffer;
+    static thread_local std::vector<uint32_t> reply;
+
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)
+       || args.format >= KS_Dev_mem::sample_formats_num
+       || args.buff_size == 0 || args.traces_num == 0
+       || args.traces_num > KS_DEV_MEM_MAX_TRACES
+       || args.trig_index > 32 || args.ready_index > 32
+       || args.trig_mode >= KS_Dev_mem::trig_modes_num
+       || args.timeout_us > KS_DEV_MEM_MAX_WAIT || args.envelopes > 1
+       || (args.ring_size != 0 && args.buff_size > args.ring_size)) {
+        kserver->syslog.print(SysLog::ERROR, "AVERAGE: Invalid arguments\n");
+        return -1;
+    }
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    Klib::DevMem& dev_mem = THIS->dev_mem;
+    uint64_t region_size = args.ring_size == 0 ? args.buff_size 
+                                               : args.ring_size;
+
+    if(!THIS->check_range(args.mmap_idx, args.offset, region_size)
+       || (args.trig_index < 32 
+           && !THIS->check_range(args.mmap_idx, args.trig_offset, 1))
+       || (args.ready_index < 32 
+           && !THIS->check_range(args.mmap_idx, args.ready_offset, 1))
+       || (args.ring_size != 0 
+           && !THIS->check_range(args.mmap_idx, args.start_offset, 1))) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "AVERAGE: Buffer outside the map\n");
+        return -1;
+    }
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.mask = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
+    if(buffer.size() < args.buff_size)
+        buffer.resize(args.buff_size);
+
+    intptr_t base_addr = dev_mem.GetBaseAddr(args.mmap_idx);
+    uint32_t access = dev_mem.GetAccess(args.mmap_idx);
+    auto deadline = std::chrono::steady_clock::now() 
+                    + std::chrono::microseconds(args.timeout_us);
+
+    // Time left before the deadline (us)
+    auto remaining_us = [&deadline]() -> uint32_t {
+        auto now = std::chrono::steady_clock::now();
+
+        if(now >= deadline)
+            return 0;
+
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                    deadline - now).count();
+    };
+
+    bool map_removed = false;
+
+    auto acquire = [&](uint32_t *dst) -> bool {
+        if(args.trig_index < 32) {
+            intptr_t trig_addr = base_addr + args.trig_offset;
+            LOCK_MMAP(args.mmap_idx)
+
+            switch(args.trig_mode) {
+              case KS_Dev_mem::TRIG_PULSE:
+                Klib::SetBit(trig_addr, args.trig_index);
+                Klib::ClearBit(trig_addr, args.trig_index);
+                break;
+              case KS_Dev_mem::TRIG_SET:
+                Klib::SetBit(trig_addr, args.trig_index);
+                break;
+              case KS_Dev_mem::TRIG_TOGGLE:
+                Klib::ToggleBit(trig_addr, args.trig_index);
+                break;
             }
+        }
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
+        // Rising edge of the ready bit: the previous trace
+        // is not taken twice if the bit is still set
+        if(args.ready_index < 32) {
+            uint32_t mask = 1U << args.ready_index;
+            uint32_t reg_val;
+
+            // The memory map may be remapped in between two slices
+            auto yield = [&]() -> intptr_t {
+                base_addr = yield_device(dev_mem, args.mmap_idx);
+                map_removed = (base_addr == 0);
+                return map_removed ? 0 : base_addr + args.ready_offset;
+            };
+
+            if(Klib::PollReg32(base_addr + args.ready_offset, 
+                               [mask](uint32_t val) {
+                    return (val & mask) == 0;
+                }, remaining_us(), reg_val, KS_DEV_MEM_WAIT_SLICE, yield) < 0
+               || Klib::PollReg32(base_addr + args.ready_offset, 
+                                  [mask](uint32_t val) {
+                    return (val & mask) != 0;
+                }, remaining_us(), reg_val, KS_DEV_MEM_WAIT_SLICE, yield) < 0)
+                return false;
         }
+
+        if(args.ring_size == 0) {
+            Klib::ReadBuff(base_addr + args.offset, dst, 
+                           args.buff_size, access);
+            return true;
+        }
+
+        // The trace starts at a sample of the ring and may wrap around
+        uint32_t start = Klib::ReadReg32(base_addr + args.start_offset)
+                         % args.ring_size;
+        uint32_t head = std::min(args.buff_size, args.ring_size - start);
+
+        Klib::ReadBuff(base_addr + args.offset + start * sizeof(uint32_t),
+                       dst, head, access);
+
+        if(head < args.buff_size)
+            Klib::ReadBuff(base_addr + args.offset, dst + head,
+                           args.buff_size - head, access);
+
+        return true;
+    };
+
+    switch(args.format) {
+      case KS_Dev_mem::SAMPLES_INT32:
+        average_traces<int32_t>(acquire, args.traces_num, args.buff_size,
+                                args.envelopes, buffer.data(), reply);
+        break;
+      case KS_Dev_mem::SAMPLES_UINT32:
+        average_traces<uint32_t>(acquire, args.traces_num, args.buff_size,
+                                 args.envelopes, buffer.data(), reply);
+        break;
+      default:
+        average_traces<float>(acquire, args.traces_num, args.buff_size,
+                              args.envelopes, buffer.data(), reply);
+        break;
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    if(map_removed) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "AVERAGE: Memory map %u removed\n",
+                              args.mmap_idx);
+        return -1;
+    }
+
+    RELEASE_DEVICE_LOCK
+    int n_bytes_send = SEND_ARRAY<uint32_t>(reply.data(), reply.size());
+
+    if(n_bytes_send < 0) {
         return -1;
     }
 
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
     return 0;
 }
 
+/////////////////////////////////////
+// SET_CONVERSION
+
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::MASK_AND> 
-        (const Argument<KS_Dev_mem::MASK_AND>& args, SessID sess_id)
+        execute_op<KS_Dev_mem::SET_CONVERSION> 
+        (const Argument<KS_Dev_mem::SET_CONVERSION>& args, SessID sess_id)
 {
-    Klib::MaskAnd(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                  args.mask);
+    if(args.conv_id >= KS_DEV_MEM_MAX_CONVERSIONS
+       || (args.format != KS_Dev_mem::SAMPLES_INT32 
+           && args.format != KS_Dev_mem::SAMPLES_UINT32)
+       || !Klib::KAdcConverter<float>::IsValid(args.bits, args.fields_per_word,
+                                               args.channels_num)
+       || args.channel >= args.channels_num) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "SET_CONVERSION: Invalid arguments\n");
+        return -1;
+    }
+
+    const bool is_signed = args.format == KS_Dev_mem::SAMPLES_INT32;
+    KS_Dev_mem::AdcConversion& conv = THIS->conversions[args.conv_id];
+
+#if KSERVER_HAS_THREADS
+    std::lock_guard<std::mutex> lock(conv.mutex);
+#endif
+
+    // A new format of the words resets the calibrations
+    if(!conv.converter 
+       || conv.converter->Bits() != args.bits
+       || conv.converter->IsSigned() != is_signed
+       || conv.converter->FieldsPerWord() != args.fields_per_word
+       || conv.converter->ChannelsNum() != args.channels_num)
+        conv.converter.reset(new Klib::KAdcConverter<float>(
+                                 args.bits, is_signed, args.fields_per_word,
+                                 args.channels_num));
+
+    conv.converter->SetCalibration(args.channel, args.offset, args.gain,
+                                   args.c2, args.c3);
     return 0;
 }
 
 /////////////////////////////////////
-// MASK_OR
+// READ_CONVERTED
 
 template<>
 template<>
 int KDevice<KS_Dev_mem,DEV_MEM>::
-        parse_arg<KS_Dev_mem::MASK_OR> (const Command& cmd,
-                KDevice<KS_Dev_mem,DEV_MEM>::
-                Argument<KS_Dev_mem::MASK_OR>& args)
+        execute_op<KS_Dev_mem::READ_CONVERTED> 
+        (const Argument<KS_Dev_mem::READ_CONVERTED>& args, SessID sess_id)
 {
-    char tmp_str[2*KSERVER_READ_STR_LEN];
+    // The registers are copied as with READ_BUFFER,
+    // and converted after releasing the device lock.
+    static thread_local std::vector<uint32_t> buffer;
+    static thread_local std::vector<float> res;
+
+    if(!THIS->dev_mem.HasMemMap(args.mmap_idx)
+       || args.conv_id >= KS_DEV_MEM_MAX_CONVERSIONS) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_CONVERTED: Invalid arguments\n");
+        return -1;
+    }
 
-    uint32_t i = 0;
-    uint32_t cnt = 0;
-    uint32_t param_num = 0;
+    Klib::DevMem& dev_mem = THIS->dev_mem;
 
-    while(1) {
-        if(cmd.buffer[i]=='\0') {
-            break;
-        }
-        else if(cmd.buffer[i]=='|') {
-            tmp_str[cnt] = '\0';
-
-            switch(param_num)
-            {
-              case 0: {
-                  args.mmap_idx = static_cast<Klib::MemMapID>(CSTRING_TO_UINT(tmp_str));
-                  break;
-              }
-              case 1: {
-                  args.offset = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-              case 2: {
-                  args.mask = CSTRING_TO_UINT(tmp_str);
-                  break;
-              }
-            }
+    if(!THIS->check_range(args.mmap_idx, args.offset, args.buff_size)) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "READ_CONVERTED: Buffer outside the map\n");
+        return -1;
+    }
 
-            param_num++;
-            cnt = 0;
-            i++;
-        } else {
-            tmp_str[cnt] = cmd.buffer[i];
-            i++;
-            cnt++;
+    if(buffer.size() < args.buff_size)
+        buffer.resize(args.buff_size);
+
+    Klib::ReadBuff(dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
+                   buffer.data(), args.buff_size, 
+                   dev_mem.GetAccess(args.mmap_idx));
+
+    RELEASE_DEVICE_LOCK
+
+    uint32_t res_size;
+
+    {
+        KS_Dev_mem::AdcConversion& conv = THIS->conversions[args.conv_id];
+#if KSERVER_HAS_THREADS
+        std::lock_guard<std::mutex> lock(conv.mutex);
+#endif
+
+        // All the channels have the same number of samples
+        if(!conv.converter 
+           || (static_cast<uint64_t>(args.buff_size) 
+               * conv.converter->FieldsPerWord()) 
+              % conv.converter->ChannelsNum() != 0) {
+            kserver->syslog.print(SysLog::ERROR, 
+                                  "READ_CONVERTED: Invalid conversion %u\n",
+                                  args.conv_id);
+            return -1;
         }
+
+        res_size = args.buff_size * conv.converter->FieldsPerWord();
+
+        if(res.size() < res_size)
+            res.resize(res_size);
+
+        conv.converter->Convert(buffer.data(), args.buff_size, res.data());
     }
 
-    if(param_num == 0 || param_num > 3) {
-        kserver->syslog.print(SysLog::ERROR, "Invalid number of parameters\n");
+    int n_bytes_send = SEND_ARRAY<float>(res.data(), res_size);
+
+    if(n_bytes_send < 0) {
         return -1;
     }
 
-    return 0;
-}
-
-template<>
-template<>
-int KDevice<KS_Dev_mem,DEV_MEM>::
-        execute_op<KS_Dev_mem::MASK_OR> 
-        (const Argument<KS_Dev_mem::MASK_OR>& args, SessID sess_id)
-{
-    Klib::MaskOr(THIS->dev_mem.GetBaseAddr(args.mmap_idx) + args.offset, 
-                  args.mask);
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", n_bytes_send);
     return 0;
 }
 
@@ -933,6 +1625,186 @@ int KDevice<KS_Dev_mem,DEV_MEM>::
         err = execute_op<KS_Dev_mem::MASK_OR>(args, cmd.sess_id);
         return err;
       }
+      case KS_Dev_mem::READ_REGS: {
+        Argument<KS_Dev_mem::READ_REGS> args;
+
+        if(parse_arg<KS_Dev_mem::READ_REGS>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::READ_REGS>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::WRITE_REGS: {
+        Argument<KS_Dev_mem::WRITE_REGS> args;
+
+        if(parse_arg<KS_Dev_mem::WRITE_REGS>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::WRITE_REGS>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::LOAD_PROGRAM: {
+        Argument<KS_Dev_mem::LOAD_PROGRAM> args;
+
+        if(parse_arg<KS_Dev_mem::LOAD_PROGRAM>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::LOAD_PROGRAM>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::RUN_PROGRAM: {
+        Argument<KS_Dev_mem::RUN_PROGRAM> args;
+
+        if(parse_arg<KS_Dev_mem::RUN_PROGRAM>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::RUN_PROGRAM>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::WAIT_BIT: {
+        Argument<KS_Dev_mem::WAIT_BIT> args;
+
+        if(parse_arg<KS_Dev_mem::WAIT_BIT>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::WAIT_BIT>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::WAIT_VALUE: {
+        Argument<KS_Dev_mem::WAIT_VALUE> args;
+
+        if(parse_arg<KS_Dev_mem::WAIT_VALUE>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::WAIT_VALUE>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::WAIT_IRQ: {
+        Argument<KS_Dev_mem::WAIT_IRQ> args;
+
+        if(parse_arg<KS_Dev_mem::WAIT_IRQ>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::WAIT_IRQ>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::SET_ACCESS: {
+        Argument<KS_Dev_mem::SET_ACCESS> args;
+
+        if(parse_arg<KS_Dev_mem::SET_ACCESS>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::SET_ACCESS>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::ADD_SNAPSHOT: {
+        Argument<KS_Dev_mem::ADD_SNAPSHOT> args;
+
+        if(parse_arg<KS_Dev_mem::ADD_SNAPSHOT>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::ADD_SNAPSHOT>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::RM_SNAPSHOT: {
+        Argument<KS_Dev_mem::RM_SNAPSHOT> args;
+
+        if(parse_arg<KS_Dev_mem::RM_SNAPSHOT>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::RM_SNAPSHOT>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::ACQUIRE_SNAPSHOT: {
+        Argument<KS_Dev_mem::ACQUIRE_SNAPSHOT> args;
+
+        if(parse_arg<KS_Dev_mem::ACQUIRE_SNAPSHOT>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::ACQUIRE_SNAPSHOT>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::READ_SNAPSHOT: {
+        Argument<KS_Dev_mem::READ_SNAPSHOT> args;
+
+        if(parse_arg<KS_Dev_mem::READ_SNAPSHOT>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::READ_SNAPSHOT>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::ADD_MEMORY_MAP_FLAGS: {
+        Argument<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS> args;
+
+        if(parse_arg<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::PSD: {
+        Argument<KS_Dev_mem::PSD> args;
+
+        if(parse_arg<KS_Dev_mem::PSD>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::PSD>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::DECIMATE: {
+        Argument<KS_Dev_mem::DECIMATE> args;
+
+        if(parse_arg<KS_Dev_mem::DECIMATE>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::DECIMATE>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::AVERAGE: {
+        Argument<KS_Dev_mem::AVERAGE> args;
+
+        if(parse_arg<KS_Dev_mem::AVERAGE>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::AVERAGE>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::SET_CONVERSION: {
+        Argument<KS_Dev_mem::SET_CONVERSION> args;
+
+        if(parse_arg<KS_Dev_mem::SET_CONVERSION>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::SET_CONVERSION>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Dev_mem::READ_CONVERTED: {
+        Argument<KS_Dev_mem::READ_CONVERTED> args;
+
+        if(parse_arg<KS_Dev_mem::READ_CONVERTED>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Dev_mem::READ_CONVERTED>(args, cmd.sess_id);
+        return err;
+      }
       case KS_Dev_mem::dev_mem_op_num:
       default:
           kserver->syslog.print(SysLog::ERROR, "KS_Dev_mem: Unknown operation\n");
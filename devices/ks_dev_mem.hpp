@@ -5,8 +5,18 @@
 #ifndef __KS_DEV_MEM_HPP__
 #define __KS_DEV_MEM_HPP__
 
+#include <map>
+#include <memory>
+
 #include <drivers/core/wr_register.hpp>
 #include <drivers/core/dev_mem.hpp>
+#include <drivers/core/reg_program.hpp>
+#include <drivers/core/snapshot.hpp>
+
+#include <signal/kfilter.hpp>
+#include <signal/kadc.hpp>
+
+#include <array>
 
 #if KSERVER_HAS_THREADS
 #include <mutex>
@@ -17,6 +27,42 @@
 
 namespace kserver {
 
+/// Number of locks shared by the memory maps (32 max)
+#define KS_DEV_MEM_MMAP_LOCKS_NUM 16
+
+/// Maximum number of registers accessed by READ_REGS or WRITE_REGS
+#define KS_DEV_MEM_MAX_REGS 1024
+
+/// Maximum number of programs loaded
+#define KS_DEV_MEM_MAX_PROGRAMS 64
+
+/// Maximum timeout of WAIT_BIT, WAIT_VALUE and WAIT_IRQ (us)
+#define KS_DEV_MEM_MAX_WAIT 10000000
+
+/// Maximum duration a register wait holds the device lock (us)
+#define KS_DEV_MEM_WAIT_SLICE 10000
+
+/// Maximum number of snapshots regions
+#define KS_DEV_MEM_MAX_SNAPSHOTS 16
+
+/// Maximum number of samples of the PSD segments
+#define KS_DEV_MEM_MAX_NFFT 65536
+
+/// Number of DECIMATE streams
+#define KS_DEV_MEM_MAX_STREAMS 16
+
+/// Maximum decimation ratio of DECIMATE
+#define KS_DEV_MEM_MAX_DECIM 1024
+
+/// Order of the CIC filters of DECIMATE
+#define KS_DEV_MEM_CIC_ORDER 3
+
+/// Maximum number of traces averaged by AVERAGE
+#define KS_DEV_MEM_MAX_TRACES 65536
+
+/// Number of ADC conversions of READ_CONVERTED
+#define KS_DEV_MEM_MAX_CONVERSIONS 16
+
 class KS_Dev_mem : public KDevice<KS_Dev_mem,DEV_MEM>
 {
   public:
@@ -42,14 +88,185 @@ class KS_Dev_mem : public KDevice<KS_Dev_mem,DEV_MEM>
         TOGGLE_BIT,
         MASK_AND,
         MASK_OR,
+        READ_REGS,
+        WRITE_REGS,
+        LOAD_PROGRAM,
+        RUN_PROGRAM,
+        WAIT_BIT,
+        WAIT_VALUE,
+        SET_ACCESS,
+        ADD_SNAPSHOT,
+        RM_SNAPSHOT,
+        ACQUIRE_SNAPSHOT,
+        READ_SNAPSHOT,
+        ADD_MEMORY_MAP_FLAGS,
+        WAIT_IRQ,
+        PSD,
+        DECIMATE,
+        AVERAGE,
+        SET_CONVERSION,
+        READ_CONVERTED,
         dev_mem_op_num
     };
 
+    /// Conditions of WAIT_VALUE on the masked register value
+    enum WaitCondition {
+        WAIT_EQUAL,     ///< Equal to the value
+        WAIT_NOT_EQUAL, ///< Different from the value
+        WAIT_CHANGE,    ///< Different from its value at the start
+        wait_conditions_num
+    };
+
+    /// Formats of the samples of PSD
+    enum SampleFormat {
+        SAMPLES_INT32,   ///< Signed integers
+        SAMPLES_UINT32,  ///< Unsigned integers
+        SAMPLES_FLOAT32, ///< IEEE 754 single precision
+        sample_formats_num
+    };
+
+    /// Filters of DECIMATE
+    enum DecimFilter {
+        DECIM_AVERAGE, ///< Average of the decim samples
+        DECIM_CIC,     ///< CIC, on integer samples
+        DECIM_FIR,     ///< FIR lowpass, Klib::KDecimationTaps
+        decim_filters_num
+    };
+
+    /// Triggers of AVERAGE
+    enum TrigMode {
+        TRIG_PULSE,  ///< Bit set then cleared
+        TRIG_SET,    ///< Bit set, cleared by the hardware
+        TRIG_TOGGLE, ///< Bit toggled, for edge triggers
+        trig_modes_num
+    };
+
+    // Registers accesses only read the memory maps table,
+    // they can run in parallel. Adding or removing a memory
+    // map is exclusive.
+    //
+    // The waits (WAIT_BIT, WAIT_VALUE, WAIT_IRQ, AVERAGE and the
+    // programs) don't hold the lock for their whole duration: they
+    // release it every KS_DEV_MEM_WAIT_SLICE, so that an exclusive
+    // operation doesn't wait for them.
+    enum { __concurrency = CONCURRENCY_READ_WRITE };
+    enum {
+        __shared_ops = SHARED_OP(READ)       | SHARED_OP(WRITE)
+                     | SHARED_OP(WRITE_BUFFER) | SHARED_OP(READ_BUFFER)
+                     | SHARED_OP(SET_BIT)    | SHARED_OP(CLEAR_BIT)
+                     | SHARED_OP(TOGGLE_BIT) | SHARED_OP(MASK_AND)
+                     | SHARED_OP(MASK_OR)    | SHARED_OP(READ_REGS)
+                     | SHARED_OP(WRITE_REGS) | SHARED_OP(RUN_PROGRAM)
+                     | SHARED_OP(WAIT_BIT)   | SHARED_OP(WAIT_VALUE)
+                     | SHARED_OP(ACQUIRE_SNAPSHOT) | SHARED_OP(READ_SNAPSHOT)
+                     | SHARED_OP(WAIT_IRQ)   | SHARED_OP(PSD)
+                     | SHARED_OP(DECIMATE)   | SHARED_OP(AVERAGE)
+                     | SHARED_OP(SET_CONVERSION) | SHARED_OP(READ_CONVERTED)
+    };
+
 #if KSERVER_HAS_THREADS
-    std::mutex mutex;
+    /// @brief Lock of a memory map
+    ///
+    /// Serializes the read-modify-write operations (SET_BIT, MASK_AND, ...)
+    /// on the registers of a memory map. Registers are device memory, 
+    /// so atomic instructions can't be used.
+    inline std::mutex& mmap_mutex(Klib::MemMapID mmap_idx)
+    {
+        return mmap_mutexes[mmap_idx % KS_DEV_MEM_MMAP_LOCKS_NUM];
+    }
+
+    /// @brief Lock a set of memory maps
+    /// @mmaps_mask Mask of the locks (see mmap_lock_mask)
+    ///
+    /// The locks are taken in increasing order, so two
+    /// batches of registers accesses cannot deadlock.
+    inline void lock_mmaps(uint32_t mmaps_mask)
+    {
+        for(unsigned int i=0; i<KS_DEV_MEM_MMAP_LOCKS_NUM; i++)
+            if(mmaps_mask & (1U << i))
+                mmap_mutexes[i].lock();
+    }
+
+    inline void unlock_mmaps(uint32_t mmaps_mask)
+    {
+        for(unsigned int i=0; i<KS_DEV_MEM_MMAP_LOCKS_NUM; i++)
+            if(mmaps_mask & (1U << i))
+                mmap_mutexes[i].unlock();
+    }
+
+    std::array<std::mutex, KS_DEV_MEM_MMAP_LOCKS_NUM> mmap_mutexes;
 #endif
 
+    /// Bit of the lock of a memory map in a mask of locks
+    static inline uint32_t mmap_lock_mask(Klib::MemMapID mmap_idx)
+    {
+        return 1U << (mmap_idx % KS_DEV_MEM_MMAP_LOCKS_NUM);
+    }
+
+    /// @brief True if the memory map exists and contains the range
+    /// @offset Offset of the range in the memory map (octets)
+    /// @words Number of 32 bits words of the range
+    inline bool check_range(Klib::MemMapID mmap_idx, uint64_t offset,
+                            uint64_t words) const
+    {
+        return dev_mem.HasMemMap(mmap_idx)
+               && offset + words * sizeof(uint32_t) 
+                  <= dev_mem.GetSize(mmap_idx);
+    }
+
     Klib::DevMem& dev_mem;
+
+    /// Programs loaded by LOAD_PROGRAM
+    std::map< uint32_t, std::shared_ptr<Klib::RegProgram> > programs;
+
+    /// Region of a memory map acquired in snapshots
+    struct SnapshotRegion
+    {
+        Klib::MemMapID mmap_idx;
+        uint32_t offset;
+        std::shared_ptr<Klib::SnapshotPool> pool;
+    };
+
+    /// Snapshots regions added by ADD_SNAPSHOT
+    std::map<uint32_t, SnapshotRegion> snapshots;
+
+    /// Remove the snapshots of a memory map
+    void rm_snapshots(Klib::MemMapID mmap_idx);
+
+    /// @brief State of a DECIMATE stream
+    ///
+    /// The filter is kept between two requests, so that consecutive
+    /// buffers of an acquisition are decimated as one signal.
+    struct DecimStream
+    {
+        uint32_t filter = decim_filters_num; ///< DecimFilter of the stream
+        uint32_t decim = 0;
+
+        std::unique_ptr< Klib::KMovingAverage<float> > average;
+        std::unique_ptr< Klib::KCicDecimator<float> > cic;
+        std::unique_ptr< Klib::KFirDecimator<float> > fir;
+
+#if KSERVER_HAS_THREADS
+        std::mutex mutex;
+#endif
+
+        /// Restart the stream, with a new filter if the parameters change
+        void reset(uint32_t filter_, uint32_t decim_);
+    };
+
+    std::array<DecimStream, KS_DEV_MEM_MAX_STREAMS> decim_streams;
+
+    /// @brief ADC conversion of READ_CONVERTED, set by SET_CONVERSION
+    struct AdcConversion
+    {
+        std::unique_ptr< Klib::KAdcConverter<float> > converter;
+
+#if KSERVER_HAS_THREADS
+        std::mutex mutex;
+#endif
+    };
+
+    std::array<AdcConversion, KS_DEV_MEM_MAX_CONVERSIONS> conversions;
     
 }; // class KS_Dev_mem
 
@@ -58,6 +275,7 @@ template<>
 struct KDevice<KS_Dev_mem,DEV_MEM>::
             Argument<KS_Dev_mem::OPEN>
 {
+    NO_ARGUMENT_FIELDS
 };
 
 template<>
@@ -67,6 +285,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 {
 unsigned int device_addr; ///< Physical address of the device
     unsigned int map_size; ///< Mmap size
+
+    ARGUMENT_FIELDS(device_addr, map_size)
     };
 
 template<>
@@ -75,6 +295,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
             Argument<KS_Dev_mem::RM_MEMORY_MAP>
 {
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
+
+    ARGUMENT_FIELDS(mmap_idx)
     };
 
 template<>
@@ -84,6 +306,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 {
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register to read
+
+    ARGUMENT_FIELDS(mmap_idx, offset)
     };
 
 template<>
@@ -94,6 +318,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register to read
     unsigned int reg_val; ///< Value to write in the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, reg_val)
     };
 
 template<>
@@ -104,6 +330,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register to write
     unsigned int len_data; ///< Size of the buffer data. To be used for the handshaking.
+
+    ARGUMENT_FIELDS(mmap_idx, offset, len_data)
     };
 
 template<>
@@ -114,6 +342,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register to read
     unsigned int buff_size; ///< Number of registers to read
+
+    ARGUMENT_FIELDS(mmap_idx, offset, buff_size)
     };
 
 template<>
@@ -124,6 +354,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register
     unsigned int index; ///< Index of the bit to set in the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, index)
     };
 
 template<>
@@ -134,6 +366,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register
     unsigned int index; ///< Index of the bit to set in the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, index)
     };
 
 template<>
@@ -144,6 +378,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register
     unsigned int index; ///< Index of the bit to set in the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, index)
     };
 
 template<>
@@ -154,6 +390,8 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register
     unsigned int mask; ///< Mask to apply on the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, mask)
     };
 
 template<>
@@ -164,8 +402,261 @@ struct KDevice<KS_Dev_mem,DEV_MEM>::
 Klib::MemMapID mmap_idx; ///< Index of Memory Map
     unsigned int offset; ///< Offset of the register
     unsigned int mask; ///< Mask to apply on the register
+
+    ARGUMENT_FIELDS(mmap_idx, offset, mask)
     };
 
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::READ_REGS>
+{
+    unsigned int regs_num; ///< Number of registers to read.
+                           ///< The client then sends the (mmap_idx, offset) 
+                           ///< of each register. To be used for the handshaking.
+
+    ARGUMENT_FIELDS(regs_num)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::WRITE_REGS>
+{
+    unsigned int regs_num; ///< Number of registers to write.
+                           ///< The client then sends the (mmap_idx, offset, value)
+                           ///< of each register. To be used for the handshaking.
+
+    ARGUMENT_FIELDS(regs_num)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::LOAD_PROGRAM>
+{
+    uint32_t prog_id;  ///< ID of the program. Replaces the program with this ID.
+    uint32_t len_code; ///< Number of words of the bytecode. To be used for the handshaking.
+
+    ARGUMENT_FIELDS(prog_id, len_code)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::RUN_PROGRAM>
+{
+    uint32_t prog_id;    ///< ID of the program
+    uint32_t params_num; ///< Number of parameters. To be used for the handshaking,
+                         ///< which is skipped if the program has no parameter.
+
+    ARGUMENT_FIELDS(prog_id, params_num)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::WAIT_BIT>
+{
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the register
+    unsigned int index;      ///< Index of the bit in the register
+    unsigned int level;      ///< Level expected (0 or 1)
+    uint32_t timeout_us;     ///< Timeout in microseconds
+
+    ARGUMENT_FIELDS(mmap_idx, offset, index, level, timeout_us)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::WAIT_VALUE>
+{
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the register
+    uint32_t mask;           ///< Mask applied to the register
+    uint32_t value;          ///< Value compared to the masked register
+    unsigned int condition;  ///< KS_Dev_mem::WaitCondition
+    uint32_t timeout_us;     ///< Timeout in microseconds
+
+    ARGUMENT_FIELDS(mmap_idx, offset, mask, value, condition, timeout_us)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::SET_ACCESS>
+{
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    uint32_t access;         ///< Klib::access_mode_t
+
+    ARGUMENT_FIELDS(mmap_idx, access)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::ADD_SNAPSHOT>
+{
+    uint32_t snap_id;        ///< ID of the snapshot
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the region
+    unsigned int buff_size;  ///< Number of registers of the region
+    unsigned int buffers_num;///< Number of staging buffers
+
+    ARGUMENT_FIELDS(snap_id, mmap_idx, offset, buff_size, buffers_num)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::RM_SNAPSHOT>
+{
+    uint32_t snap_id; ///< ID of the snapshot
+
+    ARGUMENT_FIELDS(snap_id)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::ACQUIRE_SNAPSHOT>
+{
+    uint32_t snap_id; ///< ID of the snapshot
+
+    ARGUMENT_FIELDS(snap_id)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::READ_SNAPSHOT>
+{
+    uint32_t snap_id;     ///< ID of the snapshot
+    unsigned int acquire; ///< 1 to acquire a new snapshot before sending
+
+    ARGUMENT_FIELDS(snap_id, acquire)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::ADD_MEMORY_MAP_FLAGS>
+{
+    unsigned int device_addr; ///< Physical address of the device
+    unsigned int map_size;    ///< Mmap size
+    unsigned int flags;       ///< MEMMAP_POPULATE | MEMMAP_HUGE_PAGES
+
+    ARGUMENT_FIELDS(device_addr, map_size, flags)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::WAIT_IRQ>
+{
+    uint32_t timeout_us; ///< Timeout in microseconds
+
+    ARGUMENT_FIELDS(timeout_us)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::PSD>
+{
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the samples
+    unsigned int buff_size;  ///< Number of samples
+    unsigned int format;     ///< KS_Dev_mem::SampleFormat
+    unsigned int nfft;       ///< Samples per segment (power of 2)
+    unsigned int window;     ///< Klib::kwindow_t
+    unsigned int first_bin;  ///< First bin sent
+    unsigned int bins_num;   ///< Number of bins sent, 0 for all up to nfft/2
+    unsigned int decim;      ///< Number of consecutive bins averaged (>= 1)
+
+    ARGUMENT_FIELDS(mmap_idx, offset, buff_size, format, nfft, window,
+                    first_bin, bins_num, decim)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::DECIMATE>
+{
+    uint32_t stream_id;      ///< Stream (< KS_DEV_MEM_MAX_STREAMS)
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the samples
+    unsigned int buff_size;  ///< Number of samples, a multiple of decim
+    unsigned int format;     ///< KS_Dev_mem::SampleFormat
+    unsigned int filter;     ///< KS_Dev_mem::DecimFilter
+    unsigned int decim;      ///< Decimation ratio
+    unsigned int restart;    ///< 1 to restart the stream, 0 to continue it
+
+    ARGUMENT_FIELDS(stream_id, mmap_idx, offset, buff_size, format, filter,
+                    decim, restart)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::AVERAGE>
+{
+    Klib::MemMapID mmap_idx;   ///< Index of Memory Map
+    unsigned int offset;       ///< Offset of the traces (or of the ring)
+    unsigned int buff_size;    ///< Number of samples of a trace
+    unsigned int format;       ///< KS_Dev_mem::SampleFormat
+    unsigned int traces_num;   ///< Number of traces averaged
+    unsigned int trig_offset;  ///< Offset of the trigger register
+    unsigned int trig_index;   ///< Bit of the trigger, 32 for none
+    unsigned int trig_mode;    ///< KS_Dev_mem::TrigMode
+    unsigned int ready_offset; ///< Offset of the ready register
+    unsigned int ready_index;  ///< Bit set when a trace is ready, 32 for none
+    unsigned int ring_size;    ///< Samples of the ring buffer, 0 for none
+    unsigned int start_offset; ///< Offset of the register giving the first
+                               ///< sample of a trace in the ring
+    uint32_t timeout_us;       ///< Timeout of the whole averaging
+    unsigned int envelopes;    ///< 1 to send the min and max envelopes
+
+    ARGUMENT_FIELDS(mmap_idx, offset, buff_size, format, traces_num,
+                    trig_offset, trig_index, trig_mode, ready_offset, 
+                    ready_index, ring_size, start_offset, timeout_us, 
+                    envelopes)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::SET_CONVERSION>
+{
+    uint32_t conv_id;             ///< Conversion (< KS_DEV_MEM_MAX_CONVERSIONS)
+    unsigned int bits;            ///< Bits of a sample
+    unsigned int format;          ///< KS_Dev_mem::SampleFormat (integers)
+    unsigned int fields_per_word; ///< Samples per register (1, 2 or 4)
+    unsigned int channels_num;    ///< Number of channels
+    unsigned int channel;         ///< Channel calibrated
+    float offset;                 ///< Raw value of a zero
+    float gain;                   ///< Units per code
+    float c2;                     ///< Quadratic coefficient
+    float c3;                     ///< Cubic coefficient
+
+    ARGUMENT_FIELDS(conv_id, bits, format, fields_per_word, channels_num,
+                    channel, offset, gain, c2, c3)
+};
+
+template<>
+template<>
+struct KDevice<KS_Dev_mem,DEV_MEM>::
+            Argument<KS_Dev_mem::READ_CONVERTED>
+{
+    uint32_t conv_id;        ///< Conversion set by SET_CONVERSION
+    Klib::MemMapID mmap_idx; ///< Index of Memory Map
+    unsigned int offset;     ///< Offset of the registers
+    unsigned int buff_size;  ///< Number of registers
+
+    ARGUMENT_FIELDS(conv_id, mmap_idx, offset, buff_size)
+};
+
 } // namespace kserver
 
 #endif //__KS_DEV_MEM_HPP__
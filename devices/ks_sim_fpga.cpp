@@ -0,0 +1,133 @@
+/// @file ks_sim_fpga.cpp
+///
+/// (c) Koheron 2014-2015 
+
+#include "ks_sim_fpga.hpp"
+
+#include "../core/commands.hpp"
+#include "../core/kserver.hpp"
+#include "../core/kserver_session.hpp"
+#include "../core/args_parser.hpp"
+
+namespace kserver {
+
+#define THIS (static_cast<KS_Sim_fpga*>(this))
+
+/////////////////////////////////////
+// START
+
+template<>
+template<>
+int KDevice<KS_Sim_fpga,SIM_FPGA>::
+        execute_op<KS_Sim_fpga::START> 
+        (const Argument<KS_Sim_fpga::START>& args, SessID sess_id)
+{
+    if(THIS->sim_fpga.Start(args.phys_addr, args.sample_rate) < 0) {
+        kserver->syslog.print(SysLog::ERROR, 
+                              "START: Can't start the simulator at 0x%x\n",
+                              args.phys_addr);
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::INFO, 
+                          "FPGA simulator started at 0x%x, %u Hz\n",
+                          args.phys_addr, args.sample_rate);
+    return 0;
+}
+
+/////////////////////////////////////
+// STOP
+
+template<>
+template<>
+int KDevice<KS_Sim_fpga,SIM_FPGA>::
+        execute_op<KS_Sim_fpga::STOP> 
+        (const Argument<KS_Sim_fpga::STOP>& args, SessID sess_id)
+{
+    THIS->sim_fpga.Stop();
+    return 0;
+}
+
+/////////////////////////////////////
+// GET_STATUS
+
+/// Reply: running | phys_addr | sample_rate | samples_num (low, high)
+///        | acquisitions_num | load (x1000)
+template<>
+template<>
+int KDevice<KS_Sim_fpga,SIM_FPGA>::
+        execute_op<KS_Sim_fpga::GET_STATUS> 
+        (const Argument<KS_Sim_fpga::GET_STATUS>& args, SessID sess_id)
+{
+    const Klib::SimFpga& sim = THIS->sim_fpga;
+    uint64_t samples_num = sim.GetSamplesNum();
+    uint32_t status[7];
+
+    status[0] = sim.IsRunning();
+    status[1] = static_cast<uint32_t>(sim.GetPhysAddr());
+    status[2] = sim.GetSampleRate();
+    status[3] = static_cast<uint32_t>(samples_num);
+    status[4] = static_cast<uint32_t>(samples_num >> 32);
+    status[5] = sim.GetAcquisitionsNum();
+    status[6] = sim.GetLoad();
+
+    if(SEND_ARRAY<uint32_t>(status, 7) < 0) {
+        return -1;
+    }
+
+    kserver->syslog.print(SysLog::DEBUG, "[S] [%u bytes]\n", 
+                          7 * sizeof(uint32_t));
+    return 0;
+}
+
+template<>
+bool KDevice<KS_Sim_fpga,SIM_FPGA>::is_failed(void)
+{
+    return false;
+}
+
+template<>
+int KDevice<KS_Sim_fpga,SIM_FPGA>::
+        execute(const Command& cmd)
+{
+    int err;
+
+    switch(cmd.operation) {
+      case KS_Sim_fpga::START: {
+        Argument<KS_Sim_fpga::START> args;
+
+        if(parse_arg<KS_Sim_fpga::START>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Sim_fpga::START>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Sim_fpga::STOP: {
+        Argument<KS_Sim_fpga::STOP> args;
+
+        if(parse_arg<KS_Sim_fpga::STOP>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Sim_fpga::STOP>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Sim_fpga::GET_STATUS: {
+        Argument<KS_Sim_fpga::GET_STATUS> args;
+
+        if(parse_arg<KS_Sim_fpga::GET_STATUS>(cmd, args) < 0) {
+            return -1;
+        }
+
+        err = execute_op<KS_Sim_fpga::GET_STATUS>(args, cmd.sess_id);
+        return err;
+      }
+      case KS_Sim_fpga::sim_fpga_op_num:
+      default:
+        kserver->syslog.print(SysLog::ERROR, "SIM_FPGA: Unknown operation\n");
+        return -1;
+    }
+}
+
+} // namespace kserver
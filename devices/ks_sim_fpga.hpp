@@ -0,0 +1,70 @@
+/// @file ks_sim_fpga.hpp
+///
+/// (c) Koheron 2014-2015 
+
+#ifndef __KS_SIM_FPGA_HPP__
+#define __KS_SIM_FPGA_HPP__
+
+#include <drivers/sim/sim_fpga.hpp>
+#include <drivers/core/dev_mem.hpp>
+
+#include "../core/kdevice.hpp"
+#include "../core/devices_manager.hpp"
+
+namespace kserver {
+
+class KS_Sim_fpga : public KDevice<KS_Sim_fpga,SIM_FPGA>
+{
+  public:
+    const device_t kind = SIM_FPGA;
+    enum { __kind = SIM_FPGA };
+
+  public:
+    KS_Sim_fpga(KServer* kserver, Klib::DevMem& dev_mem_)
+    : KDevice<KS_Sim_fpga,SIM_FPGA>(kserver)
+    , sim_fpga(dev_mem_.GetBackend())
+    {}
+
+    enum Operation {
+        START,
+        STOP,
+        GET_STATUS,
+        sim_fpga_op_num
+    };
+
+    // The peripheral is accessed through DEV_MEM, the operations 
+    // of SIM_FPGA only start and stop it: they are exclusive.
+
+    Klib::SimFpga sim_fpga;
+}; // class KS_Sim_fpga
+
+template<>
+template<>
+struct KDevice<KS_Sim_fpga,SIM_FPGA>::
+            Argument<KS_Sim_fpga::START>
+{
+    unsigned int phys_addr;   ///< Base address of the peripheral
+    uint32_t sample_rate;     ///< Sample rate of the ADC (Hz)
+
+    ARGUMENT_FIELDS(phys_addr, sample_rate)
+};
+
+template<>
+template<>
+struct KDevice<KS_Sim_fpga,SIM_FPGA>::
+            Argument<KS_Sim_fpga::STOP>
+{
+    NO_ARGUMENT_FIELDS
+};
+
+template<>
+template<>
+struct KDevice<KS_Sim_fpga,SIM_FPGA>::
+            Argument<KS_Sim_fpga::GET_STATUS>
+{
+    NO_ARGUMENT_FIELDS
+};
+
+} // namespace kserver
+
+#endif //__KS_SIM_FPGA_HPP__
@@ -9,6 +9,10 @@
 
 #include "dev_mem.hpp"
 
+#include <algorithm>
+
+#include "wr_register.hpp"
+
 /// @namespace Klib
 /// @brief Namespace of the Koheron library
 namespace Klib {
@@ -16,11 +20,21 @@ namespace Klib {
 DevMem::DevMem(intptr_t addr_limit_down_, intptr_t addr_limit_up_)
 : addr_limit_down(addr_limit_down_),
   addr_limit_up(addr_limit_up_),
-  mem_maps(),
-  reusable_ids(0)
+  free_slots(0)
 {
-    fd = -1;
     is_open = 0;
+
+    // Slots are allocated from the lowest index
+    for(uint32_t i=0; i<MEMMAP_SLOTS_NUM; i++) {
+        slots[i].id.store(MEMMAP_INVALID_ID);
+        slots[i].base_addr = 0;
+        slots[i].generation = 0;
+        slots[i].phys_addr = 0;
+        slots[i].size = 0;
+        slots[i].flags = 0;
+        slots[i].access = ACCESS_32;
+        free_slots.push_back(MEMMAP_SLOTS_NUM - 1 - i);
+    }
 }
 
 DevMem::~DevMem()
@@ -28,30 +42,35 @@ DevMem::~DevMem()
     Close();
 }
 
-int DevMem::Open()
+int DevMem::Open(const char *path)
 {
-    // Open /dev/mem if not already open
-    if(fd == -1) {
-        fd = open("/dev/mem", O_RDWR | O_SYNC);
+    // Keep /dev/mem if already open
+    if(is_open)
+        return Open(std::move(backend));
 
-         if(fd == -1) {
-            fprintf(stderr, "Can't open /dev/mem\n");
-            return -1;
-        }
-        
-        is_open = 1;
-    }
-	
-    // Reset memory maps
+    return Open(std::unique_ptr<MemBackend>(new DevMemBackend(path)));
+}
+
+int DevMem::Open(std::unique_ptr<MemBackend> backend_)
+{
+    // The memory maps of the previous backend are removed first
     RemoveAll();
-    	
-    return fd;
+    backend = std::move(backend_);
+    is_open = backend != nullptr && backend->Open() == 0;
+
+    if(!is_open) {
+        backend.reset();
+        return -1;
+    }
+
+    return 0;
 }
 
 int DevMem::Close()
 {
     RemoveAll();
-    close(fd);
+    backend.reset();
+    is_open = 0;
     return 0;
 }
 
@@ -65,94 +84,240 @@ bool DevMem::__is_forbidden_address(intptr_t addr)
         return (addr > addr_limit_up) || (addr < addr_limit_down);
 }
 
-MemMapID DevMem::AddMemoryMap(intptr_t addr, uint32_t size)
+/// Physical address as an unsigned integer
+static inline uint64_t __phys(intptr_t addr)
+{
+    return static_cast<uintptr_t>(addr);
+}
+
+std::shared_ptr<MemoryMap> DevMem::__get_mapping(intptr_t addr, uint32_t size,
+                                                 uint32_t flags)
+{
+    uint64_t start = __phys(addr);
+    uint64_t end = start + size;
+
+    // A mapping containing the range
+    for(auto& slot : slots) {
+        if(slot.mem_map == nullptr || slot.flags != flags)
+            continue;
+
+        uint64_t map_start = __phys(slot.mem_map->GetPhysAddr());
+        uint64_t map_end = map_start + slot.mem_map->MappedSize();
+
+        if(map_start <= start && end <= map_end)
+            return slot.mem_map;
+    }
+
+    // Extend the range with the mappings sharing a page 
+    // with it or adjacent to it, until no mapping is added.
+    uint64_t page_mask = sysconf(_SC_PAGESIZE) - 1;
+    bool extended = true;
+
+    while(extended) {
+        extended = false;
+
+        for(auto& slot : slots) {
+            if(slot.mem_map == nullptr || slot.flags != flags)
+                continue;
+
+            uint64_t map_start = __phys(slot.mem_map->GetPhysAddr());
+            uint64_t map_end = map_start + slot.mem_map->MappedSize();
+
+            if((map_start & ~page_mask) > ((end + page_mask) & ~page_mask)
+               || (start & ~page_mask) > ((map_end + page_mask) & ~page_mask))
+                continue;
+
+            if(map_start < start || map_end > end) {
+                start = std::min(start, map_start);
+                end = std::max(end, map_end);
+                extended = true;
+            }
+        }
+    }
+
+    // Too large to be coalesced
+    if(end - start > UINT32_MAX) {
+        start = __phys(addr);
+        end = start + size;
+    }
+
+    std::shared_ptr<MemoryMap> mapping = std::make_shared<MemoryMap>(
+            backend.get(), static_cast<intptr_t>(start), end - start, flags);
+
+    if(mapping->GetStatus() != MemoryMap::MEMMAP_OPENED)
+        return nullptr;
+
+    // Move the memory maps to the new mapping, 
+    // the previous mappings are unmapped
+    for(auto& slot : slots) {
+        if(slot.mem_map == nullptr || slot.flags != flags 
+           || __phys(slot.phys_addr) < start 
+           || __phys(slot.phys_addr) + slot.size > end)
+            continue;
+
+        slot.mem_map = mapping;
+        slot.base_addr = mapping->GetBaseAddr() 
+                         + (__phys(slot.phys_addr) - start);
+    }
+
+    return mapping;
+}
+
+MemMapID DevMem::AddMemoryMap(intptr_t addr, uint32_t size, uint32_t flags,
+                              uint32_t owner)
 {
     if(__is_forbidden_address(addr)) {
         fprintf(stderr,"Forbidden memory region\n");
-        return static_cast<MemMapID>(-1);
+        return MEMMAP_INVALID_ID;
+    }
+
+    // Existing memory map
+    for(auto& slot : slots) {
+        if(slot.mem_map != nullptr && slot.phys_addr == addr 
+           && slot.size == size && slot.flags == flags) {
+            auto ref = std::find_if(slot.refs.begin(), slot.refs.end(),
+                [owner](const std::pair<uint32_t, uint32_t>& ref) {
+                    return ref.first == owner;
+                });
+
+            if(ref == slot.refs.end())
+                slot.refs.push_back(std::make_pair(owner, 1));
+            else
+                ref->second++;
+
+            return slot.id.load();
+        }
+    }
+
+    if(!is_open) {
+        fprintf(stderr,"No memory backend\n");
+        return MEMMAP_INVALID_ID;
+    }
+
+    if(free_slots.empty()) {
+        fprintf(stderr,"Too many memory maps\n");
+        return MEMMAP_INVALID_ID;
     }
 
-    MemoryMap *mem_map = new MemoryMap(&fd, addr, size);
-    assert(mem_map != NULL);
+    std::shared_ptr<MemoryMap> mapping = __get_mapping(addr, size, flags);
 
-    if(mem_map->GetStatus() != MemoryMap::MEMMAP_OPENED) {
+    if(mapping == nullptr) {
         fprintf(stderr,"Can't open memory map\n");
-        return static_cast<MemMapID>(-1);
+        return MEMMAP_INVALID_ID;
     }
     
-    MemMapID new_id;
-    
-    // Choose a reusable ID if available else
-    // create a new ID equal to the number of memmaps
-    if(reusable_ids.size() == 0) {    
-        new_id = static_cast<MemMapID>(num_maps);
-    } else {
-        new_id = reusable_ids.back();
-        reusable_ids.pop_back();
-    }
-	
-    mem_maps.insert(std::pair<MemMapID, MemoryMap*>(new_id, mem_map));
+    uint32_t index = free_slots.back();
+    free_slots.pop_back();
+
+    Slot& slot = slots[index];
+    MemMapID new_id = (slot.generation << MEMMAP_SLOT_BITS) | index;
+
+    // Below 2^31: never MEMMAP_INVALID_ID
+    slot.generation = (slot.generation + 1) 
+                      & ((1U << (31 - MEMMAP_SLOT_BITS)) - 1);
+    slot.base_addr = mapping->GetBaseAddr() 
+                     + (addr - mapping->GetPhysAddr());
+    slot.mem_map = mapping;
+    slot.phys_addr = addr;
+    slot.size = size;
+    slot.flags = flags;
+    slot.access = ACCESS_32;
+    slot.refs.assign(1, std::make_pair(owner, 1));
+    slot.id.store(new_id, std::memory_order_release);
     num_maps++;
     
     return new_id;
 }
 
-MemoryMap& DevMem::GetMemMap(MemMapID id)
+void DevMem::__free_slot(Slot& slot)
 {
-//    assert(id < num_maps);
-    assert(mem_maps.at(id) != NULL);
+    slot.id.store(MEMMAP_INVALID_ID, std::memory_order_release);
+    slot.mem_map.reset(); // Unmapped with its last memory map
+    slot.base_addr = 0;
+    slot.refs.clear();
 
-    return *mem_maps.at(id);
+    free_slots.push_back(&slot - &slots[0]);
+    num_maps--;
 }
 
-void DevMem::RmMemoryMap(MemMapID id)
+int DevMem::RmMemoryMap(MemMapID id, uint32_t owner)
 {
-    if(mem_maps[id] != NULL) {
-        delete mem_maps[id];
-    }
-        
-    mem_maps.erase(id);
-    reusable_ids.push_back(id);
-    num_maps--;
+    if(!HasMemMap(id))
+        return -1;
+
+    Slot& slot = __slot(id);
+    auto ref = std::find_if(slot.refs.begin(), slot.refs.end(),
+        [owner](const std::pair<uint32_t, uint32_t>& ref) {
+            return ref.first == owner;
+        });
+
+    if(ref == slot.refs.end())
+        return -1;
+
+    if(--ref->second == 0)
+        slot.refs.erase(ref);
+
+    if(slot.refs.empty())
+        __free_slot(slot);
+
+    return 0;
 }
 
-void DevMem::RemoveAll()
+std::vector<MemMapID> DevMem::ReleaseOwner(uint32_t owner)
 {
-    assert(num_maps == mem_maps.size());
+    std::vector<MemMapID> removed;
 
-    if(!mem_maps.empty()) {
-        // This is necessary because both mem_maps.size() and num_maps
-        // are decremented at each call of RmMemoryMap
-        uint32_t mem_maps_size = mem_maps.size();
-    
-        for(unsigned int id=0; id<mem_maps_size; id++) {
-            RmMemoryMap(id);
+    for(auto& slot : slots) {
+        if(slot.mem_map == nullptr)
+            continue;
+
+        slot.refs.erase(std::remove_if(slot.refs.begin(), slot.refs.end(),
+            [owner](const std::pair<uint32_t, uint32_t>& ref) {
+                return ref.first == owner;
+            }), slot.refs.end());
+
+        if(slot.refs.empty()) {
+            removed.push_back(slot.id.load(std::memory_order_relaxed));
+            __free_slot(slot);
         }
     }
+
+    return removed;
+}
+
+void DevMem::RemoveAll()
+{
+    for(auto& slot : slots)
+        if(slot.mem_map != nullptr)
+            __free_slot(slot);
         
     assert(num_maps == 0);
 }
 
-uint32_t DevMem::GetBaseAddr(MemMapID id)
+unsigned int DevMem::GetRefCount(MemMapID id) const
 {
-//    assert(id < num_maps);
-    assert(mem_maps.at(id) != NULL);
-    
-    return mem_maps.at(id)->GetBaseAddr();
+    if(!HasMemMap(id))
+        return 0;
+
+    unsigned int count = 0;
+
+    for(auto& ref : __slot(id).refs)
+        count += ref.second;
+
+    return count;
 }
 
 int DevMem::GetStatus(MemMapID id)
 {
-//    assert(id < num_maps);
-    assert(mem_maps.at(id) != NULL);
-    
-    return mem_maps.at(id)->GetStatus();
+    assert(HasMemMap(id));
+    return __slot(id).mem_map->GetStatus();
 }
 
 int DevMem::IsFailed()
 {
-    for(unsigned int i=0; i<mem_maps.size(); i++) {
-        if(mem_maps[i]->GetStatus() == MemoryMap::MEMMAP_FAILURE) {
+    for(auto& slot : slots) {
+        if(slot.mem_map != nullptr 
+           && slot.mem_map->GetStatus() == MemoryMap::MEMMAP_FAILURE) {
             return 1;
         }
     }
@@ -161,4 +326,3 @@ int DevMem::IsFailed()
 }
 
 }; // namespace Klib
-
@@ -5,7 +5,10 @@
 #ifndef __DRIVERS_CORE_DEV_MEM_HPP__
 #define __DRIVERS_CORE_DEV_MEM_HPP__
 
-#include <map>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <cstdint>
 #include <assert.h> 
@@ -20,11 +23,41 @@ extern "C" {
 /// @brief Namespace of the Koheron library
 namespace Klib {
 
-/// ID of a memory map
+/// @brief ID of a memory map
+///
+/// The low bits are the index of the slot of the memory map,
+/// the high bits the generation of the slot. An ID is not
+/// reused after the memory map is removed: the next memory
+/// map in the slot has the next generation. The generation
+/// wraps after 2^(31 - MEMMAP_SLOT_BITS) memory maps, so that
+/// the IDs stay positive as 32 bits signed integers.
 typedef uint32_t MemMapID;
 
+/// Number of bits of the slot index in a MemMapID
+#define MEMMAP_SLOT_BITS 8
+
+/// Maximum number of memory maps
+#define MEMMAP_SLOTS_NUM (1 << MEMMAP_SLOT_BITS)
+
+/// Invalid memory map ID
+#define MEMMAP_INVALID_ID static_cast<Klib::MemMapID>(-1)
+
+/// Owner of the memory maps only removed by RemoveAll
+#define MEMMAP_NO_OWNER static_cast<uint32_t>(-1)
+
 /// Device memory manager
 /// A memory maps factory
+///
+/// The memory maps are stored in a table of slots indexed by the ID.
+/// The lookups don't lock: adding and removing memory maps must not run
+/// concurrently with the accesses to the memory maps.
+///
+/// Memory maps are shared: adding a range already mapped with the same
+/// flags returns the same ID, with one more reference for the owner
+/// (e.g. the session). The memory map is removed when all the owners
+/// released it. The ranges contained in, overlapping or adjacent to a
+/// mapping with the same flags are mapped together, so the pages
+/// of a peripheral are mapped once.
 class DevMem
 {
   public:
@@ -32,7 +65,13 @@ class DevMem
     ~DevMem();
 
     /// Open the /dev/mem driver
-    int Open();
+    /// @path Memory device
+    int Open(const char *path = "/dev/mem");
+
+    /// Open a backend of the physical address space
+    /// @backend_ The backend (see mem_backend.hpp)
+    /// @return 0 if succeed, -1 else
+    int Open(std::unique_ptr<MemBackend> backend_);
 	
     /// Close all the memory maps
     /// @return 0 if succeed, -1 else
@@ -41,50 +80,135 @@ class DevMem
     /// Current number of memory maps
     static unsigned int num_maps;
 
-    /// Create a new memory map
+    /// Create a new memory map, or reference an existing one
     /// @addr Base address of the map
     /// @size Size of the map 
+    /// @flags Flags of the map (MEMMAP_POPULATE, MEMMAP_HUGE_PAGES)
+    /// @owner Owner of the reference
     /// @return An ID to the created map,
     ///         or -1 if an error occured
-    MemMapID AddMemoryMap(intptr_t addr, uint32_t size);
+    MemMapID AddMemoryMap(intptr_t addr, uint32_t size, uint32_t flags = 0,
+                          uint32_t owner = MEMMAP_NO_OWNER);
     
-    /// Remove a memory map
+    /// Release a reference to a memory map
     /// @id ID of the memory map to be removed
-    void RmMemoryMap(MemMapID id);
+    /// @owner Owner of the reference
+    /// @return 0 if success, -1 if the owner has no reference
+    int RmMemoryMap(MemMapID id, uint32_t owner = MEMMAP_NO_OWNER);
+
+    /// @brief Release all the references of an owner
+    /// @return The IDs of the memory maps removed
+    std::vector<MemMapID> ReleaseOwner(uint32_t owner);
     
     /// Remove all the memory maps
     void RemoveAll();
     
-    /// Get a memory map
-    /// @id ID of the memory map
-    MemoryMap& GetMemMap(MemMapID id);
+    /// Get the mapping of a memory map
+    /// @id ID of the memory map (must be valid, see HasMemMap)
+    ///
+    /// The mapping may contain other memory maps, 
+    /// use GetBaseAddr and GetSize for the memory map.
+    inline MemoryMap& GetMemMap(MemMapID id)
+    {
+        assert(HasMemMap(id));
+        return *__slot(id).mem_map;
+    }
+
+    /// Return the size of a map in octets
+    /// @id ID of the map (must be valid)
+    inline uint32_t GetSize(MemMapID id) const {return __slot(id).size;}
+
+    /// Return the access mode of the bulk transfers (access_mode_t)
+    /// @id ID of the map (must be valid)
+    inline uint32_t GetAccess(MemMapID id) const {return __slot(id).access;}
+
+    /// Set the access mode of the bulk transfers
+    /// @id ID of the map (must be valid)
+    /// @access An access_mode_t
+    inline void SetAccess(MemMapID id, uint32_t access)
+    {
+        __slot(id).access = access;
+    }
+
+    /// Return the number of references to a map
+    /// @id ID of the map
+    unsigned int GetRefCount(MemMapID id) const;
     
     /// Return the base address of a map
     /// @id ID of the map
-    uint32_t GetBaseAddr(MemMapID id);
+    /// @return The base address, or 0 if the ID is invalid
+    inline intptr_t GetBaseAddr(MemMapID id) const
+    {
+        const Slot& slot = __slot(id);
+
+        if(slot.id.load(std::memory_order_acquire) != id)
+            return 0;
+
+        return slot.base_addr;
+    }
     
     /// Return the status of a map
     /// @id ID of the map
     int GetStatus(MemMapID id);
+
+    /// True if a memory map has the ID
+    /// @id ID of the map
+    inline bool HasMemMap(MemMapID id) const
+    {
+        return id != MEMMAP_INVALID_ID 
+               && __slot(id).id.load(std::memory_order_acquire) == id;
+    }
 	
     /// Return 1 if a memory map failed
     int IsFailed();
     
-    /// True if the /dev/mem device is open
+    /// True if the backend is open
     inline bool IsOpen() const {return is_open;}
 
+    /// Backend of the physical address space (NULL if not open)
+    inline MemBackend* GetBackend() const {return backend.get();}
+
   private:
-    int fd;         ///< /dev/mem file ID
-    bool is_open;   ///< True if /dev/mem open
+    std::unique_ptr<MemBackend> backend;
+    bool is_open;   ///< True if the backend is open
     
     /// Limit addresses
     intptr_t addr_limit_down;
     intptr_t addr_limit_up;
     bool __is_forbidden_address(intptr_t addr);
+
+    struct Slot
+    {
+        std::atomic<MemMapID> id; ///< ID of the memory map, or MEMMAP_INVALID_ID
+        intptr_t base_addr;       ///< Base address of the memory map
+        std::shared_ptr<MemoryMap> mem_map; ///< Mapping (shared by the slots)
+        uint32_t generation;      ///< Generation of the next memory map
+        intptr_t phys_addr;       ///< Physical address of the memory map
+        uint32_t size;            ///< Size of the memory map
+        uint32_t flags;           ///< Flags of the memory map
+        uint32_t access;          ///< Access mode of the bulk transfers
+
+        /// References: (owner, count)
+        std::vector< std::pair<uint32_t, uint32_t> > refs;
+    };
     
     /// Memory maps container
-    std::map<MemMapID, MemoryMap*> mem_maps; 
-    std::vector<MemMapID> reusable_ids;
+    std::array<Slot, MEMMAP_SLOTS_NUM> slots;
+    std::vector<uint32_t> free_slots;
+
+    std::shared_ptr<MemoryMap> __get_mapping(intptr_t addr, uint32_t size, 
+                                             uint32_t flags);
+    void __free_slot(Slot& slot);
+
+    inline Slot& __slot(MemMapID id)
+    {
+        return slots[id & (MEMMAP_SLOTS_NUM - 1)];
+    }
+
+    inline const Slot& __slot(MemMapID id) const
+    {
+        return slots[id & (MEMMAP_SLOTS_NUM - 1)];
+    }
 };
 
 }; // namespace Klib
@@ -0,0 +1,318 @@
+/// @file mem_backend.cpp
+///
+/// @brief Implementation of mem_backend.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "mem_backend.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+
+extern "C" {
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+}
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+const char *mem_backends_names[mem_backends_num] = {
+    "none",
+    "devmem",
+    "uio",
+    "file",
+    "memfd"
+};
+
+static inline uint64_t page_mask()
+{
+    return sysconf(_SC_PAGESIZE) - 1;
+}
+
+// ---------------------------------------------------------------------
+// MemBackend
+// ---------------------------------------------------------------------
+
+MemBackend::MemBackend(const std::string& path_)
+: path(path_),
+  fd(-1)
+{}
+
+MemBackend::~MemBackend()
+{
+    if(fd >= 0)
+        close(fd);
+}
+
+int MemBackend::Open()
+{
+    if(fd >= 0)
+        return 0;
+
+    fd = open(path.c_str(), O_RDWR | O_SYNC);
+
+    if(fd < 0) {
+        fprintf(stderr, "Can't open %s\n", path.c_str());
+        return -1;
+    }
+
+    return 0;
+}
+
+int64_t MemBackend::__file_offset(uintptr_t phys_addr, size_t len)
+{
+    return phys_addr;
+}
+
+void* MemBackend::Map(uintptr_t phys_addr, size_t len, int mmap_flags,
+                      void*& mapping, size_t& mapping_len)
+{
+    int64_t offset = __file_offset(phys_addr, len);
+
+    if(fd < 0 || offset < 0)
+        return NULL;
+
+    void *addr = mmap(0, len, PROT_READ | PROT_WRITE, 
+                      MAP_SHARED | mmap_flags, fd, offset);
+
+    if(addr == MAP_FAILED)
+        return NULL;
+
+    mapping = addr;
+    mapping_len = len;
+    return addr;
+}
+
+int64_t MemBackend::WaitInterrupt(uint32_t timeout_us)
+{
+    return -1;
+}
+
+// ---------------------------------------------------------------------
+// DevMemBackend
+// ---------------------------------------------------------------------
+
+DevMemBackend::DevMemBackend(const std::string& path_)
+: MemBackend(path_)
+{}
+
+// ---------------------------------------------------------------------
+// UioBackend
+// ---------------------------------------------------------------------
+
+UioBackend::UioBackend(const std::string& path_)
+: MemBackend(path_),
+  regions(0)
+{}
+
+/// Read a hexadecimal value in a sysfs file
+static int read_sysfs_hex(const std::string& filename, uint64_t& value)
+{
+    FILE *file = fopen(filename.c_str(), "r");
+
+    if(file == NULL)
+        return -1;
+
+    unsigned long long val;
+    int ret = fscanf(file, "%llx", &val);
+    fclose(file);
+
+    if(ret != 1)
+        return -1;
+
+    value = val;
+    return 0;
+}
+
+int UioBackend::Open()
+{
+    if(MemBackend::Open() < 0)
+        return -1;
+
+    // /dev/uioN -> /sys/class/uio/uioN/maps/mapK
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    regions.clear();
+
+    for(unsigned int k=0; ; k++) {
+        std::string map_dir = "/sys/class/uio/" + name 
+                              + "/maps/map" + std::to_string(k) + "/";
+        uint64_t addr, size;
+
+        if(read_sysfs_hex(map_dir + "addr", addr) < 0
+           || read_sysfs_hex(map_dir + "size", size) < 0)
+            break;
+
+        Region region;
+        region.addr = addr;
+        region.size = size;
+        regions.push_back(region);
+    }
+
+    if(regions.empty()) {
+        fprintf(stderr, "No memory region for %s\n", path.c_str());
+        close(fd);
+        fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+void* UioBackend::Map(uintptr_t phys_addr, size_t len, int mmap_flags,
+                      void*& mapping, size_t& mapping_len)
+{
+    uint64_t mask = page_mask();
+
+    // The region K is mapped at the offset K * page_size,
+    // from the page containing its start.
+    for(unsigned int k=0; k<regions.size(); k++) {
+        uint64_t start = regions[k].addr & ~mask;
+        uint64_t end = (regions[k].addr + regions[k].size + mask) & ~mask;
+
+        if(phys_addr < start || phys_addr + len > end)
+            continue;
+
+        void *addr = mmap(0, end - start, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | mmap_flags, fd, k * (mask + 1));
+
+        if(addr == MAP_FAILED)
+            return NULL;
+
+        mapping = addr;
+        mapping_len = end - start;
+        return static_cast<char*>(addr) + (phys_addr - start);
+    }
+
+    return NULL;
+}
+
+int64_t UioBackend::WaitInterrupt(uint32_t timeout_us)
+{
+    if(fd < 0)
+        return -1;
+
+    // Enable the interrupt (not supported by all the drivers)
+    uint32_t enable = 1;
+
+    if(write(fd, &enable, sizeof(enable)) < 0 && errno != ENOSYS)
+        return -1;
+
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+
+    int ret = poll(&pfd, 1, (timeout_us + 999) / 1000);
+
+    if(ret < 0)
+        return -1;
+
+    if(ret == 0)
+        return 0;
+
+    uint32_t count;
+
+    if(read(fd, &count, sizeof(count)) != sizeof(count))
+        return -1;
+
+    return count;
+}
+
+// ---------------------------------------------------------------------
+// SimBackend
+// ---------------------------------------------------------------------
+
+SimBackend::SimBackend(const std::string& path_, uintptr_t base_, 
+                       uint64_t size_)
+: MemBackend(path_),
+  base(base_),
+  size(size_)
+{}
+
+int SimBackend::Open()
+{
+    if(fd >= 0)
+        return 0;
+
+    if((base & page_mask()) != 0 || size == 0) {
+        fprintf(stderr, "Invalid simulated memory [0x%llx, +0x%llx]\n",
+                (unsigned long long)base, (unsigned long long)size);
+        return -1;
+    }
+
+    if(path.empty()) {
+#ifdef SYS_memfd_create
+        fd = syscall(SYS_memfd_create, "kserver_mem", 0);
+#endif
+    } else {
+        fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    }
+
+    if(fd < 0) {
+        fprintf(stderr, "Can't open the simulated memory %s\n", 
+                path.empty() ? "(memfd)" : path.c_str());
+        return -1;
+    }
+
+    // Whole pages, else the accesses beyond the end raise SIGBUS
+    size = (size + page_mask()) & ~page_mask();
+
+    // An existing file is not truncated
+    struct stat st;
+
+    if(fstat(fd, &st) < 0 
+       || (static_cast<uint64_t>(st.st_size) < size 
+           && ftruncate(fd, size) < 0)) {
+        fprintf(stderr, "Can't size the simulated memory\n");
+        close(fd);
+        fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+int64_t SimBackend::__file_offset(uintptr_t phys_addr, size_t len)
+{
+    if(phys_addr < base || phys_addr - base + len > size)
+        return -1;
+
+    return phys_addr - base;
+}
+
+// ---------------------------------------------------------------------
+// Factory
+// ---------------------------------------------------------------------
+
+std::unique_ptr<MemBackend> MakeMemBackend(uint32_t kind, 
+                                           const std::string& path,
+                                           uintptr_t base, uint64_t size)
+{
+    switch(kind) {
+      case MEM_BACKEND_DEVMEM:
+        return std::unique_ptr<MemBackend>(
+                new DevMemBackend(path.empty() ? "/dev/mem" : path));
+      case MEM_BACKEND_UIO:
+        return std::unique_ptr<MemBackend>(
+                new UioBackend(path.empty() ? "/dev/uio0" : path));
+      case MEM_BACKEND_FILE:
+        if(path.empty())
+            return nullptr;
+
+        return std::unique_ptr<MemBackend>(new SimBackend(path, base, size));
+      case MEM_BACKEND_MEMFD:
+        return std::unique_ptr<MemBackend>(new SimBackend("", base, size));
+      default:
+        return nullptr;
+    }
+}
+
+}; // namespace Klib
@@ -0,0 +1,151 @@
+/// @file mem_backend.hpp
+///
+/// @brief Backends of the physical address space
+///
+/// The memory maps of DevMem are mapped from a backend:
+///     - /dev/mem: the physical memory (default),
+///     - UIO: the regions of a /dev/uioN device, with its interrupt,
+///     - file: a file simulating a physical address space,
+///     - memfd: an anonymous memory simulating a physical address space.
+/// The simulated backends run the register paths off-target.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __DRIVERS_CORE_MEM_BACKEND_HPP__
+#define __DRIVERS_CORE_MEM_BACKEND_HPP__
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+/// Kinds of backends
+typedef enum {
+    MEM_BACKEND_NONE,    ///< No physical memory access
+    MEM_BACKEND_DEVMEM,  ///< /dev/mem
+    MEM_BACKEND_UIO,     ///< /dev/uioN
+    MEM_BACKEND_FILE,    ///< Simulated in a file
+    MEM_BACKEND_MEMFD,   ///< Simulated in an anonymous memory
+    mem_backends_num
+} mem_backend_t;
+
+/// Names of the backends (configuration file)
+extern const char *mem_backends_names[mem_backends_num];
+
+/// @brief Interface of a backend
+class MemBackend
+{
+  public:
+    MemBackend(const std::string& path_);
+    virtual ~MemBackend();
+
+    /// @brief Open the backend
+    /// @return 0 if success, -1 else
+    virtual int Open();
+
+    /// @brief Map pages of the physical address space
+    /// @phys_addr Physical address (page aligned)
+    /// @len Length in octets (multiple of the page size)
+    /// @mmap_flags Additional mmap flags (MAP_POPULATE, MAP_HUGETLB)
+    /// @mapping Start of the mapped pages (to be unmapped with munmap)
+    /// @mapping_len Length of the mapped pages
+    /// @return The virtual address of phys_addr, or NULL if failure
+    virtual void* Map(uintptr_t phys_addr, size_t len, int mmap_flags,
+                      void*& mapping, size_t& mapping_len);
+
+    /// @brief Wait for an interrupt
+    /// @timeout_us Timeout in microseconds
+    /// @return The interrupts count, 0 if timeout, -1 if not supported
+    virtual int64_t WaitInterrupt(uint32_t timeout_us);
+
+    /// Name of the backend
+    virtual const char* Name() const = 0;
+
+    /// True if the physical address space is simulated
+    virtual bool IsSimulated() const {return false;}
+
+    /// Path of the device or file
+    inline const std::string& Path() const {return path;}
+
+  protected:
+    std::string path;
+    int fd;
+
+    /// Offset in the file of a physical address, -1 if out of the space
+    virtual int64_t __file_offset(uintptr_t phys_addr, size_t len);
+};
+
+/// /dev/mem
+class DevMemBackend : public MemBackend
+{
+  public:
+    DevMemBackend(const std::string& path_ = "/dev/mem");
+    const char* Name() const {return "devmem";}
+};
+
+/// @brief UIO device
+///
+/// The physical address space is the union of the regions of the
+/// device (/sys/class/uio/uioN/maps/mapK). The interrupt is enabled
+/// before each wait.
+class UioBackend : public MemBackend
+{
+  public:
+    UioBackend(const std::string& path_ = "/dev/uio0");
+
+    int Open();
+    void* Map(uintptr_t phys_addr, size_t len, int mmap_flags,
+              void*& mapping, size_t& mapping_len);
+    int64_t WaitInterrupt(uint32_t timeout_us);
+    const char* Name() const {return "uio";}
+
+  private:
+    struct Region
+    {
+        uintptr_t addr;
+        size_t size;
+    };
+
+    std::vector<Region> regions;
+};
+
+/// @brief Physical address space simulated in a file or a memfd
+///
+/// The physical address base is at the start of the file.
+class SimBackend : public MemBackend
+{
+  public:
+    /// @path File path, empty for a memfd
+    /// @base Physical address of the start of the space
+    /// @size Size of the space in octets
+    SimBackend(const std::string& path_, uintptr_t base_, uint64_t size_);
+
+    int Open();
+    const char* Name() const {return path.empty() ? "memfd" : "file";}
+    bool IsSimulated() const {return true;}
+
+  private:
+    uintptr_t base;
+    uint64_t size;
+
+    int64_t __file_offset(uintptr_t phys_addr, size_t len);
+};
+
+/// @brief Build a backend
+/// @kind A mem_backend_t
+/// @path Device or file path (default path if empty)
+/// @base, @size Simulated address space (file and memfd)
+/// @return NULL for MEM_BACKEND_NONE
+std::unique_ptr<MemBackend> MakeMemBackend(uint32_t kind, 
+                                           const std::string& path,
+                                           uintptr_t base, uint64_t size);
+
+}; // namespace Klib
+
+#endif // __DRIVERS_CORE_MEM_BACKEND_HPP__
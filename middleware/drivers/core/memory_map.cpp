@@ -9,30 +9,59 @@
 
 #include "memory_map.hpp"
 
-Klib::MemoryMap::MemoryMap(int *fd_, uint32_t dev_addr, uint32_t size_)
+Klib::MemoryMap::MemoryMap(MemBackend *backend_, intptr_t dev_addr, 
+                           uint32_t size_, uint32_t flags_)
 {
     size = size_;
-    fd = fd_;
+    backend = backend_;
+    flags = flags_;
+    phys_addr = dev_addr;
 
     if(dev_addr != 0x0) {
-        mapped_base = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 
-                           dev_addr & ~MAP_MASK(size) );
+        // Map the pages containing the range
+        intptr_t page_mask = sysconf(_SC_PAGESIZE) - 1;
+        intptr_t map_offset = dev_addr & ~page_mask;
+        mapped_len = (dev_addr + size - map_offset + page_mask) & ~page_mask;
 
-        if(mapped_base == (void *) -1) {
+        int mmap_flags = 0;
+
+        if(flags & MEMMAP_POPULATE)
+            mmap_flags |= MAP_POPULATE;
+
+        void *map_addr = NULL;
+
+        // Only memories backed by hugetlbfs support MAP_HUGETLB,
+        // else transparent huge pages are requested.
+        if(flags & MEMMAP_HUGE_PAGES)
+            map_addr = backend->Map(map_offset, mapped_len, 
+                                    mmap_flags | MAP_HUGETLB,
+                                    mapped_base, mapped_len);
+
+        if(map_addr == NULL)
+            map_addr = backend->Map(map_offset, mapped_len, mmap_flags,
+                                    mapped_base, mapped_len);
+
+        if(map_addr == NULL) {
             fprintf(stderr, "Can't map the memory to user space.\n");
-            close(*fd);
             status = MEMMAP_FAILURE;
             return;
         }
 
+#ifdef MADV_HUGEPAGE
+        if(flags & MEMMAP_HUGE_PAGES)
+            madvise(mapped_base, mapped_len, MADV_HUGEPAGE);
+#endif
+
         status = MEMMAP_OPENED;
 
-        // Device base address
-        mapped_dev_base = (intptr_t)mapped_base + (dev_addr & MAP_MASK(size));
+        // Device base address. The backend may map more pages
+        // than requested (UIO regions are mapped as a whole).
+        mapped_dev_base = (intptr_t)map_addr + (dev_addr - map_offset);
     } else {
         status = MEMMAP_CLOSED;
         mapped_base = NULL;
         mapped_dev_base = 0;
+        mapped_len = 0;
     }
 }
 
@@ -44,7 +73,7 @@ Klib::MemoryMap::~MemoryMap()
 int Klib::MemoryMap::Unmap()
 {
     if(status == MEMMAP_OPENED) {
-        munmap(mapped_base, size);
+        munmap(mapped_base, mapped_len);
         status = MEMMAP_CLOSED;
     }
 	
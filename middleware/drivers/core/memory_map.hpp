@@ -18,6 +18,8 @@ extern "C" {
     #include <sys/mman.h>
 }
 
+#include "mem_backend.hpp"
+
 /// @namespace Klib
 /// @brief Namespace of the Koheron library
 namespace Klib {
@@ -25,14 +27,24 @@ namespace Klib {
 #define DEFAULT_MAP_SIZE 4096UL // = PAGE_SIZE
 #define MAP_MASK(size) ((size) - 1)
 
+/// Flags of a memory map
+#define MEMMAP_POPULATE   (1 << 0) ///< Prefault the pages (MAP_POPULATE)
+#define MEMMAP_HUGE_PAGES (1 << 1) ///< Use huge pages when possible
+#define MEMMAP_FLAGS_MASK (MEMMAP_POPULATE | MEMMAP_HUGE_PAGES)
+
 /// @brief Memory map a device
+///
+/// The pages containing the range [dev_addr, dev_addr + size) are mapped.
 class MemoryMap
 {
 public:
     /// @brief Build a memory map
-    /// @dev_addr Physical base address of the device (XXX intptr_t better ?)
+    /// @backend_ Backend of the physical address space
+    /// @dev_addr Physical base address of the device
     /// @size_ Map size in octets
-    MemoryMap(int *fd_, uint32_t dev_addr, uint32_t size_ = DEFAULT_MAP_SIZE);
+    /// @flags_ Flags of the map (MEMMAP_POPULATE, MEMMAP_HUGE_PAGES)
+    MemoryMap(MemBackend *backend_, intptr_t dev_addr, uint32_t size_ = DEFAULT_MAP_SIZE,
+              uint32_t flags_ = 0);
 
     ~MemoryMap();
 
@@ -45,10 +57,16 @@ public:
     inline int GetStatus() const {return status;}
 
     /// @brief Return the virtual memory base address of the device
-    inline uint32_t GetBaseAddr() const {return mapped_dev_base;}
+    inline intptr_t GetBaseAddr() const {return mapped_dev_base;}
 
     /// @brief Return the mapped size in octets
     inline uint32_t MappedSize() const {return size;}
+
+    /// @brief Return the physical base address of the device
+    inline intptr_t GetPhysAddr() const {return phys_addr;}
+
+    /// @brief Return the flags of the map
+    inline uint32_t GetFlags() const {return flags;}
 	
     enum Status {
         MEMMAP_CLOSED,       ///< Memory map closed
@@ -58,11 +76,14 @@ public:
     };
 
 private:
-    int *fd;                    ///< /dev/mem file ID (Why is this a pointer ?)
+    MemBackend *backend;        ///< Backend of the physical address space
     void* mapped_base;          ///< Map base address
-    uint32_t mapped_dev_base;   ///< Device base address
+    intptr_t mapped_dev_base;   ///< Device base address
+    intptr_t phys_addr;         ///< Device physical address
     int status;                 ///< Status
     uint32_t size;              ///< Map size
+    uint32_t flags;             ///< Flags of the map
+    size_t mapped_len;          ///< Length of the mapped pages
 };
 
 }; // namespace Klib
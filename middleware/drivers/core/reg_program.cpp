@@ -0,0 +1,361 @@
+/// @file reg_program.cpp
+///
+/// @brief Implementation of reg_program.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "reg_program.hpp"
+
+#include "wr_register.hpp"
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+/// Number of operands of each instruction
+static const uint32_t operands_num[reg_opcodes_num] = {
+    3, // WRITE
+    3, // MASK_AND
+    3, // MASK_OR
+    3, // SET_BIT
+    3, // CLEAR_BIT
+    5, // WAIT_BIT
+    2, // READ
+    3, // READ_BUFFER
+    1, // LOOP
+    0, // END_LOOP
+    1  // DELAY
+};
+
+/// True if the instruction accesses a register
+static inline bool is_register_access(uint32_t opcode)
+{
+    return opcode < REG_LOOP;
+}
+
+/// @brief Check the values of the operands
+/// @flags Operands given as parameters are not checked
+static bool are_operands_valid(uint32_t opcode, const uint32_t *operands,
+                               uint32_t flags)
+{
+    for(uint32_t k=0; k<operands_num[opcode]; k++) {
+        if(flags & (1 << k))
+            continue;
+
+        uint32_t val = operands[k];
+
+        switch(opcode) {
+          case REG_SET_BIT:
+          case REG_CLEAR_BIT:
+            if(k == 2 && val >= 32)
+                return false;
+            break;
+          case REG_WAIT_BIT:
+            if((k == 2 && val >= 32) || (k == 3 && val > 1)
+               || (k == 4 && val > REG_PROGRAM_MAX_DURATION))
+                return false;
+            break;
+          case REG_READ_BUFFER:
+            if(k == 2 && val > REG_PROGRAM_MAX_OUTPUT)
+                return false;
+            break;
+          case REG_DELAY:
+            if(val > REG_PROGRAM_MAX_DURATION)
+                return false;
+            break;
+        }
+    }
+
+    return true;
+}
+
+RegProgram::RegProgram()
+: params_num(0)
+, instructions(0)
+{}
+
+int RegProgram::Load(const uint32_t *code, uint32_t len)
+{
+    instructions.clear();
+
+    if(len == 0 || len > REG_PROGRAM_MAX_LEN)
+        return 0;
+
+    params_num = code[0];
+
+    if(params_num > REG_PROGRAM_MAX_PARAMS)
+        return 0;
+
+    std::vector<uint32_t> loops; // Indices of the open LOOP
+    uint32_t i = 1;
+
+    while(i < len) {
+        Instruction instr;
+        instr.opcode = code[i] & 0xFF;
+        instr.params_flags = (code[i] >> 8) & 0xFF;
+        instr.operands.fill(0);
+        instr.jump = 0;
+
+        if((code[i] >> 16) != 0 || instr.opcode >= reg_opcodes_num)
+            goto reject;
+
+        uint32_t n = operands_num[instr.opcode];
+
+        if((instr.params_flags >> n) != 0 || i + n >= len)
+            goto reject;
+
+        for(uint32_t k=0; k<n; k++) {
+            instr.operands[k] = code[i + 1 + k];
+
+            if((instr.params_flags & (1 << k))
+               && instr.operands[k] >= params_num) {
+                i += 1 + k;
+                goto reject;
+            }
+        }
+
+        if(!are_operands_valid(instr.opcode, &code[i+1], instr.params_flags))
+            goto reject;
+
+        if(instr.opcode == REG_LOOP) {
+            if(loops.size() >= REG_PROGRAM_MAX_DEPTH)
+                goto reject;
+
+            loops.push_back(instructions.size());
+        } else if(instr.opcode == REG_END_LOOP) {
+            if(loops.empty())
+                goto reject;
+
+            instr.jump = loops.back();
+            instructions[loops.back()].jump = instructions.size();
+            loops.pop_back();
+        }
+
+        instructions.push_back(instr);
+        i += 1 + n;
+    }
+
+    // Unterminated loop
+    if(!loops.empty())
+        goto reject;
+
+    return -1;
+
+reject:
+    instructions.clear();
+    params_num = 0;
+    return i;
+}
+
+int RegProgram::__bind(DevMem& dev_mem, const uint32_t *params,
+                       std::vector<BoundInstruction>& bound) const
+{
+    // Worst-case steps, output size and duration.
+    // Each instruction is accounted for the
+    // iterations of all the enclosing loops.
+    uint64_t steps = 0;
+    uint64_t output_size = 0;
+    uint64_t duration = 0;
+    std::vector<uint64_t> iterations(1, 1);
+
+    bound.resize(instructions.size());
+
+    for(unsigned int i=0; i<instructions.size(); i++) {
+        const Instruction& instr = instructions[i];
+        BoundInstruction& bound_instr = bound[i];
+
+        bound_instr.opcode = instr.opcode;
+
+        for(uint32_t k=0; k<REG_MAX_OPERANDS; k++)
+            bound_instr.operands[k] = (instr.params_flags & (1 << k)) ?
+                                      params[instr.operands[k]] :
+                                      instr.operands[k];
+
+        if(!are_operands_valid(instr.opcode, bound_instr.operands.data(), 0))
+            return -1;
+
+        if(is_register_access(instr.opcode)) {
+            bound_instr.mmap_idx = bound_instr.operands[0];
+
+            if(!dev_mem.HasMemMap(bound_instr.mmap_idx))
+                return -1;
+
+            // The registers accessed must lie within the memory map
+            uint64_t words = instr.opcode == REG_READ_BUFFER ?
+                             bound_instr.operands[2] : 1;
+
+            if(bound_instr.operands[1] + words * sizeof(uint32_t)
+               > dev_mem.GetSize(bound_instr.mmap_idx))
+                return -1;
+
+            bound_instr.addr = dev_mem.GetBaseAddr(bound_instr.mmap_idx)
+                               + bound_instr.operands[1];
+        }
+
+        uint64_t iter = iterations.back();
+        steps += iter;
+
+        switch(instr.opcode) {
+          case REG_WAIT_BIT:
+            duration += iter * bound_instr.operands[4];
+            break;
+          case REG_READ:
+            output_size += iter;
+            break;
+          case REG_READ_BUFFER:
+            output_size += iter * bound_instr.operands[2];
+            break;
+          case REG_LOOP:
+            // Saturated to avoid overflows with nested loops
+            if(bound_instr.operands[0] != 0 
+               && iter > REG_PROGRAM_MAX_STEPS / bound_instr.operands[0])
+                iterations.push_back(REG_PROGRAM_MAX_STEPS + 1);
+            else
+                iterations.push_back(iter * bound_instr.operands[0]);
+            break;
+          case REG_END_LOOP:
+            iterations.pop_back();
+            break;
+          case REG_DELAY:
+            duration += iter * bound_instr.operands[0];
+            break;
+        }
+
+        if(steps > REG_PROGRAM_MAX_STEPS
+           || output_size > REG_PROGRAM_MAX_OUTPUT
+           || duration > REG_PROGRAM_MAX_DURATION)
+            return -1;
+    }
+
+    return 0;
+}
+
+bool RegProgram::__yield(DevMem& dev_mem,
+                         std::vector<BoundInstruction>& bound,
+                         RegLocker *locker, uint32_t sleep_us)
+{
+    if(locker == nullptr) {
+        std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+        return true;
+    }
+
+    locker->release();
+    std::this_thread::sleep_for(std::chrono::microseconds(sleep_us));
+    locker->reacquire();
+
+    // A memory map may have been moved to a new mapping
+    for(BoundInstruction& instr : bound) {
+        if(!is_register_access(instr.opcode))
+            continue;
+
+        intptr_t base_addr = dev_mem.GetBaseAddr(instr.mmap_idx);
+
+        if(base_addr == 0)
+            return false;
+
+        instr.addr = base_addr + instr.operands[1];
+    }
+
+    return true;
+}
+
+#define LOCK_MMAP(instr)                \
+    if(locker != nullptr)               \
+        locker->lock(instr.mmap_idx);
+
+#define UNLOCK_MMAP(instr)              \
+    if(locker != nullptr)               \
+        locker->unlock(instr.mmap_idx);
+
+int RegProgram::Run(DevMem& dev_mem, const uint32_t *params,
+                    uint32_t params_num_, std::vector<uint32_t>& output,
+                    RegLocker *locker) const
+{
+    std::vector<BoundInstruction> bound;
+
+    if(params_num_ != params_num || __bind(dev_mem, params, bound) < 0)
+        return REG_PROGRAM_INVALID;
+
+    std::array<uint32_t, REG_PROGRAM_MAX_DEPTH> counters;
+    unsigned int depth = 0;
+
+    for(unsigned int pc=0; pc<bound.size(); pc++) {
+        const BoundInstruction& instr = bound[pc];
+        const uint32_t *ops = instr.operands.data();
+
+        switch(instr.opcode) {
+          case REG_WRITE:
+            WriteReg32(instr.addr, ops[2]);
+            break;
+          case REG_MASK_AND:
+            LOCK_MMAP(instr)
+            MaskAnd(instr.addr, ops[2]);
+            UNLOCK_MMAP(instr)
+            break;
+          case REG_MASK_OR:
+            LOCK_MMAP(instr)
+            MaskOr(instr.addr, ops[2]);
+            UNLOCK_MMAP(instr)
+            break;
+          case REG_SET_BIT:
+            LOCK_MMAP(instr)
+            SetBit(instr.addr, ops[2]);
+            UNLOCK_MMAP(instr)
+            break;
+          case REG_CLEAR_BIT:
+            LOCK_MMAP(instr)
+            ClearBit(instr.addr, ops[2]);
+            UNLOCK_MMAP(instr)
+            break;
+          case REG_WAIT_BIT: {
+            uint32_t mask = 1U << ops[2];
+            uint32_t value = ops[3] << ops[2];
+            uint32_t reg_val;
+            int64_t duration = PollReg32(instr.addr,
+                                         [mask, value](uint32_t val) {
+                return (val & mask) == value;
+            }, ops[4], reg_val, REG_PROGRAM_WAIT_SLICE, [&]() {
+                return __yield(dev_mem, bound, locker) ? instr.addr : 0;
+            });
+
+            if(duration == -2)
+                return REG_PROGRAM_ABORTED;
+
+            if(duration < 0)
+                return REG_PROGRAM_TIMEOUT;
+
+            break;
+          }
+          case REG_READ:
+            output.push_back(ReadReg32(instr.addr));
+            break;
+          case REG_READ_BUFFER:
+            for(uint32_t i=0; i<ops[2]; i++)
+                output.push_back(ReadReg32(instr.addr + sizeof(uint32_t)*i));
+            break;
+          case REG_LOOP:
+            if(ops[0] == 0)
+                pc = instructions[pc].jump; // Skip the loop
+            else
+                counters[depth++] = ops[0];
+            break;
+          case REG_END_LOOP:
+            if(--counters[depth-1] > 0)
+                pc = instructions[pc].jump; // Next iteration
+            else
+                depth--;
+            break;
+          case REG_DELAY:
+            if(!__yield(dev_mem, bound, locker, ops[0]))
+                return REG_PROGRAM_ABORTED;
+
+            break;
+        }
+    }
+
+    return REG_PROGRAM_OK;
+}
+
+}; // namespace Klib
@@ -0,0 +1,179 @@
+/// @file reg_program.hpp
+///
+/// @brief Programs of registers accesses
+///
+/// A program is a sequence of registers accesses executed in one go,
+/// instead of one request per access. It is verified when loaded,
+/// and checked against the parameters and the memory maps before
+/// each run, so that a running program never accesses an invalid
+/// memory map nor runs for an unbounded duration.
+///
+/// Bytecode (32 bits words):
+///
+///     params_num | instr_0 | operands_0 ... | instr_1 | operands_1 ...
+///
+/// An instruction word holds the opcode in bits [0:7]. Bit 8+k set
+/// indicates that the operand k is the index of a parameter given at
+/// run time, instead of a literal value.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __DRIVERS_CORE_REG_PROGRAM_HPP__
+#define __DRIVERS_CORE_REG_PROGRAM_HPP__
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "dev_mem.hpp"
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+/// Maximum number of words of a program
+#define REG_PROGRAM_MAX_LEN 4096
+
+/// Maximum number of parameters of a program
+#define REG_PROGRAM_MAX_PARAMS 16
+
+/// Maximum nesting of the loops
+#define REG_PROGRAM_MAX_DEPTH 8
+
+/// Maximum number of instructions executed by a run
+#define REG_PROGRAM_MAX_STEPS (1 << 24)
+
+/// Maximum number of words read by a run
+#define REG_PROGRAM_MAX_OUTPUT (1 << 20)
+
+/// Maximum duration of the delays and timeouts of a run (us)
+#define REG_PROGRAM_MAX_DURATION 10000000
+
+/// Maximum duration of a WAIT_BIT slice (us), the locks are
+/// released in between two slices (see RegLocker)
+#define REG_PROGRAM_WAIT_SLICE 10000
+
+/// Number of operands of the longest instruction (WAIT_BIT)
+#define REG_MAX_OPERANDS 5
+
+/// Instructions
+///
+/// Operands:
+///     WRITE        mmap_idx, offset, value
+///     MASK_AND     mmap_idx, offset, mask
+///     MASK_OR      mmap_idx, offset, mask
+///     SET_BIT      mmap_idx, offset, index
+///     CLEAR_BIT    mmap_idx, offset, index
+///     WAIT_BIT     mmap_idx, offset, index, level, timeout_us
+///     READ         mmap_idx, offset
+///     READ_BUFFER  mmap_idx, offset, buff_size
+///     LOOP         count
+///     END_LOOP
+///     DELAY        duration_us
+typedef enum {
+    REG_WRITE,
+    REG_MASK_AND,
+    REG_MASK_OR,
+    REG_SET_BIT,
+    REG_CLEAR_BIT,
+    REG_WAIT_BIT,
+    REG_READ,
+    REG_READ_BUFFER,
+    REG_LOOP,
+    REG_END_LOOP,
+    REG_DELAY,
+    reg_opcodes_num
+} reg_opcode_t;
+
+/// Status of a run
+typedef enum {
+    REG_PROGRAM_OK,       ///< Program completed
+    REG_PROGRAM_TIMEOUT,  ///< A WAIT_BIT timed out
+    REG_PROGRAM_INVALID,  ///< Invalid parameters or registers, nothing executed
+    REG_PROGRAM_ABORTED,  ///< A memory map was removed during a wait
+    reg_program_status_num
+} reg_program_status_t;
+
+/// @brief Lock of the memory maps
+///
+/// Taken around the read-modify-write instructions.
+///
+/// The lock of the memory maps table, held by the caller during
+/// the run, is released during the DELAY and in between the slices
+/// of the WAIT_BIT. The memory maps are checked again once retaken.
+struct RegLocker
+{
+    virtual ~RegLocker() {}
+    virtual void lock(MemMapID mmap_idx) = 0;
+    virtual void unlock(MemMapID mmap_idx) = 0;
+
+    /// Release the lock of the memory maps table
+    virtual void release() {}
+    /// Take back the lock of the memory maps table
+    virtual void reacquire() {}
+};
+
+class RegProgram
+{
+  public:
+    RegProgram();
+
+    /// @brief Verify and load a bytecode
+    /// @code The bytecode
+    /// @len Number of words of the bytecode
+    /// @return -1 if the program is valid,
+    ///         else the index of the rejected word
+    int Load(const uint32_t *code, uint32_t len);
+
+    /// @brief Run the program
+    /// @dev_mem Memory maps manager
+    /// @params Parameters of the run
+    /// @params_num Number of parameters (must be ParamsNum())
+    /// @output Values read by READ and READ_BUFFER are appended
+    /// @locker Locks of the memory maps (NULL if not required)
+    /// @return A reg_program_status_t
+    int Run(DevMem& dev_mem, const uint32_t *params, uint32_t params_num,
+            std::vector<uint32_t>& output, RegLocker *locker) const;
+
+    /// Number of parameters of the program
+    inline uint32_t ParamsNum() const {return params_num;}
+
+  private:
+    struct Instruction
+    {
+        uint32_t opcode;
+        uint32_t params_flags;
+        std::array<uint32_t, REG_MAX_OPERANDS> operands;
+        uint32_t jump; ///< Matching LOOP/END_LOOP
+    };
+
+    /// Instruction with the parameters and addresses resolved
+    struct BoundInstruction
+    {
+        uint32_t opcode;
+        MemMapID mmap_idx;
+        intptr_t addr;
+        std::array<uint32_t, REG_MAX_OPERANDS> operands;
+    };
+
+    uint32_t params_num;
+    std::vector<Instruction> instructions;
+
+    /// Resolve the operands and check the limits of a run
+    int __bind(DevMem& dev_mem, const uint32_t *params,
+               std::vector<BoundInstruction>& bound) const;
+
+    /// @brief Release the lock of the memory maps table, sleep and retake it
+    ///
+    /// The addresses of the instructions are resolved again.
+    /// @return false if a memory map of the run has been removed
+    static bool __yield(DevMem& dev_mem,
+                        std::vector<BoundInstruction>& bound,
+                        RegLocker *locker, uint32_t sleep_us = 0);
+}; // RegProgram
+
+}; // namespace Klib
+
+#endif // __DRIVERS_CORE_REG_PROGRAM_HPP__
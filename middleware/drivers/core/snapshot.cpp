@@ -0,0 +1,94 @@
+/// @file snapshot.cpp
+///
+/// @brief Implementation of snapshot.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "snapshot.hpp"
+
+#include <cstdlib>
+
+#include "wr_register.hpp"
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+Snapshot::Snapshot(uint32_t size_)
+: data(NULL)
+, size(size_)
+, seq(0)
+{
+    void *ptr;
+
+    if(posix_memalign(&ptr, SNAPSHOT_ALIGNMENT, sizeof(uint32_t) * size) == 0)
+        data = static_cast<uint32_t*>(ptr);
+}
+
+Snapshot::~Snapshot()
+{
+    free(data);
+}
+
+SnapshotPool::SnapshotPool(uint32_t size_, uint32_t buffers_num)
+: size(size_)
+, seq(0)
+, buffers(0)
+, latest(nullptr)
+{
+    for(uint32_t i=0; i<buffers_num; i++)
+        buffers.push_back(std::make_shared<Snapshot>(size));
+}
+
+bool SnapshotPool::IsValid() const
+{
+    for(auto& buffer : buffers)
+        if(buffer->data == NULL)
+            return false;
+
+    return !buffers.empty();
+}
+
+uint32_t SnapshotPool::Acquire(intptr_t addr, uint32_t mode)
+{
+    std::lock_guard<std::mutex> acquire_lock(acquire_mutex);
+    std::shared_ptr<Snapshot> buffer;
+
+    {
+        // The readers take their references under the
+        // mutex: a buffer only referenced by the pool
+        // can't be read until it is published.
+        std::lock_guard<std::mutex> lock(mutex);
+
+        for(auto& candidate : buffers) {
+            if(candidate != latest && candidate.use_count() == 1) {
+                buffer = candidate;
+                break;
+            }
+        }
+    }
+
+    if(buffer == nullptr)
+        return 0;
+
+    ReadBuff(addr, buffer->data, size, mode);
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(++seq == 0) // 0 is reserved for failures
+        seq = 1;
+
+    buffer->seq = seq;
+    latest = buffer;
+    return seq;
+}
+
+std::shared_ptr<const Snapshot> SnapshotPool::Latest()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return latest;
+}
+
+}; // namespace Klib
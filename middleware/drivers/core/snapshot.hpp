@@ -0,0 +1,92 @@
+/// @file snapshot.hpp
+///
+/// @brief Snapshots of a memory region
+///
+/// A snapshot is a copy of a memory region in a staging buffer,
+/// made with the bulk transfer kernels. The snapshot is sent to the
+/// clients while the next acquisitions are made in the other buffers
+/// of the pool, so a snapshot is never modified while it is read.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __DRIVERS_CORE_SNAPSHOT_HPP__
+#define __DRIVERS_CORE_SNAPSHOT_HPP__
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+/// Minimum number of buffers of a pool
+#define SNAPSHOT_MIN_BUFFERS 2
+
+/// Maximum number of buffers of a pool
+#define SNAPSHOT_MAX_BUFFERS 8
+
+/// Alignment of the staging buffers (octets)
+#define SNAPSHOT_ALIGNMENT 64
+
+/// A staging buffer
+struct Snapshot
+{
+    Snapshot(uint32_t size_);
+    ~Snapshot();
+
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    uint32_t *data; ///< Aligned buffer (NULL if allocation failed)
+    uint32_t size;  ///< Number of 32 bits words
+    uint32_t seq;   ///< Sequence number of the acquisition
+};
+
+/// @brief Pool of staging buffers of a memory region
+///
+/// The buffers are preallocated. An acquisition copies the region into
+/// a buffer which is neither the latest snapshot nor read by a client,
+/// then publishes it as the latest snapshot.
+class SnapshotPool
+{
+  public:
+    /// @brief Allocate the buffers
+    /// @size Number of 32 bits words of a snapshot
+    /// @buffers_num Number of staging buffers
+    SnapshotPool(uint32_t size, uint32_t buffers_num);
+
+    /// True if all the buffers are allocated
+    bool IsValid() const;
+
+    /// @brief Copy the region into a free buffer
+    /// @addr Absolute address of the region
+    /// @mode Access mode of the memory map (access_mode_t)
+    /// @return The sequence number of the snapshot (> 0),
+    ///         or 0 if all the buffers are in use
+    uint32_t Acquire(intptr_t addr, uint32_t mode);
+
+    /// @brief The latest snapshot
+    /// @return NULL if no acquisition was made
+    ///
+    /// The buffer isn't reused while the pointer is held.
+    std::shared_ptr<const Snapshot> Latest();
+
+    /// Number of 32 bits words of a snapshot
+    inline uint32_t Size() const {return size;}
+
+  private:
+    uint32_t size;
+    uint32_t seq;
+    std::mutex acquire_mutex; ///< Serializes the acquisitions
+    std::mutex mutex;         ///< Protects latest and the buffers references
+    std::vector< std::shared_ptr<Snapshot> > buffers;
+    std::shared_ptr<Snapshot> latest;
+}; // SnapshotPool
+
+}; // namespace Klib
+
+#endif // __DRIVERS_CORE_SNAPSHOT_HPP__
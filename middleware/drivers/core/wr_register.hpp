@@ -5,8 +5,22 @@
 #ifndef __DRIVERS_CORE_WR_REGISTER_HPP__
 #define __DRIVERS_CORE_WR_REGISTER_HPP__
 
+#include <algorithm>
 #include <bitset>
 #include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define KLIB_HAS_NEON 1
+#endif
 
 /// @namespace Klib
 /// @brief Namespace of the Koheron library
@@ -19,7 +33,7 @@ namespace Klib {
 /// @RegVal Value to be written (uint32)
 inline void WriteReg32(intptr_t addr, uint32_t reg_val)
 {
-    *(volatile intptr_t *) addr = reg_val;
+    *(volatile uint32_t *) addr = reg_val;
 }
 
 /// Write a value in a 32 bits register
@@ -27,18 +41,22 @@ inline void WriteReg32(intptr_t addr, uint32_t reg_val)
 /// @reg_val Value to be written (bitset<32>)
 inline void WriteReg32(intptr_t addr, std::bitset<32> reg_val)
 {
-    *(volatile intptr_t *) addr = reg_val.to_ulong();
+    *(volatile uint32_t *) addr = reg_val.to_ulong();
 }
 
 /// Write a buffer of 32 bits registers
 /// @addr Absolute address of the first register of the buffer
 /// @data_ptr Pointer to the data to be written
 /// @buff_size Number of data to write in the buffer
+///
+/// Strict 32 bits accesses, also on 64 bits hosts
 inline void WriteBuff32(intptr_t addr, const uint32_t *data_ptr, 
                         uint32_t buff_size)
 {
+    volatile uint32_t *dst = (volatile uint32_t *) addr;
+
     for(uint32_t i=0; i < buff_size; i++) {
-        WriteReg32(addr + sizeof(uint32_t)*i, data_ptr[i]);
+        dst[i] = data_ptr[i];
     }
 }
 
@@ -46,7 +64,209 @@ inline void WriteBuff32(intptr_t addr, const uint32_t *data_ptr,
 /// @addr Absolute address of the register to be read
 inline uint32_t ReadReg32(intptr_t addr)
 {
-    return *(volatile intptr_t *) addr;
+    return *(volatile uint32_t *) addr;
+}
+
+// -- Bulk transfers
+//
+// Kernels copying a buffer between a mapped region and the memory.
+// Wider accesses require less bus transactions, but some regions
+// only support 32 bits accesses: the access mode is chosen per memory map.
+//
+// The mapped address is aligned on the access width with 32 bits
+// accesses first. The memory buffer has no alignment requirement.
+
+/// Access modes of the bulk transfers
+typedef enum {
+    ACCESS_32,      ///< Strict 32 bits accesses
+    ACCESS_64,      ///< 64 bits accesses
+    ACCESS_VECTOR,  ///< 128 bits accesses (SSE2 or NEON, else 64 bits)
+    ACCESS_STREAM,  ///< 128 bits non-temporal accesses (SSE only, else VECTOR)
+    access_modes_num
+} access_mode_t;
+
+/// Number of 32 bits words before the address is aligned
+/// @addr Absolute address
+/// @width Alignment in octets
+/// @buff_size Number of words of the buffer
+inline uint32_t __HeadSize(intptr_t addr, uint32_t width, uint32_t buff_size)
+{
+    uint32_t misalign = static_cast<uint32_t>(addr) & (width - 1);
+    uint32_t head = misalign == 0 ? 0 : (width - misalign) / sizeof(uint32_t);
+    return std::min(head, buff_size);
+}
+
+/// Read a buffer with strict 32 bits accesses
+/// @addr Absolute address of the first register of the buffer
+/// @data_ptr Destination buffer
+/// @buff_size Number of 32 bits words to read
+inline void ReadBuff32(intptr_t addr, uint32_t *data_ptr, uint32_t buff_size)
+{
+    const volatile uint32_t *src = (const volatile uint32_t *) addr;
+
+    for(uint32_t i=0; i < buff_size; i++)
+        data_ptr[i] = src[i];
+}
+
+/// Read a buffer with 64 bits accesses
+inline void ReadBuff64(intptr_t addr, uint32_t *data_ptr, uint32_t buff_size)
+{
+    uint32_t head = __HeadSize(addr, 8, buff_size);
+    ReadBuff32(addr, data_ptr, head);
+
+    const volatile uint64_t *src = (const volatile uint64_t *) 
+                                        (addr + sizeof(uint32_t) * head);
+    uint32_t *dst = data_ptr + head;
+    uint32_t n = (buff_size - head) / 2;
+
+    for(uint32_t i=0; i < n; i++) {
+        uint64_t val = src[i];
+        memcpy(dst + 2*i, &val, sizeof(val));
+    }
+
+    ReadBuff32(addr + sizeof(uint32_t) * (head + 2*n), dst + 2*n,
+               buff_size - head - 2*n);
+}
+
+/// Read a buffer with 128 bits accesses
+/// @stream Use non-temporal loads (write-combining regions)
+inline void ReadBuff128(intptr_t addr, uint32_t *data_ptr, uint32_t buff_size,
+                        bool stream = false)
+{
+#if defined(__SSE2__) || KLIB_HAS_NEON
+    uint32_t head = __HeadSize(addr, 16, buff_size);
+    ReadBuff32(addr, data_ptr, head);
+
+    intptr_t src = addr + sizeof(uint32_t) * head;
+    uint32_t *dst = data_ptr + head;
+    uint32_t n = (buff_size - head) / 4;
+
+    for(uint32_t i=0; i < n; i++) {
+#if defined(__SSE2__)
+#if defined(__SSE4_1__)
+        if(stream) {
+            _mm_storeu_si128((__m128i *) (dst + 4*i),
+                             _mm_stream_load_si128((__m128i *) src + i));
+            continue;
+        }
+#endif
+        _mm_storeu_si128((__m128i *) (dst + 4*i),
+                         *((const volatile __m128i *) src + i));
+#else
+        vst1q_u32(dst + 4*i, *((const volatile uint32x4_t *) src + i));
+#endif
+    }
+
+    ReadBuff32(addr + sizeof(uint32_t) * (head + 4*n), dst + 4*n,
+               buff_size - head - 4*n);
+#else
+    ReadBuff64(addr, data_ptr, buff_size);
+#endif
+}
+
+/// Write a buffer with 64 bits accesses
+inline void WriteBuff64(intptr_t addr, const uint32_t *data_ptr,
+                        uint32_t buff_size)
+{
+    uint32_t head = __HeadSize(addr, 8, buff_size);
+    WriteBuff32(addr, data_ptr, head);
+
+    volatile uint64_t *dst = (volatile uint64_t *) 
+                                (addr + sizeof(uint32_t) * head);
+    const uint32_t *src = data_ptr + head;
+    uint32_t n = (buff_size - head) / 2;
+
+    for(uint32_t i=0; i < n; i++) {
+        uint64_t val;
+        memcpy(&val, src + 2*i, sizeof(val));
+        dst[i] = val;
+    }
+
+    WriteBuff32(addr + sizeof(uint32_t) * (head + 2*n), src + 2*n,
+                buff_size - head - 2*n);
+}
+
+/// Write a buffer with 128 bits accesses
+/// @stream Use non-temporal stores (write-combining regions, staging buffers)
+inline void WriteBuff128(intptr_t addr, const uint32_t *data_ptr,
+                         uint32_t buff_size, bool stream = false)
+{
+#if defined(__SSE2__) || KLIB_HAS_NEON
+    uint32_t head = __HeadSize(addr, 16, buff_size);
+    WriteBuff32(addr, data_ptr, head);
+
+    intptr_t dst = addr + sizeof(uint32_t) * head;
+    const uint32_t *src = data_ptr + head;
+    uint32_t n = (buff_size - head) / 4;
+
+#if defined(__SSE2__)
+    if(stream) {
+        for(uint32_t i=0; i < n; i++)
+            _mm_stream_si128((__m128i *) dst + i,
+                             _mm_loadu_si128((const __m128i *) (src + 4*i)));
+
+        _mm_sfence();
+    } else {
+        for(uint32_t i=0; i < n; i++)
+            *((volatile __m128i *) dst + i) = 
+                    _mm_loadu_si128((const __m128i *) (src + 4*i));
+    }
+#else
+    for(uint32_t i=0; i < n; i++)
+        *((volatile uint32x4_t *) dst + i) = vld1q_u32(src + 4*i);
+#endif
+
+    WriteBuff32(addr + sizeof(uint32_t) * (head + 4*n), src + 4*n,
+                buff_size - head - 4*n);
+#else
+    WriteBuff64(addr, data_ptr, buff_size);
+#endif
+}
+
+/// Read a buffer with an access mode
+/// @addr Absolute address of the first register of the buffer
+/// @data_ptr Destination buffer
+/// @buff_size Number of 32 bits words to read
+/// @mode An access_mode_t
+inline void ReadBuff(intptr_t addr, uint32_t *data_ptr, uint32_t buff_size,
+                     uint32_t mode)
+{
+    switch(mode) {
+      case ACCESS_64:
+        ReadBuff64(addr, data_ptr, buff_size);
+        break;
+      case ACCESS_VECTOR:
+        ReadBuff128(addr, data_ptr, buff_size);
+        break;
+      case ACCESS_STREAM:
+        ReadBuff128(addr, data_ptr, buff_size, true);
+        break;
+      default:
+        ReadBuff32(addr, data_ptr, buff_size);
+    }
+}
+
+/// Write a buffer with an access mode
+/// @addr Absolute address of the first register of the buffer
+/// @data_ptr Data to be written
+/// @buff_size Number of 32 bits words to write
+/// @mode An access_mode_t
+inline void WriteBuff(intptr_t addr, const uint32_t *data_ptr,
+                      uint32_t buff_size, uint32_t mode)
+{
+    switch(mode) {
+      case ACCESS_64:
+        WriteBuff64(addr, data_ptr, buff_size);
+        break;
+      case ACCESS_VECTOR:
+        WriteBuff128(addr, data_ptr, buff_size);
+        break;
+      case ACCESS_STREAM:
+        WriteBuff128(addr, data_ptr, buff_size, true);
+        break;
+      default:
+        WriteBuff32(addr, data_ptr, buff_size);
+    }
 }
 
 // -- Bit manipulations
@@ -58,7 +278,7 @@ inline uint32_t ReadReg32(intptr_t addr)
 /// @index Index of the bit in the register
 inline void SetBit(intptr_t addr, uint32_t index)
 {
-    *(volatile intptr_t *) addr = *((volatile intptr_t *) addr) | (1 << index);
+    *(volatile uint32_t *) addr = *((volatile uint32_t *) addr) | (1 << index);
 }
 
 /// Clear a bit in a 32 bits register
@@ -66,7 +286,7 @@ inline void SetBit(intptr_t addr, uint32_t index)
 /// @index Index of the bit in the register
 inline void ClearBit(intptr_t addr, uint32_t index)
 {
-    *(volatile intptr_t *) addr = *((volatile intptr_t *) addr) & ~(1 << index);
+    *(volatile uint32_t *) addr = *((volatile uint32_t *) addr) & ~(1 << index);
 }
 
 /// Toggle a bit in a 32 bits register
@@ -74,7 +294,7 @@ inline void ClearBit(intptr_t addr, uint32_t index)
 /// @index Index of the bit in the register
 inline void ToggleBit(intptr_t addr, uint32_t index)
 {
-    *(volatile intptr_t *) addr = *((volatile intptr_t *) addr) ^ (1 << index);
+    *(volatile uint32_t *) addr = *((volatile uint32_t *) addr) ^ (1 << index);
 }
 
 /// Obtain the value of a bit
@@ -82,19 +302,125 @@ inline void ToggleBit(intptr_t addr, uint32_t index)
 /// @index Index of the bit in the register
 inline bool ReadBit(intptr_t addr, uint32_t index)
 {
-    return *((volatile intptr_t *) addr) & (1 << index);
+    return *((volatile uint32_t *) addr) & (1 << index);
 }
 
 // -- Masks
 
 inline void MaskAnd(intptr_t addr, uint32_t mask)
 {
-    *(volatile intptr_t *) addr &= mask;
+    *(volatile uint32_t *) addr &= mask;
 }
 
 inline void MaskOr(intptr_t addr, uint32_t mask)
 {
-    *(volatile intptr_t *) addr |= mask;
+    *(volatile uint32_t *) addr |= mask;
+}
+
+// -- Polling
+
+/// Number of register reads before sleeping in PollReg32
+#define KLIB_WAIT_SPIN_NUM 256
+
+/// Maximum sleeping duration in between two reads (us)
+#define KLIB_WAIT_MAX_SLEEP 1000
+
+/// Poll a 32 bits register until a condition is true
+/// @addr Absolute address of the register
+/// @cond Condition on the register value: bool cond(uint32_t reg_val)
+/// @timeout_us Timeout in microseconds
+/// @reg_val Last value read in the register
+/// @return The waiting duration in microseconds, or -1 if timeout
+///
+/// The register is first polled in a tight loop for short waits.
+/// Then the thread sleeps in between two reads, doubling the sleeping
+/// duration up to KLIB_WAIT_MAX_SLEEP, to release the CPU on long waits.
+template<class Condition>
+inline int64_t PollReg32(intptr_t addr, Condition cond, uint32_t timeout_us,
+                         uint32_t& reg_val)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::microseconds(timeout_us);
+    auto now = start;
+    uint32_t sleep_us = 1;
+
+    for(unsigned int i=0; ; i++) {
+        reg_val = ReadReg32(addr);
+
+        if(cond(reg_val))
+            return std::chrono::duration_cast<std::chrono::microseconds>
+                                    (std::chrono::steady_clock::now() - start)
+                                    .count();
+
+        now = std::chrono::steady_clock::now();
+
+        if(now >= deadline)
+            return -1;
+
+        if(i >= KLIB_WAIT_SPIN_NUM) {
+            std::this_thread::sleep_for(std::min(
+                    std::chrono::duration_cast<std::chrono::microseconds>
+                                                        (deadline - now),
+                    std::chrono::microseconds(sleep_us)));
+
+            if(sleep_us < KLIB_WAIT_MAX_SLEEP)
+                sleep_us *= 2;
+        }
+    }
+}
+
+/// @brief Poll a 32 bits register in slices
+/// @slice_us Maximum duration of a slice (us)
+/// @yield Called in between two slices: intptr_t yield(),
+///        returns the address of the register, or 0 to abort the wait
+/// @return The waiting duration in microseconds, -1 if timeout,
+///         or -2 if aborted by @yield
+///
+/// Lets the caller release its locks in between two slices of a long
+/// wait. The register may be remapped meanwhile: @yield gives its
+/// address for the next slice.
+template<class Condition, class Yield>
+inline int64_t PollReg32(intptr_t addr, Condition cond, uint32_t timeout_us,
+                         uint32_t& reg_val, uint32_t slice_us, Yield yield)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::microseconds(timeout_us);
+
+    while(1) {
+        auto now = std::chrono::steady_clock::now();
+        uint32_t remaining_us = now >= deadline ? 0 :
+                std::chrono::duration_cast<std::chrono::microseconds>
+                                                    (deadline - now).count();
+        uint32_t duration_us = std::min(remaining_us, slice_us);
+
+        if(PollReg32(addr, cond, duration_us, reg_val) >= 0)
+            return std::chrono::duration_cast<std::chrono::microseconds>
+                                    (std::chrono::steady_clock::now() - start)
+                                    .count();
+
+        if(duration_us == remaining_us)
+            return -1;
+
+        addr = yield();
+
+        if(addr == 0)
+            return -2;
+    }
+}
+
+/// Wait until the masked value of a 32 bits register equals a value
+/// @addr Absolute address of the register
+/// @mask Mask applied to the register
+/// @value Value expected
+/// @timeout_us Timeout in microseconds
+/// @return The waiting duration in microseconds, or -1 if timeout
+inline int64_t WaitReg32(intptr_t addr, uint32_t mask, uint32_t value,
+                         uint32_t timeout_us)
+{
+    uint32_t reg_val;
+    return PollReg32(addr, [mask, value](uint32_t val) {
+        return (val & mask) == value;
+    }, timeout_us, reg_val);
 }
 
 }; // namespace Klib
@@ -0,0 +1,261 @@
+/// @file sim_fpga.cpp
+///
+/// @brief Implementation of sim_fpga.hpp
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#include "sim_fpga.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/mman.h>
+}
+
+#include <drivers/core/wr_register.hpp>
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+#define REG(offset) (base + (offset))
+
+SimFpga::SimFpga(MemBackend *backend_)
+: backend(backend_),
+  mapping(NULL),
+  mapping_len(0),
+  base(0),
+  phys_addr(0),
+  sample_rate(0),
+  running(false),
+  samples_num(0),
+  acquisitions_num(0),
+  load(0),
+  phase(0.0),
+  noise_state(0x12345678)
+{}
+
+SimFpga::~SimFpga()
+{
+    Stop();
+}
+
+int SimFpga::Start(uintptr_t phys_addr_, uint32_t sample_rate_)
+{
+    Stop();
+
+    // The generator writes into the memory:
+    // it must not be the memory of a board.
+    if(backend == NULL || !backend->IsSimulated()) {
+        fprintf(stderr, "SimFpga: The memory backend is not simulated\n");
+        return -1;
+    }
+
+    if(sample_rate_ == 0 || sample_rate_ > SIM_FPGA_MAX_SAMPLE_RATE) {
+        fprintf(stderr, "SimFpga: Invalid sample rate %u\n", sample_rate_);
+        return -1;
+    }
+
+    uint64_t page_mask = sysconf(_SC_PAGESIZE) - 1;
+    size_t len = (SIM_FPGA_MAP_SIZE + page_mask) & ~page_mask;
+    void *addr = backend->Map(phys_addr_, len, 0, mapping, mapping_len);
+
+    if((phys_addr_ & page_mask) != 0 || addr == NULL) {
+        fprintf(stderr, "SimFpga: Can't map 0x%llx\n", 
+                (unsigned long long)phys_addr_);
+
+        if(addr != NULL)
+            munmap(mapping, mapping_len);
+
+        mapping = NULL;
+        return -1;
+    }
+
+    base = reinterpret_cast<intptr_t>(addr);
+    phys_addr = phys_addr_;
+    sample_rate = sample_rate_;
+    samples_num.store(0);
+    acquisitions_num.store(0);
+    load.store(0);
+    phase = 0.0;
+
+    WriteReg32(REG(SIM_FPGA_REG_ID), SIM_FPGA_ID);
+    WriteReg32(REG(SIM_FPGA_REG_CTRL), 1);
+    WriteReg32(REG(SIM_FPGA_REG_TRIG), 0);
+    WriteReg32(REG(SIM_FPGA_REG_STATUS), 0);
+    WriteReg32(REG(SIM_FPGA_REG_WRITE_PTR), 0);
+    WriteReg32(REG(SIM_FPGA_REG_ACQ_START), 0);
+    WriteReg32(REG(SIM_FPGA_REG_ACQ_SIZE), SIM_FPGA_ADC_SAMPLES);
+    WriteReg32(REG(SIM_FPGA_REG_TRIG_LATENCY), 10);
+    WriteReg32(REG(SIM_FPGA_REG_FREQ), 1000);
+    WriteReg32(REG(SIM_FPGA_REG_AMPLITUDE), 4096);
+    WriteReg32(REG(SIM_FPGA_REG_NOISE), 16);
+    WriteReg32(REG(SIM_FPGA_REG_OFFSET), 0);
+    WriteReg32(REG(SIM_FPGA_REG_SAMPLE_RATE), sample_rate);
+    WriteReg32(REG(SIM_FPGA_REG_OVERRUNS), 0);
+    memset(reinterpret_cast<void*>(REG(SIM_FPGA_ADC_OFFSET)), 0, 
+           4 * SIM_FPGA_ADC_SAMPLES);
+
+    running.store(true);
+    generator = std::thread(&SimFpga::__run, this);
+    return 0;
+}
+
+void SimFpga::Stop()
+{
+    if(!running.load())
+        return;
+
+    running.store(false);
+    generator.join();
+
+    WriteReg32(REG(SIM_FPGA_REG_STATUS), 0);
+    munmap(mapping, mapping_len);
+    mapping = NULL;
+    base = 0;
+}
+
+void SimFpga::__generate(uint64_t first, uint64_t count)
+{
+    const double two_pi = 2 * M_PI;
+    const int32_t code_max = (1 << (SIM_FPGA_ADC_BITS - 1)) - 1;
+    const int32_t code_min = -(1 << (SIM_FPGA_ADC_BITS - 1));
+
+    double step = two_pi * ReadReg32(REG(SIM_FPGA_REG_FREQ)) / sample_rate;
+    double amplitude = ReadReg32(REG(SIM_FPGA_REG_AMPLITUDE));
+    int32_t offset = static_cast<int32_t>(ReadReg32(REG(SIM_FPGA_REG_OFFSET)));
+    uint32_t noise = ReadReg32(REG(SIM_FPGA_REG_NOISE));
+
+    // The sine is computed by rotating a phasor,
+    // the phase is recomputed at each batch.
+    double cos_step = cos(step), sin_step = sin(step);
+    double re = cos(phase), im = sin(phase);
+    uint32_t *adc = reinterpret_cast<uint32_t*>(REG(SIM_FPGA_ADC_OFFSET));
+
+    for(uint64_t i=0; i<count; i++) {
+        int32_t code = offset + static_cast<int32_t>(lrint(amplitude * im));
+
+        if(noise > 0) {
+            // xorshift32
+            noise_state ^= noise_state << 13;
+            noise_state ^= noise_state >> 17;
+            noise_state ^= noise_state << 5;
+            code += static_cast<int32_t>(noise_state % (2 * noise + 1)) 
+                    - static_cast<int32_t>(noise);
+        }
+
+        code = code > code_max ? code_max : (code < code_min ? code_min : code);
+        adc[(first + i) % SIM_FPGA_ADC_SAMPLES] = static_cast<uint32_t>(code);
+
+        double re_next = re * cos_step - im * sin_step;
+        im = im * cos_step + re * sin_step;
+        re = re_next;
+    }
+
+    phase = fmod(phase + step * count, two_pi);
+}
+
+void SimFpga::__run()
+{
+    typedef std::chrono::steady_clock clock;
+
+    clock::time_point start = clock::now();
+    clock::time_point acq_ready = start;
+    uint64_t busy_ns = 0;
+    uint64_t sample_idx = 0; // Sample clock of the ADC
+    uint64_t acq_first = 0;
+    uint32_t acq_size = 0;
+    uint32_t overruns = 0;
+    uint32_t last_trig = ReadReg32(REG(SIM_FPGA_REG_TRIG));
+    bool acquiring = false;
+    bool done = false;
+
+    while(running.load()) {
+        clock::time_point tick = clock::now();
+        double elapsed = std::chrono::duration<double>(tick - start).count();
+        uint64_t due = static_cast<uint64_t>(elapsed * sample_rate);
+        bool enabled = ReadReg32(REG(SIM_FPGA_REG_CTRL)) & 1;
+
+        if(enabled && due > sample_idx) {
+            uint64_t count = due - sample_idx;
+
+            // Late by more than the ring: the oldest samples are dropped
+            if(count > SIM_FPGA_ADC_SAMPLES) {
+                uint64_t dropped = count - SIM_FPGA_ADC_SAMPLES;
+                phase = fmod(phase + dropped * 2 * M_PI
+                             * ReadReg32(REG(SIM_FPGA_REG_FREQ)) / sample_rate,
+                             2 * M_PI);
+                overruns += dropped;
+                sample_idx += dropped;
+                count = SIM_FPGA_ADC_SAMPLES;
+                WriteReg32(REG(SIM_FPGA_REG_OVERRUNS), overruns);
+            }
+
+            __generate(sample_idx, count);
+            sample_idx += count;
+
+            // The samples are written before the pointer
+            std::atomic_thread_fence(std::memory_order_release);
+            WriteReg32(REG(SIM_FPGA_REG_WRITE_PTR), 
+                       sample_idx % SIM_FPGA_ADC_SAMPLES);
+        } else if(!enabled) {
+            sample_idx = due; // The sample clock keeps running
+        }
+
+        // Trigger: the acquisition starts at the next sample
+        uint32_t trig = ReadReg32(REG(SIM_FPGA_REG_TRIG));
+
+        if(trig != last_trig) {
+            last_trig = trig;
+
+            if(enabled) {
+                acq_size = ReadReg32(REG(SIM_FPGA_REG_ACQ_SIZE));
+
+                if(acq_size == 0 || acq_size > SIM_FPGA_ADC_SAMPLES)
+                    acq_size = SIM_FPGA_ADC_SAMPLES;
+
+                acq_first = sample_idx;
+                acq_ready = tick + std::chrono::microseconds(
+                        ReadReg32(REG(SIM_FPGA_REG_TRIG_LATENCY)));
+                acquiring = true;
+                done = false;
+                WriteReg32(REG(SIM_FPGA_REG_ACQ_START), 
+                           acq_first % SIM_FPGA_ADC_SAMPLES);
+            }
+        }
+
+        if(acquiring && sample_idx >= acq_first + acq_size 
+           && clock::now() >= acq_ready) {
+            acquiring = false;
+            done = true;
+            acquisitions_num++;
+        }
+
+        WriteReg32(REG(SIM_FPGA_REG_STATUS), 
+                   (enabled ? SIM_FPGA_STATUS_RUNNING : 0)
+                   | (acquiring ? SIM_FPGA_STATUS_ACQUIRING : 0)
+                   | (done ? SIM_FPGA_STATUS_DONE : 0));
+
+        samples_num.store(sample_idx);
+
+        clock::time_point end = clock::now();
+        busy_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            end - tick).count();
+        uint64_t total_ns = std::chrono::duration_cast<
+                std::chrono::nanoseconds>(end - start).count();
+
+        if(total_ns > 0)
+            load.store(busy_ns * 1000 / total_ns);
+
+        std::this_thread::sleep_until(tick 
+                + std::chrono::microseconds(SIM_FPGA_TICK_US));
+    }
+}
+
+}; // namespace Klib
@@ -0,0 +1,128 @@
+/// @file sim_fpga.hpp
+///
+/// @brief Simulated FPGA peripheral
+///
+/// A peripheral with a registers bank and an ADC ring buffer, living in
+/// a simulated physical address space (file or memfd memory backend).
+/// A generator thread fills the ring buffer at the sample rate and
+/// answers the triggers, so that the clients drive it through the 
+/// DEV_MEM operations as they would drive the FPGA of a board.
+///
+/// Memory layout (offsets from the base address):
+///
+///     0x0000  Registers (SIM_FPGA_REG_*)
+///     0x1000  ADC ring buffer, SIM_FPGA_ADC_SAMPLES int32 words
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __DRIVERS_SIM_SIM_FPGA_HPP__
+#define __DRIVERS_SIM_SIM_FPGA_HPP__
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+
+#include <drivers/core/mem_backend.hpp>
+
+/// @namespace Klib
+/// @brief Namespace of the Koheron library
+namespace Klib {
+
+/// Registers (written by the clients unless noted)
+#define SIM_FPGA_REG_ID           0x00 ///< Identifier (read only)
+#define SIM_FPGA_REG_CTRL         0x04 ///< Bit 0: ADC enabled
+#define SIM_FPGA_REG_TRIG         0x08 ///< A change of value triggers an acquisition
+#define SIM_FPGA_REG_STATUS       0x0C ///< SIM_FPGA_STATUS_* (read only)
+#define SIM_FPGA_REG_WRITE_PTR    0x10 ///< Next sample written in the ring (read only)
+#define SIM_FPGA_REG_ACQ_START    0x14 ///< First sample of the last acquisition (read only)
+#define SIM_FPGA_REG_ACQ_SIZE     0x18 ///< Samples of an acquisition
+#define SIM_FPGA_REG_TRIG_LATENCY 0x1C ///< Trigger to data latency (us)
+#define SIM_FPGA_REG_FREQ         0x20 ///< Frequency of the sine (Hz)
+#define SIM_FPGA_REG_AMPLITUDE    0x24 ///< Amplitude of the sine (ADC codes)
+#define SIM_FPGA_REG_NOISE        0x28 ///< Amplitude of the uniform noise (ADC codes)
+#define SIM_FPGA_REG_OFFSET       0x2C ///< Offset (ADC codes, signed)
+#define SIM_FPGA_REG_SAMPLE_RATE  0x30 ///< Sample rate (Hz, read only)
+#define SIM_FPGA_REG_OVERRUNS     0x34 ///< Samples dropped by the generator (read only)
+
+/// Status bits
+#define SIM_FPGA_STATUS_RUNNING   (1 << 0) ///< ADC enabled
+#define SIM_FPGA_STATUS_ACQUIRING (1 << 1) ///< Acquisition in progress
+#define SIM_FPGA_STATUS_DONE      (1 << 2) ///< Last acquisition completed
+
+#define SIM_FPGA_ID 0x4B53494D // "KSIM"
+
+/// Offset of the ADC ring buffer
+#define SIM_FPGA_ADC_OFFSET 0x1000
+
+/// Number of samples of the ADC ring buffer
+#define SIM_FPGA_ADC_SAMPLES 16384
+
+/// Size of the memory of the peripheral
+#define SIM_FPGA_MAP_SIZE (SIM_FPGA_ADC_OFFSET + 4 * SIM_FPGA_ADC_SAMPLES)
+
+/// ADC resolution (bits)
+#define SIM_FPGA_ADC_BITS 14
+
+/// Period of the generator thread (us)
+#define SIM_FPGA_TICK_US 100
+
+/// Maximum sample rate (Hz)
+#define SIM_FPGA_MAX_SAMPLE_RATE 250000000
+
+class SimFpga
+{
+  public:
+    /// @backend_ Backend of the simulated physical address space
+    SimFpga(MemBackend *backend_);
+    ~SimFpga();
+
+    /// @brief Start the simulation
+    /// @phys_addr Base address of the peripheral (page aligned)
+    /// @sample_rate Sample rate of the ADC (Hz)
+    /// @return 0 if success, -1 else
+    int Start(uintptr_t phys_addr, uint32_t sample_rate);
+
+    /// Stop the simulation
+    void Stop();
+
+    inline bool IsRunning() const {return running.load();}
+    inline uintptr_t GetPhysAddr() const {return phys_addr;}
+    inline uint32_t GetSampleRate() const {return sample_rate;}
+
+    /// Number of samples generated since the start
+    inline uint64_t GetSamplesNum() const {return samples_num.load();}
+
+    /// Number of acquisitions completed since the start
+    inline uint32_t GetAcquisitionsNum() const {return acquisitions_num.load();}
+
+    /// Generation time over the real time (x1000)
+    inline uint32_t GetLoad() const {return load.load();}
+
+  private:
+    MemBackend *backend;
+    void *mapping;
+    size_t mapping_len;
+    intptr_t base;
+
+    uintptr_t phys_addr;
+    uint32_t sample_rate;
+
+    std::thread generator;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> samples_num;
+    std::atomic<uint32_t> acquisitions_num;
+    std::atomic<uint32_t> load;
+
+    // Generator state
+    double phase;
+    uint32_t noise_state;
+
+    void __run();
+    void __generate(uint64_t first, uint64_t count);
+};
+
+}; // namespace Klib
+
+#endif // __DRIVERS_SIM_SIM_FPGA_HPP__
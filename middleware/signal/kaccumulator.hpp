@@ -0,0 +1,135 @@
+/// @file kaccumulator.hpp
+///
+/// @brief Averaging of traces
+///
+/// KTraceAccumulator sums traces of the same size into wide accumulators
+/// (64 bits integers for integer samples, double for floats), so that
+/// averaging noisy acquisitions neither overflows nor loses precision.
+/// It also keeps the minimum and maximum envelopes of the traces.
+///
+///     KTraceAccumulator<int32_t> acc(size, true);
+///
+///     for(int i=0; i<n; i++)
+///         acc.Add(acquire());
+///
+///     acc.Mean(mean);  // acc.Min(), acc.Max()
+///
+/// The loops are written to be vectorized by the compiler (sign extension
+/// and 64 bits additions, min and max selects): they run on SIMD packs
+/// at -O3, without the explicit packs of ksimd.hpp.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KACCUMULATOR_HPP__
+#define __SIGNAL_KACCUMULATOR_HPP__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "kallocator.hpp"
+
+namespace Klib {
+
+/// @brief Sum, min and max of traces
+///
+/// @T Type of the samples
+template<typename T>
+class KTraceAccumulator
+{
+  public:
+    static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 4,
+                  "Samples of 32 bits at most");
+
+    /// Type of the accumulators
+    typedef typename std::conditional<std::is_integral<T>::value,
+                                      int64_t, double>::type acc_t;
+
+    /// @size_ Number of samples of a trace
+    /// @envelopes_ True to keep the min and max envelopes
+    KTraceAccumulator(size_t size_, bool envelopes_ = false)
+    : len(size_), envelopes(envelopes_), count(0),
+      acc(size_),
+      min_env(envelopes_ ? size_ : 0),
+      max_env(envelopes_ ? size_ : 0)
+    {}
+
+    /// Number of samples of a trace
+    inline size_t size() const {return len;}
+
+    /// Number of traces added
+    inline size_t TracesNum() const {return count;}
+
+    inline bool HasEnvelopes() const {return envelopes;}
+
+    /// Remove all the traces
+    void Reset()
+    {
+        std::fill(acc.begin(), acc.end(), static_cast<acc_t>(0));
+        count = 0;
+    }
+
+    /// Add a trace of size() samples
+    void Add(const T *trace)
+    {
+        // Local size: the stores to the accumulators could alias len
+        const size_t n = len;
+        acc_t *a = acc.data();
+
+        for(size_t i=0; i<n; i++)
+            a[i] += trace[i];
+
+        if(envelopes) {
+            T *mn = min_env.data();
+            T *mx = max_env.data();
+
+            if(count == 0) {
+                std::copy(trace, trace + n, mn);
+                std::copy(trace, trace + n, mx);
+            } else {
+                for(size_t i=0; i<n; i++) {
+                    mn[i] = std::min(mn[i], trace[i]);
+                    mx[i] = std::max(mx[i], trace[i]);
+                }
+            }
+        }
+
+        count++;
+    }
+
+    /// Sum of the traces
+    inline const acc_t* Sum() const {return acc.data();}
+
+    /// @brief Mean of the traces (0 if no trace was added)
+    /// @mean size() samples
+    template<typename U>
+    void Mean(U *mean) const
+    {
+        const double scale = count == 0 ? 0 : 1.0 / count;
+
+        for(size_t i=0; i<len; i++)
+            mean[i] = static_cast<U>(acc[i] * scale);
+    }
+
+    /// Minimum envelope (if enabled and at least a trace was added)
+    inline const T* Min() const {return min_env.data();}
+
+    /// Maximum envelope (if enabled and at least a trace was added)
+    inline const T* Max() const {return max_env.data();}
+
+  private:
+    size_t len;
+    bool envelopes;
+    size_t count;
+    std::vector<acc_t, KPoolAllocator<acc_t> > acc;
+    std::vector<T, KPoolAllocator<T> > min_env;
+    std::vector<T, KPoolAllocator<T> > max_env;
+}; // class KTraceAccumulator
+
+} // Klib
+
+#endif // __SIGNAL_KACCUMULATOR_HPP__
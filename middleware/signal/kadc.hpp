@@ -0,0 +1,241 @@
+/// @file kadc.hpp
+///
+/// @brief Conversion of raw ADC words to physical units
+///
+/// The ADC samples are fields of bits bits in 32 bits words: one field
+/// per word, or several (2 fields of 16 bits, 4 fields of 8 bits).
+/// The fields, in the order of the words, are the samples of the
+/// channels in turn:
+///
+///     2 channels, 2 fields per word:  | ch1 | ch0 | ch1 | ch0 | ...
+///     2 channels, 1 field per word:   | ch0 | ch1 | ch0 | ch1 | ...
+///
+/// KAdcConverter sign extends the fields (or zero extends the unsigned
+/// ones), then de-interleaves the channels and applies their calibration:
+///
+///     y = g x + c2 x^2 + c3 x^3   with x = raw - offset
+///
+///     KAdcConverter<float> conv(14, true, 2, 2);
+///     conv.SetCalibration(0, offset, gain);
+///     std::vector< KVector<float> > volts = conv.Convert(words, n);
+///
+/// The loops are written to be vectorized by the compiler: the
+/// numbers of fields per word and of channels are constants of the loops.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KADC_HPP__
+#define __SIGNAL_KADC_HPP__
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+#include "kallocator.hpp"
+#include "kvector.hpp"
+
+namespace Klib {
+
+/// Maximum number of channels of a converter
+#define KADC_MAX_CHANNELS 8
+
+/// @brief Calibration of an ADC channel
+template<typename T>
+struct KAdcCalibration
+{
+    T offset = 0; ///< Raw value of a zero, in codes
+    T gain = 1;   ///< Units per code
+    T c2 = 0;     ///< Quadratic coefficient
+    T c3 = 0;     ///< Cubic coefficient
+
+    inline bool IsLinear() const {return c2 == 0 && c3 == 0;}
+};
+
+/// @brief Converter of raw ADC words
+///
+/// @T Type of the physical values (float or double)
+template<typename T>
+class KAdcConverter
+{
+  public:
+    static_assert(std::is_floating_point<T>::value,
+                  "Physical values are floating point");
+
+    /// @bits_ Number of bits of a sample
+    /// @is_signed_ True for two's complement samples
+    /// @fields_per_word_ Samples per 32 bits word (1, 2 or 4)
+    /// @channels_num_ Number of channels (1 to KADC_MAX_CHANNELS)
+    KAdcConverter(unsigned int bits_, bool is_signed_ = true,
+                  unsigned int fields_per_word_ = 1,
+                  unsigned int channels_num_ = 1)
+    : bits(bits_), is_signed(is_signed_),
+      fields_per_word(fields_per_word_), channels_num(channels_num_),
+      calibrations(channels_num_)
+    {
+        assert(IsValid(bits, fields_per_word, channels_num));
+    }
+
+    /// True if the samples fit in the words
+    static bool IsValid(unsigned int bits_, unsigned int fields_per_word_,
+                        unsigned int channels_num_)
+    {
+        return (fields_per_word_ == 1 || fields_per_word_ == 2
+                || fields_per_word_ == 4)
+               && bits_ >= 1 && bits_ <= 32 / fields_per_word_
+               && channels_num_ >= 1 && channels_num_ <= KADC_MAX_CHANNELS;
+    }
+
+    inline unsigned int Bits() const {return bits;}
+    inline bool IsSigned() const {return is_signed;}
+    inline unsigned int FieldsPerWord() const {return fields_per_word;}
+    inline unsigned int ChannelsNum() const {return channels_num;}
+
+    /// Number of samples per channel of @words_num words
+    inline size_t SamplesNum(size_t words_num) const
+    {
+        return words_num * fields_per_word / channels_num;
+    }
+
+    /// @brief Set the calibration of a channel
+    /// @offset_ Raw value of a zero
+    /// @gain_ Units per code
+    void SetCalibration(unsigned int channel, T offset_, T gain_,
+                        T c2_ = 0, T c3_ = 0)
+    {
+        assert(channel < channels_num);
+        KAdcCalibration<T>& cal = calibrations[channel];
+        cal.offset = offset_;
+        cal.gain = gain_;
+        cal.c2 = c2_;
+        cal.c3 = c3_;
+    }
+
+    inline const KAdcCalibration<T>& GetCalibration(unsigned int channel) const
+    {
+        return calibrations[channel];
+    }
+
+    /// @brief Convert @words_num words
+    /// @out ChannelsNum() * SamplesNum(words_num) values: the samples
+    ///      of the channel c start at out + c * SamplesNum(words_num)
+    void Convert(const uint32_t *words, size_t words_num, T *out)
+    {
+        T *outs[KADC_MAX_CHANNELS];
+
+        for(unsigned int c=0; c<channels_num; c++)
+            outs[c] = out + c * SamplesNum(words_num);
+
+        __convert(words, words_num, outs);
+    }
+
+    /// @brief Convert @words_num words
+    /// @return A vector of SamplesNum(words_num) samples per channel
+    std::vector< KVector<T> > Convert(const uint32_t *words, size_t words_num)
+    {
+        const size_t n = SamplesNum(words_num);
+        std::vector< KVector<T> > channels;
+        T *outs[KADC_MAX_CHANNELS];
+        channels.reserve(channels_num);
+
+        for(unsigned int c=0; c<channels_num; c++)
+            channels.emplace_back(n);
+
+        if(n == 0)
+            return channels;
+
+        for(unsigned int c=0; c<channels_num; c++)
+            outs[c] = &channels[c][0];
+
+        __convert(words, words_num, outs);
+        return channels;
+    }
+
+  private:
+    unsigned int bits;
+    bool is_signed;
+    unsigned int fields_per_word;
+    unsigned int channels_num;
+    std::vector< KAdcCalibration<T> > calibrations;
+    std::vector<T, KPoolAllocator<T> > fields; ///< Samples in the words order
+
+    void __convert(const uint32_t *words, size_t words_num, T *const *outs)
+    {
+        const size_t fields_num = words_num * fields_per_word;
+
+        if(fields.size() < fields_num)
+            fields.resize(fields_num);
+
+        switch(fields_per_word) {
+          case 1: __extract<1>(words, words_num, fields.data()); break;
+          case 2: __extract<2>(words, words_num, fields.data()); break;
+          default: __extract<4>(words, words_num, fields.data()); break;
+        }
+
+        const size_t n = SamplesNum(words_num);
+
+        for(unsigned int c=0; c<channels_num; c++) {
+            switch(channels_num) {
+              case 1: __calibrate<1>(c, n, outs[c]); break;
+              case 2: __calibrate<2>(c, n, outs[c]); break;
+              case 4: __calibrate<4>(c, n, outs[c]); break;
+              case 8: __calibrate<8>(c, n, outs[c]); break;
+              default: __calibrate<0>(c, n, outs[c]); break;
+            }
+        }
+    }
+
+    /// Extract the fields of the words, as raw codes
+    template<unsigned int F>
+    void __extract(const uint32_t *words, size_t n, T *out) const
+    {
+        // The field is shifted to the top bits, then back
+        // with an arithmetic shift for the signed samples
+        const unsigned int up = 32 - bits;
+        const unsigned int stride = 32 / F;
+
+        if(is_signed) {
+            for(size_t i=0; i<n; i++)
+                for(unsigned int f=0; f<F; f++)
+                    out[F * i + f] = static_cast<T>(
+                        static_cast<int32_t>((words[i] >> (f * stride)) << up) >> up);
+        } else {
+            for(size_t i=0; i<n; i++)
+                for(unsigned int f=0; f<F; f++)
+                    out[F * i + f] = static_cast<T>(
+                        ((words[i] >> (f * stride)) << up) >> up);
+        }
+    }
+
+    /// @brief Calibrate the samples of a channel
+    /// @C Number of channels, 0 if not a constant
+    template<unsigned int C>
+    void __calibrate(unsigned int channel, size_t n, T *out) const
+    {
+        const size_t stride = C == 0 ? channels_num : C;
+        const T *x = fields.data() + channel;
+        const KAdcCalibration<T>& cal = calibrations[channel];
+        const T offset = cal.offset;
+        const T gain = cal.gain;
+
+        if(cal.IsLinear()) {
+            for(size_t i=0; i<n; i++)
+                out[i] = (x[stride * i] - offset) * gain;
+        } else {
+            const T c2 = cal.c2;
+            const T c3 = cal.c3;
+
+            for(size_t i=0; i<n; i++) {
+                const T v = x[stride * i] - offset;
+                out[i] = v * (gain + v * (c2 + v * c3));
+            }
+        }
+    }
+}; // class KAdcConverter
+
+} // Klib
+
+#endif // __SIGNAL_KADC_HPP__
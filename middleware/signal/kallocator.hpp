@@ -0,0 +1,293 @@
+/// @file kallocator.hpp
+///
+/// @brief Allocators of the KVector buffers
+///
+/// KVector takes its allocator as a policy:
+///     - KPoolAllocator (default): blocks aligned on 64 bytes, recycled
+///       by a thread-local pool of size classes,
+///     - KAlignedAllocator: blocks aligned on 64 bytes, not recycled,
+///     - std::allocator.
+///
+/// The pool has a free list per power of two size, from 64 bytes to
+/// KPOOL_MAX_BLOCK_SIZE. A released block is kept in the pool of the
+/// releasing thread, up to KBlockPool::SetMaxCachedBytes bytes per thread
+/// (KPOOL_MAX_CACHED_BYTES by default), so that a processing loop
+/// allocating the same sizes at each iteration no longer calls malloc.
+/// The larger blocks are allocated and freed directly.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KALLOCATOR_HPP__
+#define __SIGNAL_KALLOCATOR_HPP__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+
+namespace Klib {
+
+/// Alignment of the blocks (cache line, widest SIMD pack)
+#define KALLOC_ALIGNMENT 64
+
+/// Size of the largest block kept by the pool
+#ifndef KPOOL_MAX_BLOCK_SIZE
+#define KPOOL_MAX_BLOCK_SIZE (4 * 1024 * 1024)
+#endif
+
+/// Default maximum size of the blocks kept by the pool of a thread
+#ifndef KPOOL_MAX_CACHED_BYTES
+#define KPOOL_MAX_CACHED_BYTES (1024 * 1024)
+#endif
+
+/// Allocate an aligned block, throws std::bad_alloc on failure
+static inline void* __kalloc_aligned(size_t bytes)
+{
+    void *ptr;
+
+    if(posix_memalign(&ptr, KALLOC_ALIGNMENT, bytes == 0 ? 1 : bytes) != 0)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+/// @brief Thread-local pool of aligned blocks
+class KBlockPool
+{
+  public:
+    /// Number of size classes: 64 bytes to KPOOL_MAX_BLOCK_SIZE
+    static const unsigned int classes_num = 17;
+
+    static_assert((static_cast<size_t>(KALLOC_ALIGNMENT) << (classes_num - 1))
+                  >= KPOOL_MAX_BLOCK_SIZE, "Not enough size classes");
+
+    struct Stats
+    {
+        uint64_t hits;      ///< Allocations served by the pool
+        uint64_t misses;    ///< Allocations served by the system
+        size_t cached_bytes;
+    };
+
+    KBlockPool()
+    : cached_bytes(0), hits(0), misses(0)
+    {
+        for(unsigned int i=0; i<classes_num; i++)
+            free_lists[i] = nullptr;
+    }
+
+    ~KBlockPool()
+    {
+        __destroyed() = true;
+
+        for(unsigned int i=0; i<classes_num; i++) {
+            while(free_lists[i] != nullptr) {
+                FreeBlock *block = free_lists[i];
+                free_lists[i] = block->next;
+                free(block);
+            }
+        }
+    }
+
+    /// Allocate a block of at least @bytes
+    static inline void* Allocate(size_t bytes)
+    {
+        KBlockPool *pool = Local();
+
+        if(pool == nullptr || bytes > KPOOL_MAX_BLOCK_SIZE)
+            return __kalloc_aligned(bytes);
+
+        unsigned int cls = __size_class(bytes);
+        FreeBlock *block = pool->free_lists[cls];
+
+        if(block != nullptr) {
+            pool->free_lists[cls] = block->next;
+            pool->cached_bytes -= __class_size(cls);
+            pool->hits++;
+            return block;
+        }
+
+        pool->misses++;
+        return __kalloc_aligned(__class_size(cls));
+    }
+
+    /// Release a block of @bytes, allocated by Allocate
+    static inline void Deallocate(void *ptr, size_t bytes) noexcept
+    {
+        KBlockPool *pool = Local();
+
+        if(pool == nullptr || bytes > KPOOL_MAX_BLOCK_SIZE) {
+            free(ptr);
+            return;
+        }
+
+        unsigned int cls = __size_class(bytes);
+
+        if(pool->cached_bytes + __class_size(cls)
+                > __max_cached_bytes().load(std::memory_order_relaxed)) {
+            free(ptr);
+            return;
+        }
+
+        FreeBlock *block = static_cast<FreeBlock*>(ptr);
+        block->next = pool->free_lists[cls];
+        pool->free_lists[cls] = block;
+        pool->cached_bytes += __class_size(cls);
+    }
+
+    /// @brief Set the maximum size of the blocks kept by the pool of a thread
+    ///
+    /// Applies to all the threads. The blocks already kept
+    /// above a lowered limit are reused, but not kept again.
+    static inline void SetMaxCachedBytes(size_t bytes)
+    {
+        __max_cached_bytes().store(bytes);
+    }
+
+    static inline size_t MaxCachedBytes()
+    {
+        return __max_cached_bytes().load();
+    }
+
+    /// Statistics of the pool of the calling thread
+    static inline Stats GetStats()
+    {
+        KBlockPool *pool = Local();
+
+        if(pool == nullptr)
+            return Stats{0, 0, 0};
+
+        return Stats{pool->hits, pool->misses, pool->cached_bytes};
+    }
+
+    /// Pool of the calling thread (NULL once destroyed)
+    static inline KBlockPool* Local()
+    {
+        if(__destroyed())
+            return nullptr;
+
+        static thread_local KBlockPool pool;
+        return &pool;
+    }
+
+  private:
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    FreeBlock *free_lists[classes_num];
+    size_t cached_bytes;
+    uint64_t hits;
+    uint64_t misses;
+
+    /// Set when the pool of the thread is destroyed: the buffers
+    /// released afterwards (thread_local vectors) are freed directly
+    static inline bool& __destroyed()
+    {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static inline std::atomic<size_t>& __max_cached_bytes()
+    {
+        static std::atomic<size_t> max_cached_bytes(KPOOL_MAX_CACHED_BYTES);
+        return max_cached_bytes;
+    }
+
+    static inline unsigned int __size_class(size_t bytes)
+    {
+        unsigned int cls = 0;
+
+        while((static_cast<size_t>(KALLOC_ALIGNMENT) << cls) < bytes)
+            cls++;
+
+        return cls;
+    }
+
+    static inline size_t __class_size(unsigned int cls)
+    {
+        return static_cast<size_t>(KALLOC_ALIGNMENT) << cls;
+    }
+}; // class KBlockPool
+
+/// @brief Allocator of 64 bytes aligned blocks, recycled by KBlockPool
+template<typename T>
+class KPoolAllocator
+{
+  public:
+    typedef T value_type;
+
+    KPoolAllocator() noexcept {}
+
+    template<typename U>
+    KPoolAllocator(const KPoolAllocator<U>&) noexcept {}
+
+    inline T* allocate(size_t n)
+    {
+        return static_cast<T*>(KBlockPool::Allocate(n * sizeof(T)));
+    }
+
+    inline void deallocate(T *ptr, size_t n) noexcept
+    {
+        KBlockPool::Deallocate(ptr, n * sizeof(T));
+    }
+};
+
+/// @brief Allocator of 64 bytes aligned blocks
+template<typename T>
+class KAlignedAllocator
+{
+  public:
+    typedef T value_type;
+
+    KAlignedAllocator() noexcept {}
+
+    template<typename U>
+    KAlignedAllocator(const KAlignedAllocator<U>&) noexcept {}
+
+    inline T* allocate(size_t n)
+    {
+        return static_cast<T*>(__kalloc_aligned(n * sizeof(T)));
+    }
+
+    inline void deallocate(T *ptr, size_t) noexcept
+    {
+        free(ptr);
+    }
+};
+
+// The blocks of an allocator can be released by any other,
+// the pools being shared by all the allocators of a thread.
+
+template<typename T, typename U>
+inline bool operator==(const KPoolAllocator<T>&, const KPoolAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const KPoolAllocator<T>&, const KPoolAllocator<U>&)
+{
+    return false;
+}
+
+template<typename T, typename U>
+inline bool operator==(const KAlignedAllocator<T>&,
+                       const KAlignedAllocator<U>&)
+{
+    return true;
+}
+
+template<typename T, typename U>
+inline bool operator!=(const KAlignedAllocator<T>&,
+                       const KAlignedAllocator<U>&)
+{
+    return false;
+}
+
+} // Klib
+
+#endif // __SIGNAL_KALLOCATOR_HPP__
@@ -0,0 +1,561 @@
+/// @file kencode.hpp
+///
+/// @brief Compact encodings of the arrays sent to the clients
+///
+/// KEncoder turns an array of 32 bits values into a frame:
+///
+///     | encoding (uint32) | values num (uint32) | length (uint32) | data |
+///
+/// where data are the length bytes of the values encoded with:
+///     - KENC_INT16: 16 bits integers. Lossless, for integer values
+///       between -32768 and 32767 (ADC samples).
+///     - KENC_FLOAT16: IEEE half precision floats. Lossy: 11 bits of
+///       mantissa, values above 65504 are infinite.
+///     - KENC_DELTA_BITPACK: differences of the integer values,
+///       bit-packed by blocks of KENC_BLOCK_SIZE values. Lossless.
+///
+/// An encoding which doesn't apply to the values (type, range) or
+/// doesn't reduce the size falls back to KENC_NONE: the raw values.
+/// The frame gives the encoding used, so the client decodes it anyway.
+///
+/// Delta + bit-packing: a block of 128 values is 32 rows of 4 lanes
+/// (value i is in the lane i % 4). The difference is taken with the
+/// value 4 indices before, in the same lane, and zigzag encoded
+/// (small negatives give small codes). The codes of a block are packed
+/// on the number of bits of the largest one, lane by lane:
+///
+///     | widths of the blocks (1 byte each, padded to 4 bytes) |
+///     | block 0: 4 width words | block 1: 4 width words | ...
+///
+/// the word 4 k + l holding the bits of the lane l. Hence the 4 lanes
+/// are packed and unpacked as one SIMD pack, without crossing lanes.
+///
+/// The loops are written to be vectorized by the compiler. The half
+/// precision conversions use the F16C instructions when enabled.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KENCODE_HPP__
+#define __SIGNAL_KENCODE_HPP__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__F16C__)
+# include <immintrin.h>
+#endif
+
+#include "kallocator.hpp"
+
+namespace Klib {
+
+typedef enum {
+    KENC_NONE,
+    KENC_INT16,
+    KENC_FLOAT16,
+    KENC_DELTA_BITPACK,
+    kencodings_num
+} kencoding_t;
+
+/// Values of a bit-packed block
+#define KENC_BLOCK_SIZE 128
+
+/// Lanes of a bit-packed block
+#define KENC_LANES 4
+
+/// Words of the frame header
+#define KENC_HEADER_WORDS 3
+
+/// True if the arrays of T can be encoded (32 bits values)
+template<typename T>
+struct KIsEncodable
+{
+    static const bool value = std::is_arithmetic<T>::value && sizeof(T) == 4;
+};
+
+// ---------------------------------------
+// Integers
+// ---------------------------------------
+
+/// @brief 32 bits integers to 16 bits
+/// @return false if a value is out of range
+inline bool KEncodeInt16(const int32_t *in, size_t n, int16_t *out)
+{
+    uint32_t overflow = 0;
+
+    for(size_t i=0; i<n; i++) {
+        out[i] = static_cast<int16_t>(in[i]);
+        overflow |= (static_cast<uint32_t>(in[i]) + 32768) >> 16;
+    }
+
+    return overflow == 0;
+}
+
+inline void KDecodeInt16(const int16_t *in, size_t n, int32_t *out)
+{
+    for(size_t i=0; i<n; i++)
+        out[i] = in[i];
+}
+
+// ---------------------------------------
+// Half precision floats
+// ---------------------------------------
+
+/// @brief Float to half, rounded to the nearest even
+///
+/// Branch-free (selects), so that the loops vectorize.
+/// See: https://gist.github.com/rygorous/2156668
+static inline uint16_t __float_to_half(float x)
+{
+    uint32_t f;
+    memcpy(&f, &x, sizeof(f));
+
+    const uint32_t sign = f & 0x80000000U;
+    f ^= sign;
+
+    // Subnormal halves: the addition aligns the mantissa
+    const uint32_t denorm_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+    float fd, magic;
+    memcpy(&fd, &f, sizeof(fd));
+    memcpy(&magic, &denorm_magic, sizeof(magic));
+    fd += magic;
+    uint32_t denorm;
+    memcpy(&denorm, &fd, sizeof(denorm));
+    denorm -= denorm_magic;
+
+    // Normal halves: rebias and round
+    const uint32_t mant_odd = (f >> 13) & 1;
+    const uint32_t norm = (f + ((15U - 127U) << 23) + 0xfff + mant_odd) >> 13;
+
+    // Overflow (infinite) and NaN
+    const uint32_t inf_nan = f > 0x7f800000U ? 0x7e00 : 0x7c00;
+
+    const uint32_t h = f >= 0x47800000U ? inf_nan
+                     : f < 0x38800000U ? denorm : norm;
+
+    return static_cast<uint16_t>(h | (sign >> 16));
+}
+
+static inline float __half_to_float(uint16_t h)
+{
+    const uint32_t shifted_exp = 0x7c00U << 13;
+    uint32_t o = (h & 0x7fffU) << 13;
+    const uint32_t exp = o & shifted_exp;
+    o += (127U - 15U) << 23;
+
+    // Infinite and NaN
+    const uint32_t inf_nan = o + ((128U - 16U) << 23);
+
+    // Subnormal: renormalized by a subtraction
+    const uint32_t denorm_bits = o + (1U << 23);
+    const uint32_t magic_bits = 113U << 23;
+    float denorm_f, magic;
+    memcpy(&denorm_f, &denorm_bits, sizeof(denorm_f));
+    memcpy(&magic, &magic_bits, sizeof(magic));
+    denorm_f -= magic;
+    uint32_t denorm;
+    memcpy(&denorm, &denorm_f, sizeof(denorm));
+
+    uint32_t f = exp == shifted_exp ? inf_nan : exp == 0 ? denorm : o;
+    f |= static_cast<uint32_t>(h & 0x8000U) << 16;
+
+    float x;
+    memcpy(&x, &f, sizeof(x));
+    return x;
+}
+
+inline void KEncodeFloat16(const float *in, size_t n, uint16_t *out)
+{
+    size_t i = 0;
+
+#if defined(__F16C__)
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                    _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), h);
+    }
+#endif
+
+    for(; i<n; i++)
+        out[i] = __float_to_half(in[i]);
+}
+
+inline void KDecodeFloat16(const uint16_t *in, size_t n, float *out)
+{
+    size_t i = 0;
+
+#if defined(__F16C__)
+    for(; i + 8 <= n; i += 8) {
+        __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+    }
+#endif
+
+    for(; i<n; i++)
+        out[i] = __half_to_float(in[i]);
+}
+
+// ---------------------------------------
+// Delta + bit-packing
+// ---------------------------------------
+
+/// Number of blocks of @n values
+inline size_t KBitpackBlocksNum(size_t n)
+{
+    return (n + KENC_BLOCK_SIZE - 1) / KENC_BLOCK_SIZE;
+}
+
+/// Bytes of the widths of @blocks_num blocks (padded to words)
+inline size_t KBitpackWidthsBytes(size_t blocks_num)
+{
+    return (blocks_num + 3) & ~static_cast<size_t>(3);
+}
+
+/// @brief Pack a block of 128 codes on B bits
+/// @return The number of words written (4 B)
+template<unsigned int B>
+static inline size_t __pack_block(const uint32_t *in, uint32_t *out)
+{
+    uint32_t acc[KENC_LANES] = {0, 0, 0, 0};
+    unsigned int shift = 0;
+    uint32_t *ptr = out;
+
+    if(B == 0)
+        return 0;
+
+    for(unsigned int r=0; r<KENC_BLOCK_SIZE/KENC_LANES; r++) {
+        const uint32_t *row = in + KENC_LANES * r;
+
+        for(unsigned int l=0; l<KENC_LANES; l++)
+            acc[l] |= row[l] << shift;
+
+        shift += B;
+
+        if(shift >= 32) {
+            for(unsigned int l=0; l<KENC_LANES; l++)
+                ptr[l] = acc[l];
+
+            ptr += KENC_LANES;
+            shift -= 32;
+
+            // Bits of the row left for the next word
+            for(unsigned int l=0; l<KENC_LANES; l++)
+                acc[l] = shift == 0 ? 0 : row[l] >> (B - shift);
+        }
+    }
+
+    return KENC_LANES * B;
+}
+
+/// @brief Unpack a block of 128 codes of B bits
+/// @return The number of words read (4 B)
+template<unsigned int B>
+static inline size_t __unpack_block(const uint32_t *in, uint32_t *out)
+{
+    if(B == 0) {
+        std::fill(out, out + KENC_BLOCK_SIZE, 0);
+        return 0;
+    }
+
+    const uint32_t mask = B == 32 ? 0xffffffffU : (1U << (B % 32)) - 1;
+    const uint32_t *ptr = in;
+    unsigned int shift = 0;
+
+    for(unsigned int r=0; r<KENC_BLOCK_SIZE/KENC_LANES; r++) {
+        uint32_t *row = out + KENC_LANES * r;
+
+        if(shift + B > 32) {
+            for(unsigned int l=0; l<KENC_LANES; l++)
+                row[l] = ((ptr[l] >> shift)
+                          | (ptr[KENC_LANES + l] << (32 - shift))) & mask;
+        } else {
+            for(unsigned int l=0; l<KENC_LANES; l++)
+                row[l] = (ptr[l] >> shift) & mask;
+        }
+
+        shift += B;
+
+        if(shift >= 32) {
+            ptr += KENC_LANES;
+            shift -= 32;
+        }
+    }
+
+    return KENC_LANES * B;
+}
+
+typedef size_t (*__block_kernel_t)(const uint32_t*, uint32_t*);
+
+#define __KENC_KERNELS(kernel)                                         \
+    {kernel<0>,  kernel<1>,  kernel<2>,  kernel<3>,  kernel<4>,        \
+     kernel<5>,  kernel<6>,  kernel<7>,  kernel<8>,  kernel<9>,        \
+     kernel<10>, kernel<11>, kernel<12>, kernel<13>, kernel<14>,       \
+     kernel<15>, kernel<16>, kernel<17>, kernel<18>, kernel<19>,       \
+     kernel<20>, kernel<21>, kernel<22>, kernel<23>, kernel<24>,       \
+     kernel<25>, kernel<26>, kernel<27>, kernel<28>, kernel<29>,       \
+     kernel<30>, kernel<31>, kernel<32>}
+
+/// Number of bits of the largest code
+static inline unsigned int __bits_width(const uint32_t *codes)
+{
+    uint32_t all = 0;
+
+    for(unsigned int i=0; i<KENC_BLOCK_SIZE; i++)
+        all |= codes[i];
+
+    return all == 0 ? 0 : 32 - __builtin_clz(all);
+}
+
+/// @brief Delta + bit-packing of @n integers
+/// @codes Work buffer of KBitpackBlocksNum(n) * KENC_BLOCK_SIZE codes
+/// @out At most KBitpackWidthsBytes(blocks) + 4 n + 512 bytes
+/// @return The number of bytes written
+inline size_t KEncodeDeltaBitpack(const int32_t *in, size_t n,
+                                  uint32_t *codes, uint8_t *out)
+{
+    static const __block_kernel_t pack[33] = __KENC_KERNELS(__pack_block);
+
+    const size_t blocks_num = KBitpackBlocksNum(n);
+    const size_t head = std::min(n, static_cast<size_t>(KENC_LANES));
+
+    // Zigzag encoded differences, wrapping around on 32 bits
+    for(size_t i=0; i<head; i++)
+        codes[i] = (static_cast<uint32_t>(in[i]) << 1) ^ (in[i] >> 31);
+
+    for(size_t i=KENC_LANES; i<n; i++) {
+        const int32_t d = static_cast<int32_t>(static_cast<uint32_t>(in[i])
+                              - static_cast<uint32_t>(in[i - KENC_LANES]));
+        codes[i] = (static_cast<uint32_t>(d) << 1) ^ (d >> 31);
+    }
+
+    std::fill(codes + n, codes + blocks_num * KENC_BLOCK_SIZE, 0);
+
+    const size_t widths_bytes = KBitpackWidthsBytes(blocks_num);
+    uint32_t *words = reinterpret_cast<uint32_t*>(out + widths_bytes);
+    std::fill(out + blocks_num, out + widths_bytes, 0);
+
+    for(size_t b=0; b<blocks_num; b++) {
+        const uint32_t *block = codes + b * KENC_BLOCK_SIZE;
+        const unsigned int width = __bits_width(block);
+        out[b] = static_cast<uint8_t>(width);
+        words += pack[width](block, words);
+    }
+
+    return reinterpret_cast<uint8_t*>(words) - out;
+}
+
+/// @brief Decode @n integers of a delta + bit-packing
+/// @in The encoded data (word aligned)
+/// @len Number of bytes of the encoded data
+/// @out KBitpackBlocksNum(n) * KENC_BLOCK_SIZE values
+/// @return false if the data are invalid
+inline bool KDecodeDeltaBitpack(const uint8_t *in, size_t len,
+                                size_t n, int32_t *out)
+{
+    static const __block_kernel_t unpack[33] = __KENC_KERNELS(__unpack_block);
+
+    const size_t blocks_num = KBitpackBlocksNum(n);
+    const size_t widths_bytes = KBitpackWidthsBytes(blocks_num);
+
+    if(len < widths_bytes)
+        return false;
+
+    size_t words_num = 0;
+
+    for(size_t b=0; b<blocks_num; b++) {
+        if(in[b] > 32)
+            return false;
+
+        words_num += KENC_LANES * in[b];
+    }
+
+    if(len != widths_bytes + 4 * words_num)
+        return false;
+
+    const uint32_t *words = reinterpret_cast<const uint32_t*>(in + widths_bytes);
+    uint32_t *codes = reinterpret_cast<uint32_t*>(out);
+
+    for(size_t b=0; b<blocks_num; b++)
+        words += unpack[in[b]](words, codes + b * KENC_BLOCK_SIZE);
+
+    // Zigzag decoding and prefix sums lane by lane
+    for(size_t i=0; i<n; i++)
+        codes[i] = (codes[i] >> 1) ^ (0U - (codes[i] & 1));
+
+    for(size_t i=KENC_LANES; i<n; i++)
+        codes[i] += codes[i - KENC_LANES];
+
+    return true;
+}
+
+#undef __KENC_KERNELS
+
+// ---------------------------------------
+// Frames
+// ---------------------------------------
+
+/// @brief Encoder of the arrays into frames
+///
+///     KEncoder encoder;
+///     encoder.Encode(KENC_INT16, samples, n);
+///     send(encoder.Frame(), encoder.FrameSize());
+///
+/// The buffers are kept from one array to the next.
+class KEncoder
+{
+  public:
+    KEncoder()
+    : frame_size(0)
+    {}
+
+    /// @brief Encode @n values
+    /// @enc Encoding requested
+    /// @return The encoding used (KENC_NONE if not applicable)
+    template<typename T>
+    kencoding_t Encode(kencoding_t enc, const T *in, size_t n)
+    {
+        static_assert(KIsEncodable<T>::value, "32 bits values only");
+
+        const size_t raw_bytes = n * sizeof(T);
+        size_t bytes = 0;
+        __reserve(KBitpackWidthsBytes(KBitpackBlocksNum(n)) + raw_bytes
+                  + 4 * KENC_LANES * 32);
+        uint8_t *data = reinterpret_cast<uint8_t*>(
+                            words.data() + KENC_HEADER_WORDS);
+
+        switch(enc) {
+          case KENC_INT16:
+            if(std::is_integral<T>::value
+               && KEncodeInt16(reinterpret_cast<const int32_t*>(in), n,
+                               reinterpret_cast<int16_t*>(data)))
+                bytes = 2 * n;
+            else
+                enc = KENC_NONE;
+            break;
+          case KENC_FLOAT16:
+            if(std::is_floating_point<T>::value) {
+                KEncodeFloat16(reinterpret_cast<const float*>(in), n,
+                               reinterpret_cast<uint16_t*>(data));
+                bytes = 2 * n;
+            } else {
+                enc = KENC_NONE;
+            }
+            break;
+          case KENC_DELTA_BITPACK:
+            if(std::is_integral<T>::value) {
+                codes.resize(KBitpackBlocksNum(n) * KENC_BLOCK_SIZE);
+                bytes = KEncodeDeltaBitpack(reinterpret_cast<const int32_t*>(in),
+                                            n, codes.data(), data);
+
+                if(bytes >= raw_bytes)
+                    enc = KENC_NONE;
+            } else {
+                enc = KENC_NONE;
+            }
+            break;
+          default:
+            enc = KENC_NONE;
+        }
+
+        if(enc == KENC_NONE) {
+            memcpy(data, in, raw_bytes);
+            bytes = raw_bytes;
+        }
+
+        words[0] = static_cast<uint32_t>(enc);
+        words[1] = static_cast<uint32_t>(n);
+        words[2] = static_cast<uint32_t>(bytes);
+        frame_size = 4 * KENC_HEADER_WORDS + bytes;
+        return enc;
+    }
+
+    /// Header and encoded data
+    inline const char* Frame() const
+    {
+        return reinterpret_cast<const char*>(words.data());
+    }
+
+    /// Number of bytes of the frame
+    inline size_t FrameSize() const {return frame_size;}
+
+  private:
+    std::vector<uint32_t, KPoolAllocator<uint32_t> > words;
+    std::vector<uint32_t, KPoolAllocator<uint32_t> > codes;
+    size_t frame_size;
+
+    void __reserve(size_t data_bytes)
+    {
+        const size_t words_num = KENC_HEADER_WORDS + (data_bytes + 3) / 4;
+
+        if(words.size() < words_num)
+            words.resize(words_num);
+    }
+}; // class KEncoder
+
+/// @brief Decode a frame
+/// @frame The frame (word aligned)
+/// @len Number of bytes of the frame
+/// @out The values (at least KBitpackBlocksNum(n) * KENC_BLOCK_SIZE
+///      for the delta + bit-packing)
+/// @max_values Number of values of @out
+/// @return The number of values decoded, -1 if the frame is invalid
+template<typename T>
+inline long KDecode(const char *frame, size_t len, T *out, size_t max_values)
+{
+    static_assert(KIsEncodable<T>::value, "32 bits values only");
+
+    if(len < 4 * KENC_HEADER_WORDS)
+        return -1;
+
+    uint32_t header[KENC_HEADER_WORDS];
+    memcpy(header, frame, sizeof(header));
+    const size_t n = header[1];
+    const size_t bytes = header[2];
+    const uint8_t *data = reinterpret_cast<const uint8_t*>(frame + sizeof(header));
+
+    if(len != sizeof(header) + bytes || n > max_values)
+        return -1;
+
+    switch(header[0]) {
+      case KENC_NONE:
+        if(bytes != 4 * n)
+            return -1;
+
+        memcpy(out, data, bytes);
+        break;
+      case KENC_INT16:
+        if(bytes != 2 * n)
+            return -1;
+
+        KDecodeInt16(reinterpret_cast<const int16_t*>(data), n,
+                     reinterpret_cast<int32_t*>(out));
+        break;
+      case KENC_FLOAT16:
+        if(bytes != 2 * n)
+            return -1;
+
+        KDecodeFloat16(reinterpret_cast<const uint16_t*>(data), n,
+                       reinterpret_cast<float*>(out));
+        break;
+      case KENC_DELTA_BITPACK:
+        if(max_values < KBitpackBlocksNum(n) * KENC_BLOCK_SIZE
+           || !KDecodeDeltaBitpack(data, bytes, n,
+                                   reinterpret_cast<int32_t*>(out)))
+            return -1;
+        break;
+      default:
+        return -1;
+    }
+
+    return static_cast<long>(n);
+}
+
+} // Klib
+
+#endif // __SIGNAL_KENCODE_HPP__
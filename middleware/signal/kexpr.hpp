@@ -0,0 +1,557 @@
+/// @file kexpr.hpp
+///
+/// @brief Expression templates of KVector
+///
+/// The arithmetic operators and the mathematical functions of KVector
+/// don't compute anything: they return an expression, which records
+/// the operation and its operands. The expression is evaluated when
+/// assigned to a KVector, in one loop without temporary vector:
+///
+///     KVector<float> res = sqrt(a*a + b*b) / n;
+///
+/// runs a single loop with one allocation (res).
+///
+/// The operands which are KVector are held by reference. An expression
+/// must therefore be evaluated before its operands are destroyed:
+/// don't keep it in an auto variable, assign it to a KVector.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KEXPR_HPP__
+#define __SIGNAL_KEXPR_HPP__
+
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+#include "kallocator.hpp"
+#include "kparallel.hpp"
+
+namespace Klib {
+
+template<typename T, typename Alloc = KPoolAllocator<T> > class KVector;
+
+/// @brief Base class of the vector expressions
+///
+/// @E Type of the expression (CRTP)
+/// @T Scalar type
+///
+/// An expression provides size() and operator[](i),
+/// which computes the component i.
+template<typename E, typename T>
+class KExpr
+{
+  public:
+    typedef T value_type;
+
+    /// The expression
+    inline const E& self() const
+    {
+        return static_cast<const E&>(*this);
+    }
+
+    /// Evaluate the expression into a vector
+    inline KVector<T> eval() const
+    {
+        return KVector<T>(*this);
+    }
+
+    // ---------------------------------------
+    // Reductions
+    // Evaluated in one loop over the expression.
+    // KVector redefines them on its buffer.
+    // ---------------------------------------
+
+    /// Sum all the components
+    inline T sum() const
+    {
+        const E& e = self();
+        T res = 0;
+
+        for(size_t i=0; i<e.size(); i++)
+            res += e[i];
+
+        return res;
+    }
+
+    /// Return the mean value
+    inline T mean() const
+    {
+        return sum() / self().size();
+    }
+
+    /// Return the maximum value, 0 if empty as KMax
+    inline T max() const
+    {
+        const E& e = self();
+
+        if(e.size() == 0)
+            return static_cast<T>(0);
+
+        T res = e[0];
+
+        for(size_t i=1; i<e.size(); i++) {
+            T val = e[i];
+
+            if(val > res)
+                res = val;
+        }
+
+        return res;
+    }
+
+    /// Return the minimum value, 0 if empty as KMin
+    inline T min() const
+    {
+        const E& e = self();
+
+        if(e.size() == 0)
+            return static_cast<T>(0);
+
+        T res = e[0];
+
+        for(size_t i=1; i<e.size(); i++) {
+            T val = e[i];
+
+            if(val < res)
+                res = val;
+        }
+
+        return res;
+    }
+
+    /// Return the 1-norm
+    inline T norm1() const
+    {
+        const E& e = self();
+        T res = 0;
+
+        for(size_t i=0; i<e.size(); i++)
+            res += std::fabs(e[i]);
+
+        return res;
+    }
+
+    /// Return the Euclidian norm (2-norm)
+    inline T norm2() const
+    {
+        const E& e = self();
+        T res = 0;
+
+        for(size_t i=0; i<e.size(); i++) {
+            T val = e[i];
+            res += val * val;
+        }
+
+        return std::sqrt(res);
+    }
+
+    /// Return the p-norm
+    inline T normp(uint32_t p) const
+    {
+        const E& e = self();
+        T res = 0;
+
+        for(size_t i=0; i<e.size(); i++)
+            res += std::pow(std::fabs(e[i]), static_cast<T>(p));
+
+        return std::pow(res, 1/static_cast<T>(p));
+    }
+
+    /// Return the variance.
+    /// The expression is evaluated twice.
+    inline T var() const
+    {
+        const E& e = self();
+
+        if(e.size() == 0)
+            return static_cast<T>(0);
+
+        T mean_ = mean();
+        T res = 0;
+
+        for(size_t i=0; i<e.size(); i++) {
+            T delta = e[i] - mean_;
+            res += delta * delta;
+        }
+
+        return res / e.size();
+    }
+
+    inline T stdev() const
+    {
+        return std::sqrt(var());
+    }
+}; // class KExpr
+
+/// How an expression holds its operands:
+/// KVector by reference, expressions by value.
+template<typename E>
+struct KExprOperand
+{
+    typedef const E type;
+};
+
+template<typename T, typename Alloc>
+struct KExprOperand< KVector<T, Alloc> >
+{
+    typedef const KVector<T, Alloc>& type;
+};
+
+/// @brief A scalar operand
+///
+/// Has the size 0, the size of a binary
+/// expression is the one of the vector operand.
+template<typename T>
+class KScalar
+{
+  public:
+    KScalar(const T& val_)
+    : val(val_)
+    {}
+
+    inline size_t size() const {return 0;}
+    inline T operator[](size_t) const {return val;}
+
+  private:
+    const T val;
+};
+
+template<typename T>
+struct KExprOperand< KScalar<T> >
+{
+    typedef const KScalar<T> type;
+};
+
+/// @brief Element-wise unary operation
+///
+/// @Op Operation, provides static T apply(T x)
+template<typename Op, typename E, typename T>
+class KUnaryExpr : public KExpr<KUnaryExpr<Op, E, T>, T>
+{
+  public:
+    KUnaryExpr(const E& x_)
+    : x(x_)
+    {}
+
+    inline size_t size() const {return x.size();}
+    inline T operator[](size_t i) const {return Op::apply(x[i]);}
+
+    /// The operand
+    inline const E& operand() const {return x;}
+
+  private:
+    typename KExprOperand<E>::type x;
+};
+
+/// @brief Element-wise binary operation
+///
+/// @Op Operation, provides static T apply(T x, T y)
+template<typename Op, typename L, typename R, typename T>
+class KBinaryExpr : public KExpr<KBinaryExpr<Op, L, R, T>, T>
+{
+  public:
+    KBinaryExpr(const L& l_, const R& r_)
+    : l(l_), r(r_)
+    {
+        assert(l.size() == r.size() || l.size() == 0 || r.size() == 0);
+    }
+
+    inline size_t size() const
+    {
+        return l.size() != 0 ? l.size() : r.size();
+    }
+
+    inline T operator[](size_t i) const {return Op::apply(l[i], r[i]);}
+
+  private:
+    typename KExprOperand<L>::type l;
+    typename KExprOperand<R>::type r;
+};
+
+/// @brief Evaluate an expression into a buffer
+///
+/// @dst Buffer of expr_.size() elements
+///
+/// Split in chunks evaluated in parallel above the threshold
+/// (kparallel.hpp). Overloaded for the expressions having a
+/// vectorized kernel (see kfastmath.hpp).
+template<typename E, typename T>
+inline void KExprEval(const KExpr<E, T>& expr_, T *dst)
+{
+    const E& expr = expr_.self();
+
+    KParallelFor(expr.size(), [&expr, dst](size_t begin, size_t end) {
+        for(size_t i=begin; i<end; i++)
+            dst[i] = expr[i];
+    });
+}
+
+// ---------------------------------------
+// Operations
+// ---------------------------------------
+
+struct KOpAdd
+{
+    template<typename T>
+    static inline T apply(T x, T y) {return x + y;}
+};
+
+struct KOpSub
+{
+    template<typename T>
+    static inline T apply(T x, T y) {return x - y;}
+};
+
+struct KOpMul
+{
+    template<typename T>
+    static inline T apply(T x, T y) {return x * y;}
+};
+
+struct KOpDiv
+{
+    template<typename T>
+    static inline T apply(T x, T y) {return x / y;}
+};
+
+struct KOpPow
+{
+    template<typename T>
+    static inline T apply(T x, T y) {return std::pow(x, y);}
+};
+
+struct KOpNeg
+{
+    template<typename T>
+    static inline T apply(T x) {return -x;}
+};
+
+// ---------------------------------------
+// Arithmetics
+// ---------------------------------------
+
+/// Define the operator between two expressions,
+/// and between an expression and a scalar
+#define KEXPR_BINARY_OPERATOR(op_symbol, Op)                                \
+    template<typename L, typename R, typename T>                            \
+    inline KBinaryExpr<Op, L, R, T>                                         \
+    operator op_symbol(const KExpr<L, T>& l_, const KExpr<R, T>& r_)        \
+    {                                                                       \
+        return KBinaryExpr<Op, L, R, T>(l_.self(), r_.self());              \
+    }                                                                       \
+                                                                            \
+    template<typename E, typename T>                                        \
+    inline KBinaryExpr<Op, E, KScalar<T>, T>                                \
+    operator op_symbol(const KExpr<E, T>& x_, const T& scal_)               \
+    {                                                                       \
+        return KBinaryExpr<Op, E, KScalar<T>, T>(x_.self(),                 \
+                                                 KScalar<T>(scal_));        \
+    }                                                                       \
+                                                                            \
+    template<typename E, typename T>                                        \
+    inline KBinaryExpr<Op, KScalar<T>, E, T>                                \
+    operator op_symbol(const T& scal_, const KExpr<E, T>& x_)               \
+    {                                                                       \
+        return KBinaryExpr<Op, KScalar<T>, E, T>(KScalar<T>(scal_),         \
+                                                 x_.self());                \
+    }
+
+/// Add two vectors of the same size, or a scalar to each component
+KEXPR_BINARY_OPERATOR(+, KOpAdd)
+
+/// Substract two vectors of the same size, or a scalar
+KEXPR_BINARY_OPERATOR(-, KOpSub)
+
+/// Multiply two vectors component-wise, or by a scalar
+KEXPR_BINARY_OPERATOR(*, KOpMul)
+
+/// Divide two vectors component-wise, or by a scalar
+KEXPR_BINARY_OPERATOR(/, KOpDiv)
+
+/// Opposite of each component
+template<typename E, typename T>
+inline KUnaryExpr<KOpNeg, E, T> operator-(const KExpr<E, T>& x_)
+{
+    return KUnaryExpr<KOpNeg, E, T>(x_.self());
+}
+
+/// Put every component of a vector to a given power
+template<typename E, typename T>
+inline KBinaryExpr<KOpPow, E, KScalar<T>, T>
+operator^(const KExpr<E, T>& x_, const T& pow_)
+{
+    return KBinaryExpr<KOpPow, E, KScalar<T>, T>(x_.self(), KScalar<T>(pow_));
+}
+
+// ---------------------------------------
+// Functions
+// ---------------------------------------
+
+/// Define an element-wise function
+/// @name Name of the function
+/// @formula Value of the function at x
+#define KEXPR_FUNCTION(name, formula)                                       \
+    struct KOp_##name                                                       \
+    {                                                                       \
+        template<typename T>                                                \
+        static inline T apply(T x) {return formula;}                        \
+    };                                                                      \
+                                                                            \
+    template<typename E, typename T>                                        \
+    inline KUnaryExpr<KOp_##name, E, T> name(const KExpr<E, T>& x_)         \
+    {                                                                       \
+        return KUnaryExpr<KOp_##name, E, T>(x_.self());                     \
+    }
+
+/// Return the absolute value of each component of a vector
+KEXPR_FUNCTION(abs, std::fabs(x))
+KEXPR_FUNCTION(fabs, std::fabs(x))
+
+/// Calculate the square root of all the components of a vector
+KEXPR_FUNCTION(sqrt, std::sqrt(x))
+
+/// Return the ceil of all the components of a vector
+KEXPR_FUNCTION(ceil, std::ceil(x))
+
+/// Return the floor of all the components of a vector
+KEXPR_FUNCTION(floor, std::floor(x))
+
+/// Calculate the exponential of all the components of a vector
+KEXPR_FUNCTION(exp, std::exp(x))
+
+/// Calculate the exp(x)-1 of all the components of a vector
+KEXPR_FUNCTION(expm1, std::expm1(x))
+
+/// Calculate the Gauss function exp(-x^2)
+KEXPR_FUNCTION(gauss, std::exp(-x*x))
+
+/// Calculate the Lorentzian 1/(1+x^2)
+KEXPR_FUNCTION(lorentz, 1/(1+x*x))
+
+/// Calculate the logarithm in base e of all the components of a vector
+KEXPR_FUNCTION(log, std::log(x))
+
+/// Calculate the logarithm in base 10 of all the components of a vector
+KEXPR_FUNCTION(log10, std::log10(x))
+
+/// Calculate the sinus of all the components of a vector
+KEXPR_FUNCTION(sin, std::sin(x))
+
+/// Calculate the cosine of all the components of a vector
+KEXPR_FUNCTION(cos, std::cos(x))
+
+/// Calculate the cardinal sinus sin(x)/x
+KEXPR_FUNCTION(sinc, std::sin(x)/x)
+
+/// Calculate the tangent of all the components of a vector
+KEXPR_FUNCTION(tan, std::tan(x))
+
+/// Calculate the arccosine of all the components of a vector
+KEXPR_FUNCTION(acos, std::acos(x))
+KEXPR_FUNCTION(arccos, std::acos(x))
+
+/// Calculate the arcsinus of all the components of a vector
+KEXPR_FUNCTION(asin, std::asin(x))
+KEXPR_FUNCTION(arcsin, std::asin(x))
+
+/// Calculate the arctangent of all the components of a vector
+KEXPR_FUNCTION(atan, std::atan(x))
+KEXPR_FUNCTION(arctan, std::atan(x))
+
+/// Calculate the hyperbolic sinus of all the components of a vector
+KEXPR_FUNCTION(sinh, std::sinh(x))
+
+/// Calculate the hyperbolic cosine of all the components of a vector
+KEXPR_FUNCTION(cosh, std::cosh(x))
+
+/// Calculate the hyperbolic tangent of all the components of a vector
+KEXPR_FUNCTION(tanh, std::tanh(x))
+
+/// Calculate the arccosh of all the components of a vector
+KEXPR_FUNCTION(acosh, std::acosh(x))
+KEXPR_FUNCTION(arccosh, std::acosh(x))
+
+/// Calculate the arcsinh of all the components of a vector
+KEXPR_FUNCTION(asinh, std::asinh(x))
+KEXPR_FUNCTION(arcsinh, std::asinh(x))
+
+/// Calculate the arctanh of all the components of a vector
+KEXPR_FUNCTION(atanh, std::atanh(x))
+KEXPR_FUNCTION(arctanh, std::atanh(x))
+
+// ---------------------------------------
+// Reductions
+// ---------------------------------------
+
+/// Sum the elements of a vector
+template<typename E, typename T>
+inline T sum(const KExpr<E, T>& x_)
+{
+    return x_.self().sum();
+}
+
+/// Return the maximum value of the vector
+template<typename E, typename T>
+inline T max(const KExpr<E, T>& x_)
+{
+    return x_.self().max();
+}
+
+/// Return the minimum value of the vector
+template<typename E, typename T>
+inline T min(const KExpr<E, T>& x_)
+{
+    return x_.self().min();
+}
+
+/// Return the 1-norm of the vector
+template<typename E, typename T>
+inline T norm1(const KExpr<E, T>& x_)
+{
+    return x_.self().norm1();
+}
+
+/// Return the Euclidian norm (2-norm) of the vector
+template<typename E, typename T>
+inline T norm2(const KExpr<E, T>& x_)
+{
+    return x_.self().norm2();
+}
+
+/// Return the p-norm of the vector
+template<typename E, typename T>
+inline T normp(const KExpr<E, T>& x_, uint32_t p)
+{
+    return x_.self().normp(p);
+}
+
+// Statistical functions
+
+/// Return the average of a vector
+template<typename E, typename T>
+inline T mean(const KExpr<E, T>& x_)
+{
+    return x_.self().mean();
+}
+
+/// Return the variance of a vector
+template<typename E, typename T>
+inline T var(const KExpr<E, T>& x_)
+{
+    return x_.self().var();
+}
+
+/// Return the standard deviation of a vector
+template<typename E, typename T>
+inline T stdev(const KExpr<E, T>& x_)
+{
+    return x_.self().stdev();
+}
+
+} // Klib
+
+#endif // __SIGNAL_KEXPR_HPP__
@@ -0,0 +1,294 @@
+/// @file kfastmath.hpp
+///
+/// @brief Fast approximations of exp, log, sin and cos
+///
+/// Polynomial approximations (Cephes single precision) written on the
+/// SIMD packs (ksimd.hpp). They are opt-in, in the namespace Klib::fast,
+/// the functions of kexpr.hpp staying exact:
+///
+///     KVector<float> y = fast::exp(x);      // Vectorized kernel
+///     KVector<float> z = fast::sin(2*x+1);  // Element-wise expression
+///
+/// A fast function of a KVector<float> or of a KVectorView<float> is
+/// evaluated with the SIMD kernel. Of another expression, it is
+/// evaluated element-wise by the scalar version, which is branch-free.
+/// The arrays can also be processed directly: fast::exp(in, out, n).
+///
+/// Accuracy (float):
+///     - exp: relative error < 2e-7, x clamped to [-87.3, 88.3],
+///     - log: relative error < 2e-7, NaN for x <= 0, no denormals,
+///     - sin, cos: absolute error < 2e-7 for |x| < 8192.
+///
+/// For the other scalar types, the fast functions are the std ones.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KFASTMATH_HPP__
+#define __SIGNAL_KFASTMATH_HPP__
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include "ksimd.hpp"
+#include "kvector.hpp"
+#include "kvector_view.hpp"
+#include "kparallel.hpp"
+
+namespace Klib {
+
+// ---------------------------------------
+// Kernels on the float traits Tr
+// ---------------------------------------
+
+template<typename Tr>
+inline typename Tr::pack KFastExp(typename Tr::pack x)
+{
+    typedef typename Tr::pack pack;
+    typedef typename Tr::ipack ipack;
+
+    x = Tr::min(Tr::max(x, Tr::set1(-87.3365f)), Tr::set1(88.3762f));
+
+    // x = n ln(2) + r, with |r| <= ln(2)/2
+    ipack n = Tr::to_int_round(Tr::mul(x, Tr::set1(1.44269504088896341f)));
+    pack fn = Tr::to_float(n);
+    pack r = Tr::fmadd(fn, Tr::set1(-0.693359375f), x);
+    r = Tr::fmadd(fn, Tr::set1(2.12194440e-4f), r);
+
+    pack p = Tr::set1(1.9875691500e-4f);
+    p = Tr::fmadd(p, r, Tr::set1(1.3981999507e-3f));
+    p = Tr::fmadd(p, r, Tr::set1(8.3334519073e-3f));
+    p = Tr::fmadd(p, r, Tr::set1(4.1665795894e-2f));
+    p = Tr::fmadd(p, r, Tr::set1(1.6666665459e-1f));
+    p = Tr::fmadd(p, r, Tr::set1(5.0000001201e-1f));
+    p = Tr::fmadd(p, Tr::mul(r, r), Tr::add(r, Tr::set1(1.0f)));
+
+    // Multiply by 2^n, built in the exponent field
+    pack pow2n = Tr::as_float(Tr::template islli<23>(
+                                  Tr::iadd(n, Tr::iset1(127))));
+    return Tr::mul(p, pow2n);
+}
+
+template<typename Tr>
+inline typename Tr::pack KFastLog(typename Tr::pack x)
+{
+    typedef typename Tr::pack pack;
+
+    pack invalid = Tr::cmple(x, Tr::set1(0.0f));
+    x = Tr::max(x, Tr::set1(1.17549435e-38f));
+
+    // x = m 2^e, with m in [0.5, 1)
+    pack e = Tr::to_float(Tr::isub(
+                 Tr::template isrli<23>(Tr::as_int(x)), Tr::iset1(126)));
+    pack m = Tr::bor(Tr::band(x, Tr::as_float(Tr::iset1(0x007FFFFF))),
+                     Tr::set1(0.5f));
+
+    // m in [sqrt(1/2), sqrt(2)), minus 1
+    pack small = Tr::cmplt(m, Tr::set1(0.707106781186547524f));
+    e = Tr::sub(e, Tr::band(small, Tr::set1(1.0f)));
+    m = Tr::add(Tr::sub(m, Tr::set1(1.0f)), Tr::band(small, m));
+
+    pack z = Tr::mul(m, m);
+    pack p = Tr::set1(7.0376836292e-2f);
+    p = Tr::fmadd(p, m, Tr::set1(-1.1514610310e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(1.1676998740e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(-1.2420140846e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(1.4249322787e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(-1.6668057665e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(2.0000714765e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(-2.4999993993e-1f));
+    p = Tr::fmadd(p, m, Tr::set1(3.3333331174e-1f));
+    p = Tr::mul(Tr::mul(p, m), z);
+
+    p = Tr::fmadd(e, Tr::set1(-2.12194440e-4f), p);
+    p = Tr::fmadd(z, Tr::set1(-0.5f), p);
+    pack res = Tr::fmadd(e, Tr::set1(0.693359375f), Tr::add(m, p));
+
+    // All bits set: NaN
+    return Tr::bor(res, invalid);
+}
+
+/// @brief Sine or cosine of the reduced argument
+///
+/// @x Absolute value of the argument
+/// @j Octant of x (even), minus 2 for the cosine
+/// @y Octant of x as a float
+/// @sign Sign to apply to the result
+template<typename Tr>
+inline typename Tr::pack __fast_sincos(typename Tr::pack x,
+                                       typename Tr::ipack j,
+                                       typename Tr::pack y,
+                                       typename Tr::pack sign)
+{
+    typedef typename Tr::pack pack;
+
+    // Sine polynomial in the octants 0 and 3 (modulo 4)
+    pack sin_poly = Tr::as_float(Tr::icmpeq(Tr::iand(j, Tr::iset1(2)),
+                                            Tr::iset1(0)));
+
+    // x - y pi/4, in extended precision
+    x = Tr::fmadd(y, Tr::set1(-0.78515625f), x);
+    x = Tr::fmadd(y, Tr::set1(-2.4187564849853515625e-4f), x);
+    x = Tr::fmadd(y, Tr::set1(-3.77489497744594108e-8f), x);
+    pack z = Tr::mul(x, x);
+
+    pack yc = Tr::set1(2.443315711809948e-5f);
+    yc = Tr::fmadd(yc, z, Tr::set1(-1.388731625493765e-3f));
+    yc = Tr::fmadd(yc, z, Tr::set1(4.166664568298827e-2f));
+    yc = Tr::mul(Tr::mul(yc, z), z);
+    yc = Tr::add(Tr::fmadd(z, Tr::set1(-0.5f), yc), Tr::set1(1.0f));
+
+    pack ys = Tr::set1(-1.9515295891e-4f);
+    ys = Tr::fmadd(ys, z, Tr::set1(8.3321608736e-3f));
+    ys = Tr::fmadd(ys, z, Tr::set1(-1.6666654611e-1f));
+    ys = Tr::fmadd(Tr::mul(ys, z), x, x);
+
+    return Tr::bxor(Tr::select(sin_poly, ys, yc), sign);
+}
+
+template<typename Tr>
+inline typename Tr::pack KFastSin(typename Tr::pack x)
+{
+    typedef typename Tr::pack pack;
+    typedef typename Tr::ipack ipack;
+
+    pack sign = Tr::band(x, Tr::as_float(Tr::iset1(0x80000000)));
+    x = Tr::abs(x);
+
+    // Octant, rounded to even
+    ipack j = Tr::to_int_trunc(Tr::mul(x, Tr::set1(1.27323954473516f)));
+    j = Tr::iand(Tr::iadd(j, Tr::iset1(1)), Tr::iset1(~1));
+    pack y = Tr::to_float(j);
+
+    // Negative in the octants 4 to 7
+    sign = Tr::bxor(sign, Tr::as_float(Tr::template islli<29>(
+                              Tr::iand(j, Tr::iset1(4)))));
+
+    return __fast_sincos<Tr>(x, j, y, sign);
+}
+
+template<typename Tr>
+inline typename Tr::pack KFastCos(typename Tr::pack x)
+{
+    typedef typename Tr::pack pack;
+    typedef typename Tr::ipack ipack;
+
+    x = Tr::abs(x);
+
+    ipack j = Tr::to_int_trunc(Tr::mul(x, Tr::set1(1.27323954473516f)));
+    j = Tr::iand(Tr::iadd(j, Tr::iset1(1)), Tr::iset1(~1));
+    pack y = Tr::to_float(j);
+
+    // cos(x) = sin(x + pi/2)
+    j = Tr::isub(j, Tr::iset1(2));
+    pack sign = Tr::as_float(Tr::template islli<29>(
+                    Tr::iandnot(j, Tr::iset1(4))));
+
+    return __fast_sincos<Tr>(x, j, y, sign);
+}
+
+// ---------------------------------------
+// Fast functions
+// ---------------------------------------
+
+/// Base of the operations having a vectorized kernel
+struct KFastOp {};
+
+/// Apply a fast operation to an array, serial
+template<typename Op>
+inline void __fast_apply(const float *in, float *out, size_t n)
+{
+    typedef SimdTraits<float> S;
+    size_t i = 0;
+
+    for(; i + S::width <= n; i += S::width)
+        S::store(out + i, Op::template apply_pack<S>(S::load(in + i)));
+
+    for(; i < n; i++)
+        out[i] = Op::apply(in[i]);
+}
+
+/// Apply a fast operation to an array (in and out can be the same)
+template<typename Op>
+inline void KFastApply(const float *in, float *out, size_t n)
+{
+    KParallelFor(n, [in, out](size_t begin, size_t end) {
+        __fast_apply<Op>(in + begin, out + begin, end - begin);
+    });
+}
+
+/// A fast function of a vector runs the vectorized kernel
+template<typename Op, typename Alloc>
+inline typename std::enable_if<std::is_base_of<KFastOp, Op>::value>::type
+KExprEval(const KExpr<KUnaryExpr<Op, KVector<float, Alloc>, float>,
+                      float>& expr_,
+          float *dst)
+{
+    const KVector<float, Alloc>& x = expr_.self().operand();
+    KFastApply<Op>(x.get_ptr(), dst, x.size());
+}
+
+/// And of a view
+template<typename Op>
+inline typename std::enable_if<std::is_base_of<KFastOp, Op>::value>::type
+KExprEval(const KExpr<KUnaryExpr<Op, KVectorView<float>, float>, float>& expr_,
+          float *dst)
+{
+    const KVectorView<float>& x = expr_.self().operand();
+    KFastApply<Op>(x.get_ptr(), dst, x.size());
+}
+
+/// Define a fast function
+/// @name Name of the function
+/// @kernel Kernel on the float packs
+#define KFAST_FUNCTION(name, kernel)                                        \
+    struct KFastOp_##name : public KFastOp                                  \
+    {                                                                       \
+        template<typename Tr>                                               \
+        static inline typename Tr::pack apply_pack(typename Tr::pack x)     \
+        {                                                                   \
+            return kernel<Tr>(x);                                           \
+        }                                                                   \
+                                                                            \
+        static inline float apply(float x)                                  \
+        {                                                                   \
+            return kernel< ScalarTraits<float> >(x);                        \
+        }                                                                   \
+                                                                            \
+        template<typename T>                                                \
+        static inline T apply(T x) {return std::name(x);}                   \
+    };                                                                      \
+                                                                            \
+    namespace fast {                                                        \
+                                                                            \
+    template<typename E, typename T>                                        \
+    inline KUnaryExpr<KFastOp_##name, E, T> name(const KExpr<E, T>& x_)     \
+    {                                                                       \
+        return KUnaryExpr<KFastOp_##name, E, T>(x_.self());                 \
+    }                                                                       \
+                                                                            \
+    inline void name(const float *in, float *out, size_t n)                 \
+    {                                                                       \
+        KFastApply<KFastOp_##name>(in, out, n);                             \
+    }                                                                       \
+                                                                            \
+    } // fast
+
+/// Exponential of each component
+KFAST_FUNCTION(exp, KFastExp)
+
+/// Natural logarithm of each component
+KFAST_FUNCTION(log, KFastLog)
+
+/// Sine of each component
+KFAST_FUNCTION(sin, KFastSin)
+
+/// Cosine of each component
+KFAST_FUNCTION(cos, KFastCos)
+
+} // Klib
+
+#endif // __SIGNAL_KFASTMATH_HPP__
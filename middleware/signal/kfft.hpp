@@ -0,0 +1,346 @@
+/// @file kfft.hpp
+///
+/// @brief Real FFT and power spectral density
+///
+/// KFft computes the FFT of n real samples (n a power of 2) with a
+/// complex FFT of n/2 points: the even samples are the real parts,
+/// the odd samples the imaginary parts, and the n/2+1 bins are
+/// recombined after the transform. The complex FFT is a radix-2
+/// decimation in time on separate real and imaginary arrays, so that
+/// the butterflies of a stage run on SIMD packs (ksimd.hpp). The
+/// twiddle factors and the bit reversal are computed once, by the
+/// constructor.
+///
+/// KWelch estimates the one-sided power spectral density of a signal
+/// by averaging the periodograms of windowed, overlapping segments.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KFFT_HPP__
+#define __SIGNAL_KFFT_HPP__
+
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "ksimd.hpp"
+#include "kreduce.hpp"
+#include "kvector.hpp"
+#include "kvector_view.hpp"
+#include "kwindow.hpp"
+
+namespace Klib {
+
+/// True if @n is a power of 2
+static inline bool KIsPowerOf2(size_t n)
+{
+    return n != 0 && (n & (n - 1)) == 0;
+}
+
+/// @brief FFT of real samples
+///
+/// @T float or double
+///
+/// A KFft holds its work buffers: a thread must use its own.
+template<typename T>
+class KFft
+{
+  public:
+    /// @n_ Number of samples, a power of 2 (>= 4)
+    KFft(size_t n_);
+
+    /// Number of samples
+    inline size_t Size() const {return n;}
+
+    /// Number of bins of the transform (0 to n/2)
+    inline size_t BinsNum() const {return m + 1;}
+
+    /// @brief Transform n samples
+    /// @x The samples
+    /// @re, @im The BinsNum() bins
+    /// @window Window applied to the samples (NULL for none)
+    /// @dc Value subtracted from the samples, before the window
+    void Forward(const T *x, T *re, T *im,
+                 const T *window = nullptr, T dc = 0);
+
+    /// @brief Add the squared magnitudes of the bins to @power
+    ///
+    /// Same arguments as Forward
+    void AddPower(const T *x, T *power,
+                  const T *window = nullptr, T dc = 0);
+
+  private:
+    size_t n;   ///< Number of real samples
+    size_t m;   ///< Size of the complex transform (n/2)
+
+    std::vector<uint32_t> bitrev;   ///< Bit reversal of the indices < m
+
+    /// Twiddle factors exp(-i pi k/h), k < h, of the stage h, at h-1
+    KVector<T> tw_re, tw_im;
+
+    /// Twiddle factors exp(-2 i pi k/n), k <= m, of the recombination
+    KVector<T> rtw_re, rtw_im;
+
+    /// Complex work buffer
+    KVector<T> z_re, z_im;
+
+    void __load(const T *x, const T *window, T dc);
+    void __transform();
+
+    /// Recombine the bin k of the real transform
+    inline void __bin(size_t k, T& re, T& im) const
+    {
+        const size_t k1 = (k == m) ? 0 : k;
+        const size_t k2 = (k == 0) ? 0 : m - k;
+        const T zr1 = z_re[k1], zi1 = z_im[k1];
+        const T zr2 = z_re[k2], zi2 = z_im[k2];
+
+        // Transforms of the even (e) and odd (o) samples
+        const T er = static_cast<T>(0.5) * (zr1 + zr2);
+        const T ei = static_cast<T>(0.5) * (zi1 - zi2);
+        const T or_ = static_cast<T>(0.5) * (zi1 + zi2);
+        const T oi = static_cast<T>(0.5) * (zr2 - zr1);
+
+        re = er + rtw_re[k] * or_ - rtw_im[k] * oi;
+        im = ei + rtw_re[k] * oi + rtw_im[k] * or_;
+    }
+}; // class KFft
+
+template<typename T>
+KFft<T>::KFft(size_t n_)
+: n(n_), m(n_ / 2), bitrev(n_ / 2),
+  tw_re(n_ / 2), tw_im(n_ / 2),
+  rtw_re(n_ / 2 + 1), rtw_im(n_ / 2 + 1),
+  z_re(n_ / 2), z_im(n_ / 2)
+{
+    assert(KIsPowerOf2(n) && n >= 4);
+
+    unsigned int bits = 0;
+
+    while((static_cast<size_t>(1) << bits) < m)
+        bits++;
+
+    for(size_t j=0; j<m; j++) {
+        uint32_t r = 0;
+
+        for(unsigned int b=0; b<bits; b++)
+            if(j & (static_cast<size_t>(1) << b))
+                r |= 1U << (bits - 1 - b);
+
+        bitrev[j] = r;
+    }
+
+    for(size_t h=1; h<m; h <<= 1) {
+        for(size_t k=0; k<h; k++) {
+            tw_re[h - 1 + k] = std::cos(M_PI * k / h);
+            tw_im[h - 1 + k] = -std::sin(M_PI * k / h);
+        }
+    }
+
+    for(size_t k=0; k<=m; k++) {
+        rtw_re[k] = std::cos(2 * M_PI * k / n);
+        rtw_im[k] = -std::sin(2 * M_PI * k / n);
+    }
+}
+
+template<typename T>
+void KFft<T>::__load(const T *x, const T *window, T dc)
+{
+    T *zr = &z_re[0];
+    T *zi = &z_im[0];
+
+    if(window == nullptr) {
+        for(size_t j=0; j<m; j++) {
+            zr[bitrev[j]] = x[2*j] - dc;
+            zi[bitrev[j]] = x[2*j + 1] - dc;
+        }
+    } else {
+        for(size_t j=0; j<m; j++) {
+            zr[bitrev[j]] = (x[2*j] - dc) * window[2*j];
+            zi[bitrev[j]] = (x[2*j + 1] - dc) * window[2*j + 1];
+        }
+    }
+}
+
+template<typename T>
+void KFft<T>::__transform()
+{
+    typedef SimdTraits<T> S;
+    typedef typename S::pack pack;
+
+    T *zr = &z_re[0];
+    T *zi = &z_im[0];
+
+    for(size_t h=1; h<m; h <<= 1) {
+        const T *wr = tw_re.get_ptr() + h - 1;
+        const T *wi = tw_im.get_ptr() + h - 1;
+
+        if(h < S::width) {
+            for(size_t s=0; s<m; s += 2*h) {
+                for(size_t k=0; k<h; k++) {
+                    const size_t a = s + k;
+                    const size_t b = a + h;
+                    const T tr = zr[b] * wr[k] - zi[b] * wi[k];
+                    const T ti = zr[b] * wi[k] + zi[b] * wr[k];
+                    zr[b] = zr[a] - tr;
+                    zi[b] = zi[a] - ti;
+                    zr[a] += tr;
+                    zi[a] += ti;
+                }
+            }
+
+            continue;
+        }
+
+        // Butterflies on packs of consecutive k
+        for(size_t s=0; s<m; s += 2*h) {
+            T *ar = zr + s, *ai = zi + s;
+            T *br = ar + h, *bi = ai + h;
+
+            for(size_t k=0; k<h; k += S::width) {
+                const pack w_r = S::load(wr + k), w_i = S::load(wi + k);
+                const pack b_r = S::load(br + k), b_i = S::load(bi + k);
+                const pack a_r = S::load(ar + k), a_i = S::load(ai + k);
+                const pack t_r = S::sub(S::mul(b_r, w_r), S::mul(b_i, w_i));
+                const pack t_i = S::fmadd(b_r, w_i, S::mul(b_i, w_r));
+
+                S::store(ar + k, S::add(a_r, t_r));
+                S::store(ai + k, S::add(a_i, t_i));
+                S::store(br + k, S::sub(a_r, t_r));
+                S::store(bi + k, S::sub(a_i, t_i));
+            }
+        }
+    }
+}
+
+template<typename T>
+void KFft<T>::Forward(const T *x, T *re, T *im, const T *window, T dc)
+{
+    __load(x, window, dc);
+    __transform();
+
+    for(size_t k=0; k<=m; k++)
+        __bin(k, re[k], im[k]);
+}
+
+template<typename T>
+void KFft<T>::AddPower(const T *x, T *power, const T *window, T dc)
+{
+    __load(x, window, dc);
+    __transform();
+
+    for(size_t k=0; k<=m; k++) {
+        T re, im;
+        __bin(k, re, im);
+        power[k] += re * re + im * im;
+    }
+}
+
+/// @brief Power spectral density by the Welch method
+///
+/// The signal is cut into segments of nfft samples, overlapping by
+/// @overlap samples. The mean of each segment is removed, then the
+/// segment is windowed and its periodogram computed. The PSD is the
+/// average of the periodograms.
+///
+/// The PSD is one-sided (bins 0 to nfft/2) and normalized to a sample
+/// rate of 1: divide it by the sample rate to get a density per Hz.
+/// The sum of the PSD over the bins, divided by nfft, is the variance
+/// of the signal (Parseval).
+template<typename T>
+class KWelch
+{
+  public:
+    /// @nfft_ Number of samples of a segment, a power of 2 (>= 4)
+    /// @window_ Window of the segments
+    /// @overlap_ Overlap of the segments (< nfft_), half a segment if
+    ///           not given
+    KWelch(size_t nfft_, kwindow_t window_ = KWIN_HANN,
+           size_t overlap_ = static_cast<size_t>(-1))
+    : fft(nfft_),
+      kind(window_),
+      window(KWindow<T>(window_, nfft_)),
+      power(nfft_ / 2 + 1)
+    {
+        step = nfft_ - (overlap_ < nfft_ ? overlap_ : nfft_ / 2);
+        norm = KSumSquares(window.get_ptr(), window.size());
+    }
+
+    /// Number of samples of a segment
+    inline size_t Nfft() const {return fft.Size();}
+
+    /// Number of bins of the PSD
+    inline size_t BinsNum() const {return fft.BinsNum();}
+
+    /// Window of the segments
+    inline kwindow_t Window() const {return kind;}
+
+    /// @brief Number of segments averaged for a signal of @len samples
+    inline size_t SegmentsNum(size_t len) const
+    {
+        return len < Nfft() ? 0 : (len - Nfft()) / step + 1;
+    }
+
+    /// @brief PSD of a signal
+    /// @x The signal
+    /// @len Number of samples
+    /// @psd The BinsNum() bins of the PSD
+    /// @return The number of segments averaged,
+    ///         0 if the signal is shorter than a segment
+    size_t Compute(const T *x, size_t len, T *psd);
+
+    /// @brief PSD of a signal
+    /// @return The bins of the PSD, all 0 if the
+    ///         signal is shorter than a segment
+    inline KVector<T> Compute(const KVectorView<T>& x)
+    {
+        KVector<T> psd(BinsNum(), static_cast<T>(0));
+        Compute(x.get_ptr(), x.size(), &psd[0]);
+        return psd;
+    }
+
+  private:
+    KFft<T> fft;
+    kwindow_t kind;
+    KVector<T> window;
+    KVector<T> power;   ///< Sum of the periodograms
+    size_t step;        ///< Distance between two segments
+    T norm;             ///< Sum of the squares of the window
+};
+
+template<typename T>
+size_t KWelch<T>::Compute(const T *x, size_t len, T *psd)
+{
+    const size_t segments_num = SegmentsNum(len);
+    const size_t nfft = Nfft();
+    const size_t bins_num = BinsNum();
+
+    if(segments_num == 0)
+        return 0;
+
+    for(size_t k=0; k<bins_num; k++)
+        power[k] = 0;
+
+    for(size_t i=0; i<segments_num; i++) {
+        const T *segment = x + i * step;
+        const T mean = KSum(segment, nfft) / nfft;
+        fft.AddPower(segment, &power[0], window.get_ptr(), mean);
+    }
+
+    // One-sided: the power of the negative frequencies is
+    // added to the positive ones, except for DC and Nyquist.
+    const T scale = 1 / (norm * segments_num);
+
+    for(size_t k=0; k<bins_num; k++)
+        psd[k] = power[k] * scale * ((k == 0 || k == bins_num - 1) ? 1 : 2);
+
+    return segments_num;
+}
+
+} // Klib
+
+#endif // __SIGNAL_KFFT_HPP__
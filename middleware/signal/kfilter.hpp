@@ -0,0 +1,342 @@
+/// @file kfilter.hpp
+///
+/// @brief Streaming decimation filters
+///
+/// The filters keep their state between two calls of Process, so that
+/// a continuous acquisition is decimated chunk by chunk as one signal:
+///
+///     KFirDecimator<float> fir(KDecimationTaps<float>(10), 10);
+///
+///     while(acquire(chunk, chunk_size))
+///         send(out, fir.Process(chunk, chunk_size, out));
+///
+/// An output is produced every decim samples: after the decim-th, the
+/// 2 decim-th, ... sample since the start (or the last Reset). A chunk
+/// of n samples gives at most MaxOutputsNum(n) outputs, exactly
+/// n / decim if the chunks sizes are multiples of decim.
+///
+///     - KMovingAverage: mean of the last samples,
+///     - KFirDecimator: FIR filter, of which only the kept outputs are
+///       computed (polyphase decimation),
+///     - KCicDecimator: cascaded integrators-comb on integer samples,
+///       without multiplication, for the large ratios.
+///
+/// The moving average and the FIR filter are computed on SIMD packs
+/// (kreduce.hpp). The CIC integrators are recurrences on 64 bits
+/// integers, they run sample by sample.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KFILTER_HPP__
+#define __SIGNAL_KFILTER_HPP__
+
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "kreduce.hpp"
+#include "kallocator.hpp"
+#include "kvector.hpp"
+#include "kvector_view.hpp"
+#include "kwindow.hpp"
+
+namespace Klib {
+
+/// Maximum order of a CIC decimator
+#define KCIC_MAX_ORDER 6
+
+// ---------------------------------------
+// FIR design
+// ---------------------------------------
+
+/// @brief Lowpass FIR filter (windowed sinc)
+/// @taps_num Number of coefficients (odd for a linear phase of
+///           an integer number of samples)
+/// @cutoff Cutoff frequency, in cycles per sample (0 to 0.5)
+/// @window Window of the sinc
+/// @return The coefficients, normalized to a DC gain of 1
+template<typename T>
+inline KVector<T> KLowpassTaps(size_t taps_num, double cutoff,
+                               kwindow_t window = KWIN_BLACKMAN)
+{
+    assert(taps_num > 0 && cutoff > 0 && cutoff <= 0.5);
+
+    KVector<T> taps = KWindow<T>(window, taps_num, false);
+    const double center = (taps_num - 1) / 2.0;
+    double sum = 0;
+
+    for(size_t i=0; i<taps_num; i++) {
+        const double t = i - center;
+        const double sinc = t == 0 ? 2 * cutoff
+                                   : std::sin(2 * M_PI * cutoff * t) / (M_PI * t);
+        taps[i] = static_cast<T>(sinc * taps[i]);
+        sum += taps[i];
+    }
+
+    for(size_t i=0; i<taps_num; i++)
+        taps[i] = static_cast<T>(taps[i] / sum);
+
+    return taps;
+}
+
+/// @brief Anti-aliasing filter of a decimation by @decim
+///
+/// Blackman windowed sinc of 16 decim + 1 coefficients, cutoff at 0.4
+/// times the output sample rate. The output band is alias-free up
+/// to 0.43 times the output rate (72 dB), and flat up to 0.2 times.
+template<typename T>
+inline KVector<T> KDecimationTaps(size_t decim)
+{
+    assert(decim >= 1);
+    return KLowpassTaps<T>(16 * decim + 1, 0.4 / decim);
+}
+
+// ---------------------------------------
+// FIR filters
+// ---------------------------------------
+
+/// @brief Delay line of the streaming FIR filters
+///
+/// The last length - 1 samples are kept in front of the
+/// new ones, so that the window of each output is contiguous.
+template<typename T>
+class KDelayLine
+{
+  public:
+    /// @length_ Number of samples of the window of an output
+    /// @decim_ Decimation ratio
+    KDelayLine(size_t length_, size_t decim_)
+    : length(length_), decim(decim_), count(0), work(length_ - 1)
+    {
+        assert(length >= 1 && decim >= 1);
+    }
+
+    inline size_t Length() const {return length;}
+    inline size_t Decimation() const {return decim;}
+
+    /// Maximum number of outputs for @n samples
+    inline size_t MaxOutputsNum(size_t n) const
+    {
+        return (n + decim - 1) / decim;
+    }
+
+    /// Restart from a zero signal
+    void Reset()
+    {
+        std::fill(work.begin(), work.begin() + length - 1, static_cast<T>(0));
+        count = 0;
+    }
+
+  protected:
+    size_t length;
+    size_t decim;
+    size_t count;   ///< Samples since the last output (< decim)
+    std::vector<T, KPoolAllocator<T> > work;
+
+    /// @brief Append @n samples
+    /// @kernel Computes an output from the pointer to its window
+    template<typename Kernel>
+    size_t __process(const T *in, size_t n, T *out, Kernel kernel)
+    {
+        const size_t hist = length - 1;
+        size_t outs = 0;
+
+        if(work.size() < hist + n)
+            work.resize(hist + n);
+
+        std::copy(in, in + n, work.begin() + hist);
+
+        // The window of the sample j is [j, j + hist]
+        for(size_t j = decim - 1 - count; j < n; j += decim)
+            out[outs++] = kernel(&work[j]);
+
+        count = (count + n) % decim;
+        std::copy(work.begin() + n, work.begin() + n + hist, work.begin());
+        return outs;
+    }
+}; // class KDelayLine
+
+/// @brief Moving average
+///
+/// The output is the mean of the last length samples. The cost is
+/// length / decim additions per sample: for a length much larger
+/// than the decimation, a CIC decimator is cheaper.
+template<typename T>
+class KMovingAverage : public KDelayLine<T>
+{
+  public:
+    /// @length_ Number of samples averaged
+    /// @decim_ Decimation ratio, length_ for a block average
+    KMovingAverage(size_t length_, size_t decim_ = 1)
+    : KDelayLine<T>(length_, decim_)
+    {}
+
+    /// @brief Filter @n samples
+    /// @return The number of outputs written to @out
+    size_t Process(const T *in, size_t n, T *out)
+    {
+        const size_t len = this->length;
+        const T scale = static_cast<T>(1) / len;
+
+        return this->__process(in, n, out, [len, scale](const T *x) {
+            return KSum(x, len) * scale;
+        });
+    }
+};
+
+/// @brief Decimating FIR filter
+template<typename T>
+class KFirDecimator : public KDelayLine<T>
+{
+  public:
+    /// @taps_ Coefficients h[k] of y[n] = sum_k h[k] x[n - k]
+    /// @decim_ Decimation ratio
+    KFirDecimator(const KVectorView<T>& taps_, size_t decim_)
+    : KDelayLine<T>(taps_.size(), decim_),
+      rtaps(taps_.size())
+    {
+        // Reversed, to be aligned with the window
+        for(size_t k=0; k<taps_.size(); k++)
+            rtaps[k] = taps_[taps_.size() - 1 - k];
+    }
+
+    /// @brief Filter @n samples
+    /// @return The number of outputs written to @out
+    size_t Process(const T *in, size_t n, T *out)
+    {
+        const T *h = rtaps.get_ptr();
+        const size_t len = this->length;
+
+        return this->__process(in, n, out, [h, len](const T *x) {
+            return KDot(h, x, len);
+        });
+    }
+
+  private:
+    KVector<T> rtaps;
+};
+
+// ---------------------------------------
+// CIC
+// ---------------------------------------
+
+/// @brief Cascaded integrators-comb decimator
+///
+/// @T Type of the outputs, normalized to a DC gain of 1
+///
+/// The integrators and the combs wrap around on 64 bits, which gives
+/// the exact result for 32 bits samples when order log2(decim) <= 31.
+/// The response is sinc^order: the band is flat only well below
+/// the output Nyquist frequency.
+template<typename T>
+class KCicDecimator
+{
+  public:
+    /// @order_ Number of integrators and combs (1 to KCIC_MAX_ORDER)
+    /// @decim_ Decimation ratio
+    KCicDecimator(unsigned int order_, size_t decim_)
+    : order(order_), decim(decim_),
+      gain(1 / std::pow(static_cast<double>(decim_), order_))
+    {
+        assert(IsValid(order, decim));
+        Reset();
+    }
+
+    /// True if the registers can't overflow
+    static bool IsValid(unsigned int order_, size_t decim_)
+    {
+        unsigned int bits = 0;
+
+        while((static_cast<size_t>(1) << bits) < decim_)
+            bits++;
+
+        return order_ >= 1 && order_ <= KCIC_MAX_ORDER
+               && decim_ >= 1 && order_ * bits <= 31;
+    }
+
+    inline unsigned int Order() const {return order;}
+    inline size_t Decimation() const {return decim;}
+
+    /// Maximum number of outputs for @n samples
+    inline size_t MaxOutputsNum(size_t n) const
+    {
+        return (n + decim - 1) / decim;
+    }
+
+    /// Restart from a zero signal
+    void Reset()
+    {
+        count = 0;
+
+        for(unsigned int s=0; s<KCIC_MAX_ORDER; s++) {
+            integ[s] = 0;
+            comb[s] = 0;
+        }
+    }
+
+    /// @brief Filter @n integer samples (32 bits at most)
+    /// @return The number of outputs written to @out
+    template<typename In>
+    size_t Process(const In *in, size_t n, T *out)
+    {
+        static_assert(std::is_integral<In>::value && sizeof(In) <= 4,
+                      "CIC on integer samples of 32 bits at most");
+
+        // The order is a constant of the loops
+        switch(order) {
+          case 1: return __process<1>(in, n, out);
+          case 2: return __process<2>(in, n, out);
+          case 3: return __process<3>(in, n, out);
+          case 4: return __process<4>(in, n, out);
+          case 5: return __process<5>(in, n, out);
+          default: return __process<6>(in, n, out);
+        }
+    }
+
+  private:
+    unsigned int order;
+    size_t decim;
+    size_t count;   ///< Samples since the last output (< decim)
+    double gain;
+    uint64_t integ[KCIC_MAX_ORDER];
+    uint64_t comb[KCIC_MAX_ORDER];
+
+    template<unsigned int N, typename In>
+    size_t __process(const In *in, size_t n, T *out)
+    {
+        static_assert(N <= KCIC_MAX_ORDER, "Invalid CIC order");
+        size_t outs = 0;
+
+        for(size_t i=0; i<n; i++) {
+            uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(in[i]));
+
+            for(unsigned int s=0; s<N; s++)
+                v = integ[s] += v;
+
+            if(++count < decim)
+                continue;
+
+            count = 0;
+
+            for(unsigned int s=0; s<N; s++) {
+                const uint64_t delta = v - comb[s];
+                comb[s] = v;
+                v = delta;
+            }
+
+            out[outs++] = static_cast<T>(static_cast<int64_t>(v) * gain);
+        }
+
+        return outs;
+    }
+}; // class KCicDecimator
+
+} // Klib
+
+#endif // __SIGNAL_KFILTER_HPP__
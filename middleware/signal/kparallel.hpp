@@ -0,0 +1,308 @@
+/// @file kparallel.hpp
+///
+/// @brief Parallel execution of the large vectors operations
+///
+/// Above a threshold size (KSetParallel), the element-wise evaluations
+/// and the reductions of the vectors are split in chunks of
+/// KPAR_CHUNK_SIZE elements, executed by a fixed pool of threads
+/// shared by the whole process. The calling thread executes chunks too.
+///
+///     KSetParallel(4, 1 << 20);  // 4 threads above 1M elements
+///
+/// The reductions of more than KPAR_CHUNK_SIZE elements are always
+/// computed by chunks, combined in the order of the chunks, whether
+/// the chunks run in parallel or not: the results don't depend on the
+/// number of threads nor on the threshold.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KPARALLEL_HPP__
+#define __SIGNAL_KPARALLEL_HPP__
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace Klib {
+
+/// Number of elements of a chunk
+#define KPAR_CHUNK_SIZE 65536
+
+/// Default size above which the operations run in parallel
+#define KPAR_DFLT_THRESHOLD (1 << 20)
+
+/// @brief Fixed pool of threads executing chunks of work
+///
+/// Several threads can run works at the same time: their chunks
+/// are shared by the threads of the pool.
+class KThreadPool
+{
+  public:
+    /// @threads_num_ Number of threads working, the caller included
+    KThreadPool(unsigned int threads_num_)
+    : threads_num(threads_num_), stop(false)
+    {
+        for(unsigned int i=1; i<threads_num; i++)
+            threads.push_back(std::thread(&KThreadPool::__loop, this));
+    }
+
+    ~KThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+
+        cond.notify_all();
+
+        for(auto& thread : threads)
+            thread.join();
+    }
+
+    inline unsigned int ThreadsNum() const {return threads_num;}
+
+    /// @brief Execute fn(c) for each chunk c < chunks_num
+    ///
+    /// Returns when all the chunks are completed.
+    void Run(size_t chunks_num, const std::function<void(size_t)>& fn)
+    {
+        std::shared_ptr<Work> work = std::make_shared<Work>(fn, chunks_num);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            works.push_back(work);
+        }
+
+        cond.notify_all();
+        __execute(*work);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = std::find(works.begin(), works.end(), work);
+
+            if(it != works.end())
+                works.erase(it);
+        }
+
+        std::unique_lock<std::mutex> lock(work->mutex);
+        work->cond.wait(lock, [&work] {
+            return work->done.load() == work->chunks_num;
+        });
+    }
+
+  private:
+    struct Work
+    {
+        Work(const std::function<void(size_t)>& fn_, size_t chunks_num_)
+        : fn(fn_), chunks_num(chunks_num_), next(0), done(0)
+        {}
+
+        const std::function<void(size_t)>& fn;
+        const size_t chunks_num;
+        std::atomic<size_t> next;  ///< Next chunk to execute
+        std::atomic<size_t> done;  ///< Chunks completed
+        std::mutex mutex;
+        std::condition_variable cond;
+    };
+
+    unsigned int threads_num;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque< std::shared_ptr<Work> > works;
+    bool stop;
+    std::vector<std::thread> threads;
+
+    /// Execute chunks of a work until all are taken
+    static void __execute(Work& work)
+    {
+        size_t chunk;
+
+        while((chunk = work.next++) < work.chunks_num) {
+            work.fn(chunk);
+
+            if(++work.done == work.chunks_num) {
+                std::lock_guard<std::mutex> lock(work.mutex);
+                work.cond.notify_all();
+            }
+        }
+    }
+
+    void __loop()
+    {
+        while(1) {
+            std::shared_ptr<Work> work;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] {return stop || !works.empty();});
+
+                if(stop)
+                    return;
+
+                work = works.front();
+
+                // All the chunks taken: the work leaves the queue
+                if(work->next.load() >= work->chunks_num) {
+                    works.pop_front();
+                    continue;
+                }
+            }
+
+            __execute(*work);
+        }
+    }
+}; // class KThreadPool
+
+/// Parallel execution settings of the process
+struct __KParallelState
+{
+    std::mutex mutex;
+    std::shared_ptr<KThreadPool> pool;  ///< nullptr if 1 thread
+    std::atomic<size_t> threshold;
+    bool configured;
+
+    __KParallelState()
+    : threshold(KPAR_DFLT_THRESHOLD), configured(false)
+    {}
+
+    static __KParallelState& get()
+    {
+        static __KParallelState state;
+        return state;
+    }
+};
+
+/// @brief Set the parallel execution of the vectors operations
+/// @threads_num Number of threads, 0 for the number of cores,
+///              1 to disable the parallel execution
+/// @threshold Size of the vectors above which they are split
+///
+/// The operations running keep the previous pool.
+inline void KSetParallel(unsigned int threads_num,
+                         size_t threshold = KPAR_DFLT_THRESHOLD)
+{
+    __KParallelState& state = __KParallelState::get();
+
+    if(threads_num == 0)
+        threads_num = std::max(1U, std::thread::hardware_concurrency());
+
+    std::shared_ptr<KThreadPool> pool;
+
+    if(threads_num > 1)
+        pool = std::make_shared<KThreadPool>(threads_num);
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.pool = pool;
+    state.threshold.store(threshold);
+    state.configured = true;
+}
+
+/// @brief Pool of the parallel operations (nullptr if disabled)
+///
+/// Created on the number of cores at the first use, if KSetParallel
+/// was not called.
+inline std::shared_ptr<KThreadPool> KParallelPool()
+{
+    __KParallelState& state = __KParallelState::get();
+    std::unique_lock<std::mutex> lock(state.mutex);
+
+    if(!state.configured) {
+        lock.unlock();
+        KSetParallel(0, KPAR_DFLT_THRESHOLD);
+        lock.lock();
+    }
+
+    return state.pool;
+}
+
+/// Number of threads of the parallel operations
+inline unsigned int KParallelThreads()
+{
+    std::shared_ptr<KThreadPool> pool = KParallelPool();
+    return pool ? pool->ThreadsNum() : 1;
+}
+
+/// Size of the vectors above which the operations are split
+inline size_t KParallelThreshold()
+{
+    KParallelPool();
+    return __KParallelState::get().threshold.load();
+}
+
+/// Execute fn(c) for each chunk c, on the pool if @parallel
+template<typename Fn>
+inline void __run_chunks(size_t chunks_num, bool parallel, Fn fn)
+{
+    std::shared_ptr<KThreadPool> pool;
+
+    if(parallel && chunks_num > 1)
+        pool = KParallelPool();
+
+    if(pool) {
+        pool->Run(chunks_num, fn);
+    } else {
+        for(size_t c=0; c<chunks_num; c++)
+            fn(c);
+    }
+}
+
+/// @brief Execute fn(begin, end) on the range [0, n)
+///
+/// Split in chunks executed in parallel if n is above the threshold.
+/// The chunks must be independent.
+template<typename Fn>
+inline void KParallelFor(size_t n, Fn fn)
+{
+    if(n <= KPAR_CHUNK_SIZE || n < __KParallelState::get().threshold.load()) {
+        fn(0, n);
+        return;
+    }
+
+    __run_chunks((n + KPAR_CHUNK_SIZE - 1) / KPAR_CHUNK_SIZE, true,
+                 [n, &fn](size_t c) {
+        const size_t begin = c * KPAR_CHUNK_SIZE;
+        fn(begin, std::min(n, begin + KPAR_CHUNK_SIZE));
+    });
+}
+
+/// @brief Reduce the range [0, n) by chunks
+/// @partial Reduction of a range: T partial(begin, end)
+/// @combine Combination of two partial reductions
+///
+/// The partial reductions are combined in the order of the chunks,
+/// so the result doesn't depend on the parallel execution.
+template<typename T, typename Partial, typename Combine>
+inline T KChunkedReduce(size_t n, Partial partial, Combine combine)
+{
+    if(n <= KPAR_CHUNK_SIZE)
+        return partial(0, n);
+
+    const size_t chunks_num = (n + KPAR_CHUNK_SIZE - 1) / KPAR_CHUNK_SIZE;
+    std::vector<T> partials(chunks_num);
+
+    __run_chunks(chunks_num, n >= __KParallelState::get().threshold.load(),
+                 [n, &partial, &partials](size_t c) {
+        const size_t begin = c * KPAR_CHUNK_SIZE;
+        partials[c] = partial(begin, std::min(n, begin + KPAR_CHUNK_SIZE));
+    });
+
+    T res = partials[0];
+
+    for(size_t c=1; c<chunks_num; c++)
+        res = combine(res, partials[c]);
+
+    return res;
+}
+
+} // Klib
+
+#endif // __SIGNAL_KPARALLEL_HPP__
@@ -0,0 +1,294 @@
+/// @file kreduce.hpp
+///
+/// @brief Vectorized reductions of arrays
+///
+/// The reductions run on SIMD packs (ksimd.hpp) with four independent
+/// accumulators, so that consecutive additions don't wait for each
+/// other. The remaining elements are reduced with the scalar traits.
+///
+/// The order of the additions differs from a sequential loop: the
+/// floating point results can differ in the last bits, but are
+/// identical from one call to another.
+///
+/// Above KPAR_CHUNK_SIZE elements, the arrays are reduced by chunks
+/// combined in order (kparallel.hpp), in parallel for the large ones.
+/// The results don't depend on the number of threads.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KREDUCE_HPP__
+#define __SIGNAL_KREDUCE_HPP__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "ksimd.hpp"
+#include "kparallel.hpp"
+
+namespace Klib {
+
+// ---------------------------------------
+// Reduction operations
+// ---------------------------------------
+
+// An operation on the traits Tr gives:
+// - init: the initial value of the accumulators,
+// - map: the function applied to the elements,
+// - combine: the accumulation of the mapped elements,
+// - finish: the reduction of a pack to a scalar.
+
+template<typename Tr>
+struct KRedSum
+{
+    typedef typename Tr::scalar T;
+    typedef typename Tr::pack pack;
+
+    static inline pack init(const T *) {return Tr::set1(0);}
+    inline pack map(pack x) const {return x;}
+    static inline pack combine(pack x, pack y) {return Tr::add(x, y);}
+    static inline T finish(pack x) {return Tr::hsum(x);}
+};
+
+template<typename Tr>
+struct KRedSumAbs : public KRedSum<Tr>
+{
+    typedef typename Tr::pack pack;
+
+    inline pack map(pack x) const {return Tr::abs(x);}
+};
+
+template<typename Tr>
+struct KRedSumSquares : public KRedSum<Tr>
+{
+    typedef typename Tr::pack pack;
+
+    inline pack map(pack x) const {return Tr::mul(x, x);}
+};
+
+/// Sum of the squared deviations to a mean
+template<typename Tr>
+struct KRedSumSquaredDev : public KRedSum<Tr>
+{
+    typedef typename Tr::scalar T;
+    typedef typename Tr::pack pack;
+
+    KRedSumSquaredDev(T mean_)
+    : mean(Tr::set1(mean_))
+    {}
+
+    inline pack map(pack x) const
+    {
+        pack delta = Tr::sub(x, mean);
+        return Tr::mul(delta, delta);
+    }
+
+    pack mean;
+};
+
+/// Sum of the p-th powers of the absolute values
+template<typename Tr>
+struct KRedSumPowAbs : public KRedSum<Tr>
+{
+    typedef typename Tr::pack pack;
+
+    KRedSumPowAbs(uint32_t p_)
+    : p(p_)
+    {}
+
+    /// Exponentiation by squaring, the same for all the lanes
+    inline pack map(pack x) const
+    {
+        pack base = Tr::abs(x);
+        pack res = Tr::set1(1);
+
+        for(uint32_t k = p; k != 0; k >>= 1) {
+            if(k & 1)
+                res = Tr::mul(res, base);
+
+            base = Tr::mul(base, base);
+        }
+
+        return res;
+    }
+
+    uint32_t p;
+};
+
+template<typename Tr>
+struct KRedMin
+{
+    typedef typename Tr::scalar T;
+    typedef typename Tr::pack pack;
+
+    static inline pack init(const T *x) {return Tr::set1(x[0]);}
+    inline pack map(pack x) const {return x;}
+    static inline pack combine(pack x, pack y) {return Tr::min(x, y);}
+    static inline T finish(pack x) {return Tr::hmin(x);}
+};
+
+template<typename Tr>
+struct KRedMax
+{
+    typedef typename Tr::scalar T;
+    typedef typename Tr::pack pack;
+
+    static inline pack init(const T *x) {return Tr::set1(x[0]);}
+    inline pack map(pack x) const {return x;}
+    static inline pack combine(pack x, pack y) {return Tr::max(x, y);}
+    static inline T finish(pack x) {return Tr::hmax(x);}
+};
+
+// ---------------------------------------
+// Reduction kernel
+// ---------------------------------------
+
+/// @brief Reduce an array
+/// @x The array
+/// @n Number of elements, must be > 0
+/// @args Arguments of the operation
+template<template<typename> class Op, typename T, typename... Args>
+inline T KReduce(const T *x, size_t n, Args... args)
+{
+    typedef SimdTraits<T> S;
+    typedef ScalarTraits<T> Sc;
+    typedef typename S::pack pack;
+
+    const size_t w = S::width;
+    const Op<S> op(args...);
+    const Op<Sc> op_sc(args...);
+
+    pack acc0 = Op<S>::init(x);
+    pack acc1 = acc0;
+    pack acc2 = acc0;
+    pack acc3 = acc0;
+    size_t i = 0;
+
+    for(; i + 4 * w <= n; i += 4 * w) {
+        acc0 = Op<S>::combine(acc0, op.map(S::load(x + i)));
+        acc1 = Op<S>::combine(acc1, op.map(S::load(x + i + w)));
+        acc2 = Op<S>::combine(acc2, op.map(S::load(x + i + 2 * w)));
+        acc3 = Op<S>::combine(acc3, op.map(S::load(x + i + 3 * w)));
+    }
+
+    for(; i + w <= n; i += w)
+        acc0 = Op<S>::combine(acc0, op.map(S::load(x + i)));
+
+    acc0 = Op<S>::combine(Op<S>::combine(acc0, acc1),
+                          Op<S>::combine(acc2, acc3));
+    T res = Op<S>::finish(acc0);
+
+    for(; i < n; i++)
+        res = Op<Sc>::combine(res, op_sc.map(x[i]));
+
+    return res;
+}
+
+/// @brief Reduce an array by chunks, in parallel if large
+/// @n Number of elements, must be > 0
+template<template<typename> class Op, typename T, typename... Args>
+inline T KParallelReduce(const T *x, size_t n, Args... args)
+{
+    return KChunkedReduce<T>(n,
+        [x, args...](size_t begin, size_t end) {
+            return KReduce<Op>(x + begin, end - begin, args...);
+        },
+        [](T a, T b) {return Op< ScalarTraits<T> >::combine(a, b);});
+}
+
+/// Sum of the elements
+template<typename T>
+inline T KSum(const T *x, size_t n)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedSum>(x, n);
+}
+
+/// Sum of the absolute values
+template<typename T>
+inline T KSumAbs(const T *x, size_t n)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedSumAbs>(x, n);
+}
+
+/// Sum of the squares
+template<typename T>
+inline T KSumSquares(const T *x, size_t n)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedSumSquares>(x, n);
+}
+
+/// Sum of the squared deviations to @mean
+template<typename T>
+inline T KSumSquaredDev(const T *x, size_t n, T mean)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedSumSquaredDev>(x, n, mean);
+}
+
+/// Sum of the @p-th powers of the absolute values
+template<typename T>
+inline T KSumPowAbs(const T *x, size_t n, uint32_t p)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedSumPowAbs>(x, n, p);
+}
+
+/// Minimum of the elements (0 if empty)
+template<typename T>
+inline T KMin(const T *x, size_t n)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedMin>(x, n);
+}
+
+/// Maximum of the elements (0 if empty)
+template<typename T>
+inline T KMax(const T *x, size_t n)
+{
+    return n == 0 ? 0 : KParallelReduce<KRedMax>(x, n);
+}
+
+/// Dot product of two arrays, serial
+template<typename T>
+inline T __dot(const T *x, const T *y, size_t n)
+{
+    typedef SimdTraits<T> S;
+    typedef typename S::pack pack;
+
+    const size_t w = S::width;
+    pack acc0 = S::set1(0);
+    pack acc1 = acc0;
+    pack acc2 = acc0;
+    pack acc3 = acc0;
+    size_t i = 0;
+
+    for(; i + 4 * w <= n; i += 4 * w) {
+        acc0 = S::fmadd(S::load(x + i), S::load(y + i), acc0);
+        acc1 = S::fmadd(S::load(x + i + w), S::load(y + i + w), acc1);
+        acc2 = S::fmadd(S::load(x + i + 2 * w), S::load(y + i + 2 * w), acc2);
+        acc3 = S::fmadd(S::load(x + i + 3 * w), S::load(y + i + 3 * w), acc3);
+    }
+
+    for(; i + w <= n; i += w)
+        acc0 = S::fmadd(S::load(x + i), S::load(y + i), acc0);
+
+    T res = S::hsum(S::add(S::add(acc0, acc1), S::add(acc2, acc3)));
+
+    for(; i < n; i++)
+        res += x[i] * y[i];
+
+    return res;
+}
+
+/// Dot product of two arrays (0 if empty)
+template<typename T>
+inline T KDot(const T *x, const T *y, size_t n)
+{
+    return KChunkedReduce<T>(n,
+        [x, y](size_t begin, size_t end) {
+            return __dot(x + begin, y + begin, end - begin);
+        },
+        [](T a, T b) {return a + b;});
+}
+
+} // Klib
+
+#endif // __SIGNAL_KREDUCE_HPP__
@@ -0,0 +1,586 @@
+/// @file ksimd.hpp
+///
+/// @brief SIMD packs of the signal kernels
+///
+/// SimdTraits<T> gives a pack of scalars T and its operations, on the
+/// widest instruction set enabled at compile time:
+///     - AVX2 (8 floats, 4 doubles),
+///     - SSE2 (4 floats, 2 doubles),
+///     - NEON (4 floats),
+///     - scalar (1 value): other types and targets.
+/// The kernels are written once on SimdTraits, the scalar traits being
+/// the fallback of the SIMD ones.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KSIMD_HPP__
+#define __SIGNAL_KSIMD_HPP__
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+# define KLIB_SIMD_AVX2 1
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+# define KLIB_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define KLIB_SIMD_NEON 1
+#endif
+
+namespace Klib {
+
+/// Bits of a float as an integer
+static inline int32_t __float_bits(float x)
+{
+    int32_t i;
+    memcpy(&i, &x, sizeof(i));
+    return i;
+}
+
+static inline float __bits_float(int32_t i)
+{
+    float x;
+    memcpy(&x, &i, sizeof(x));
+    return x;
+}
+
+/// @brief Scalar traits: a pack of one value
+template<typename T>
+struct ScalarTraits
+{
+    typedef T scalar;
+    typedef T pack;
+    typedef int32_t ipack;
+    static const size_t width = 1;
+
+    static inline pack load(const T *ptr) {return *ptr;}
+    static inline void store(T *ptr, pack x) {*ptr = x;}
+    static inline pack set1(T x) {return x;}
+
+    static inline pack add(pack x, pack y) {return x + y;}
+    static inline pack sub(pack x, pack y) {return x - y;}
+    static inline pack mul(pack x, pack y) {return x * y;}
+    static inline pack fmadd(pack x, pack y, pack z) {return x * y + z;}
+    static inline pack min(pack x, pack y) {return y < x ? y : x;}
+    static inline pack max(pack x, pack y) {return y > x ? y : x;}
+    static inline pack abs(pack x) {return x < 0 ? -x : x;}
+
+    static inline T hsum(pack x) {return x;}
+    static inline T hmin(pack x) {return x;}
+    static inline T hmax(pack x) {return x;}
+};
+
+/// @brief Scalar float traits, with the bit operations of the fast math
+///
+/// The masks are all ones (true) or all zeros (false), in the type
+/// of the pack. Used for the tails of the arrays, and by the
+/// element-wise expressions (the code being branch-free, the compiler
+/// can still vectorize their evaluation loop).
+template<>
+struct ScalarTraits<float>
+{
+    typedef float scalar;
+    typedef float pack;
+    typedef int32_t ipack;
+    static const size_t width = 1;
+
+    static inline pack load(const float *ptr) {return *ptr;}
+    static inline void store(float *ptr, pack x) {*ptr = x;}
+    static inline pack set1(float x) {return x;}
+    static inline ipack iset1(int32_t x) {return x;}
+
+    static inline pack add(pack x, pack y) {return x + y;}
+    static inline pack sub(pack x, pack y) {return x - y;}
+    static inline pack mul(pack x, pack y) {return x * y;}
+    static inline pack fmadd(pack x, pack y, pack z) {return x * y + z;}
+
+    // Selections on masks rather than conditionals,
+    // which the compiler may turn into branches
+    static inline pack min(pack x, pack y) {return select(cmplt(y, x), y, x);}
+    static inline pack max(pack x, pack y) {return select(cmplt(x, y), y, x);}
+    static inline pack abs(pack x) {return band(x, as_float(0x7FFFFFFF));}
+
+    static inline pack band(pack x, pack y)
+    {
+        return as_float(as_int(x) & as_int(y));
+    }
+
+    static inline pack bor(pack x, pack y)
+    {
+        return as_float(as_int(x) | as_int(y));
+    }
+
+    static inline pack bxor(pack x, pack y)
+    {
+        return as_float(as_int(x) ^ as_int(y));
+    }
+
+    /// ~x & y
+    static inline pack bandnot(pack x, pack y)
+    {
+        return as_float(~as_int(x) & as_int(y));
+    }
+
+    static inline pack cmplt(pack x, pack y) {return as_float(-(x < y));}
+    static inline pack cmple(pack x, pack y) {return as_float(-(x <= y));}
+
+    /// mask ? x : y
+    static inline pack select(pack mask, pack x, pack y)
+    {
+        return bor(band(mask, x), bandnot(mask, y));
+    }
+
+    static inline ipack iadd(ipack x, ipack y) {return x + y;}
+    static inline ipack isub(ipack x, ipack y) {return x - y;}
+    static inline ipack iand(ipack x, ipack y) {return x & y;}
+    static inline ipack iandnot(ipack x, ipack y) {return ~x & y;}
+    static inline ipack icmpeq(ipack x, ipack y) {return -(x == y);}
+    template<int n> static inline ipack islli(ipack x) {return x << n;}
+
+    template<int n>
+    static inline ipack isrli(ipack x)
+    {
+        return static_cast<uint32_t>(x) >> n;
+    }
+
+    static inline ipack to_int_trunc(pack x) {return static_cast<int32_t>(x);}
+
+    static inline ipack to_int_round(pack x)
+    {
+        return static_cast<int32_t>(x + std::copysign(0.5f, x));
+    }
+
+    static inline pack to_float(ipack x) {return static_cast<float>(x);}
+    static inline ipack as_int(pack x) {return __float_bits(x);}
+    static inline pack as_float(ipack x) {return __bits_float(x);}
+
+    static inline float hsum(pack x) {return x;}
+    static inline float hmin(pack x) {return x;}
+    static inline float hmax(pack x) {return x;}
+};
+
+/// SIMD traits: the scalar traits unless specialized below
+template<typename T>
+struct SimdTraits : public ScalarTraits<T> {};
+
+#if defined(KLIB_SIMD_AVX2)
+
+template<>
+struct SimdTraits<float>
+{
+    typedef float scalar;
+    typedef __m256 pack;
+    typedef __m256i ipack;
+    static const size_t width = 8;
+
+    static inline pack load(const float *ptr) {return _mm256_loadu_ps(ptr);}
+    static inline void store(float *ptr, pack x) {_mm256_storeu_ps(ptr, x);}
+    static inline pack set1(float x) {return _mm256_set1_ps(x);}
+    static inline ipack iset1(int32_t x) {return _mm256_set1_epi32(x);}
+
+    static inline pack add(pack x, pack y) {return _mm256_add_ps(x, y);}
+    static inline pack sub(pack x, pack y) {return _mm256_sub_ps(x, y);}
+    static inline pack mul(pack x, pack y) {return _mm256_mul_ps(x, y);}
+
+    static inline pack fmadd(pack x, pack y, pack z)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_ps(x, y, z);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(x, y), z);
+#endif
+    }
+
+    static inline pack min(pack x, pack y) {return _mm256_min_ps(x, y);}
+    static inline pack max(pack x, pack y) {return _mm256_max_ps(x, y);}
+
+    static inline pack abs(pack x)
+    {
+        return _mm256_and_ps(x, _mm256_castsi256_ps(iset1(0x7FFFFFFF)));
+    }
+
+    static inline pack band(pack x, pack y) {return _mm256_and_ps(x, y);}
+    static inline pack bor(pack x, pack y) {return _mm256_or_ps(x, y);}
+    static inline pack bxor(pack x, pack y) {return _mm256_xor_ps(x, y);}
+    static inline pack bandnot(pack x, pack y) {return _mm256_andnot_ps(x, y);}
+
+    static inline pack cmplt(pack x, pack y)
+    {
+        return _mm256_cmp_ps(x, y, _CMP_LT_OQ);
+    }
+
+    static inline pack cmple(pack x, pack y)
+    {
+        return _mm256_cmp_ps(x, y, _CMP_LE_OQ);
+    }
+
+    static inline pack select(pack mask, pack x, pack y)
+    {
+        return _mm256_blendv_ps(y, x, mask);
+    }
+
+    static inline ipack iadd(ipack x, ipack y) {return _mm256_add_epi32(x, y);}
+    static inline ipack isub(ipack x, ipack y) {return _mm256_sub_epi32(x, y);}
+    static inline ipack iand(ipack x, ipack y) {return _mm256_and_si256(x, y);}
+
+    static inline ipack iandnot(ipack x, ipack y)
+    {
+        return _mm256_andnot_si256(x, y);
+    }
+
+    static inline ipack icmpeq(ipack x, ipack y)
+    {
+        return _mm256_cmpeq_epi32(x, y);
+    }
+
+    template<int n> static inline ipack islli(ipack x)
+    {
+        return _mm256_slli_epi32(x, n);
+    }
+
+    template<int n> static inline ipack isrli(ipack x)
+    {
+        return _mm256_srli_epi32(x, n);
+    }
+
+    static inline ipack to_int_trunc(pack x) {return _mm256_cvttps_epi32(x);}
+    static inline ipack to_int_round(pack x) {return _mm256_cvtps_epi32(x);}
+    static inline pack to_float(ipack x) {return _mm256_cvtepi32_ps(x);}
+    static inline ipack as_int(pack x) {return _mm256_castps_si256(x);}
+    static inline pack as_float(ipack x) {return _mm256_castsi256_ps(x);}
+
+    static inline float hsum(pack x)
+    {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(x),
+                                _mm256_extractf128_ps(x, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+
+    static inline float hmin(pack x)
+    {
+        __m128 res = _mm_min_ps(_mm256_castps256_ps128(x),
+                                _mm256_extractf128_ps(x, 1));
+        res = _mm_min_ps(res, _mm_movehl_ps(res, res));
+        res = _mm_min_ss(res, _mm_shuffle_ps(res, res, 1));
+        return _mm_cvtss_f32(res);
+    }
+
+    static inline float hmax(pack x)
+    {
+        __m128 res = _mm_max_ps(_mm256_castps256_ps128(x),
+                                _mm256_extractf128_ps(x, 1));
+        res = _mm_max_ps(res, _mm_movehl_ps(res, res));
+        res = _mm_max_ss(res, _mm_shuffle_ps(res, res, 1));
+        return _mm_cvtss_f32(res);
+    }
+};
+
+template<>
+struct SimdTraits<double>
+{
+    typedef double scalar;
+    typedef __m256d pack;
+    static const size_t width = 4;
+
+    static inline pack load(const double *ptr) {return _mm256_loadu_pd(ptr);}
+    static inline void store(double *ptr, pack x) {_mm256_storeu_pd(ptr, x);}
+    static inline pack set1(double x) {return _mm256_set1_pd(x);}
+
+    static inline pack add(pack x, pack y) {return _mm256_add_pd(x, y);}
+    static inline pack sub(pack x, pack y) {return _mm256_sub_pd(x, y);}
+    static inline pack mul(pack x, pack y) {return _mm256_mul_pd(x, y);}
+
+    static inline pack fmadd(pack x, pack y, pack z)
+    {
+#if defined(__FMA__)
+        return _mm256_fmadd_pd(x, y, z);
+#else
+        return _mm256_add_pd(_mm256_mul_pd(x, y), z);
+#endif
+    }
+
+    static inline pack min(pack x, pack y) {return _mm256_min_pd(x, y);}
+    static inline pack max(pack x, pack y) {return _mm256_max_pd(x, y);}
+
+    static inline pack abs(pack x)
+    {
+        return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    }
+
+    static inline double hsum(pack x)
+    {
+        __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(x),
+                                 _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    static inline double hmin(pack x)
+    {
+        __m128d res = _mm_min_pd(_mm256_castpd256_pd128(x),
+                                 _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_min_sd(res, _mm_unpackhi_pd(res, res)));
+    }
+
+    static inline double hmax(pack x)
+    {
+        __m128d res = _mm_max_pd(_mm256_castpd256_pd128(x),
+                                 _mm256_extractf128_pd(x, 1));
+        return _mm_cvtsd_f64(_mm_max_sd(res, _mm_unpackhi_pd(res, res)));
+    }
+};
+
+#elif defined(KLIB_SIMD_SSE2)
+
+template<>
+struct SimdTraits<float>
+{
+    typedef float scalar;
+    typedef __m128 pack;
+    typedef __m128i ipack;
+    static const size_t width = 4;
+
+    static inline pack load(const float *ptr) {return _mm_loadu_ps(ptr);}
+    static inline void store(float *ptr, pack x) {_mm_storeu_ps(ptr, x);}
+    static inline pack set1(float x) {return _mm_set1_ps(x);}
+    static inline ipack iset1(int32_t x) {return _mm_set1_epi32(x);}
+
+    static inline pack add(pack x, pack y) {return _mm_add_ps(x, y);}
+    static inline pack sub(pack x, pack y) {return _mm_sub_ps(x, y);}
+    static inline pack mul(pack x, pack y) {return _mm_mul_ps(x, y);}
+
+    static inline pack fmadd(pack x, pack y, pack z)
+    {
+        return _mm_add_ps(_mm_mul_ps(x, y), z);
+    }
+
+    static inline pack min(pack x, pack y) {return _mm_min_ps(x, y);}
+    static inline pack max(pack x, pack y) {return _mm_max_ps(x, y);}
+
+    static inline pack abs(pack x)
+    {
+        return _mm_and_ps(x, _mm_castsi128_ps(iset1(0x7FFFFFFF)));
+    }
+
+    static inline pack band(pack x, pack y) {return _mm_and_ps(x, y);}
+    static inline pack bor(pack x, pack y) {return _mm_or_ps(x, y);}
+    static inline pack bxor(pack x, pack y) {return _mm_xor_ps(x, y);}
+    static inline pack bandnot(pack x, pack y) {return _mm_andnot_ps(x, y);}
+    static inline pack cmplt(pack x, pack y) {return _mm_cmplt_ps(x, y);}
+    static inline pack cmple(pack x, pack y) {return _mm_cmple_ps(x, y);}
+
+    static inline pack select(pack mask, pack x, pack y)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+    }
+
+    static inline ipack iadd(ipack x, ipack y) {return _mm_add_epi32(x, y);}
+    static inline ipack isub(ipack x, ipack y) {return _mm_sub_epi32(x, y);}
+    static inline ipack iand(ipack x, ipack y) {return _mm_and_si128(x, y);}
+    static inline ipack iandnot(ipack x, ipack y) {return _mm_andnot_si128(x, y);}
+    static inline ipack icmpeq(ipack x, ipack y) {return _mm_cmpeq_epi32(x, y);}
+
+    template<int n> static inline ipack islli(ipack x)
+    {
+        return _mm_slli_epi32(x, n);
+    }
+
+    template<int n> static inline ipack isrli(ipack x)
+    {
+        return _mm_srli_epi32(x, n);
+    }
+
+    static inline ipack to_int_trunc(pack x) {return _mm_cvttps_epi32(x);}
+    static inline ipack to_int_round(pack x) {return _mm_cvtps_epi32(x);}
+    static inline pack to_float(ipack x) {return _mm_cvtepi32_ps(x);}
+    static inline ipack as_int(pack x) {return _mm_castps_si128(x);}
+    static inline pack as_float(ipack x) {return _mm_castsi128_ps(x);}
+
+    static inline float hsum(pack x)
+    {
+        pack sum = _mm_add_ps(x, _mm_movehl_ps(x, x));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+
+    static inline float hmin(pack x)
+    {
+        pack res = _mm_min_ps(x, _mm_movehl_ps(x, x));
+        res = _mm_min_ss(res, _mm_shuffle_ps(res, res, 1));
+        return _mm_cvtss_f32(res);
+    }
+
+    static inline float hmax(pack x)
+    {
+        pack res = _mm_max_ps(x, _mm_movehl_ps(x, x));
+        res = _mm_max_ss(res, _mm_shuffle_ps(res, res, 1));
+        return _mm_cvtss_f32(res);
+    }
+};
+
+template<>
+struct SimdTraits<double>
+{
+    typedef double scalar;
+    typedef __m128d pack;
+    static const size_t width = 2;
+
+    static inline pack load(const double *ptr) {return _mm_loadu_pd(ptr);}
+    static inline void store(double *ptr, pack x) {_mm_storeu_pd(ptr, x);}
+    static inline pack set1(double x) {return _mm_set1_pd(x);}
+
+    static inline pack add(pack x, pack y) {return _mm_add_pd(x, y);}
+    static inline pack sub(pack x, pack y) {return _mm_sub_pd(x, y);}
+    static inline pack mul(pack x, pack y) {return _mm_mul_pd(x, y);}
+
+    static inline pack fmadd(pack x, pack y, pack z)
+    {
+        return _mm_add_pd(_mm_mul_pd(x, y), z);
+    }
+
+    static inline pack min(pack x, pack y) {return _mm_min_pd(x, y);}
+    static inline pack max(pack x, pack y) {return _mm_max_pd(x, y);}
+
+    static inline pack abs(pack x)
+    {
+        return _mm_andnot_pd(_mm_set1_pd(-0.0), x);
+    }
+
+    static inline double hsum(pack x)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+
+    static inline double hmin(pack x)
+    {
+        return _mm_cvtsd_f64(_mm_min_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+
+    static inline double hmax(pack x)
+    {
+        return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+    }
+};
+
+#elif defined(KLIB_SIMD_NEON)
+
+template<>
+struct SimdTraits<float>
+{
+    typedef float scalar;
+    typedef float32x4_t pack;
+    typedef int32x4_t ipack;
+    static const size_t width = 4;
+
+    static inline pack load(const float *ptr) {return vld1q_f32(ptr);}
+    static inline void store(float *ptr, pack x) {vst1q_f32(ptr, x);}
+    static inline pack set1(float x) {return vdupq_n_f32(x);}
+    static inline ipack iset1(int32_t x) {return vdupq_n_s32(x);}
+
+    static inline pack add(pack x, pack y) {return vaddq_f32(x, y);}
+    static inline pack sub(pack x, pack y) {return vsubq_f32(x, y);}
+    static inline pack mul(pack x, pack y) {return vmulq_f32(x, y);}
+    static inline pack fmadd(pack x, pack y, pack z) {return vmlaq_f32(z, x, y);}
+    static inline pack min(pack x, pack y) {return vminq_f32(x, y);}
+    static inline pack max(pack x, pack y) {return vmaxq_f32(x, y);}
+    static inline pack abs(pack x) {return vabsq_f32(x);}
+
+    static inline pack band(pack x, pack y)
+    {
+        return as_float(vandq_s32(as_int(x), as_int(y)));
+    }
+
+    static inline pack bor(pack x, pack y)
+    {
+        return as_float(vorrq_s32(as_int(x), as_int(y)));
+    }
+
+    static inline pack bxor(pack x, pack y)
+    {
+        return as_float(veorq_s32(as_int(x), as_int(y)));
+    }
+
+    static inline pack bandnot(pack x, pack y)
+    {
+        return as_float(vbicq_s32(as_int(y), as_int(x)));
+    }
+
+    static inline pack cmplt(pack x, pack y)
+    {
+        return vreinterpretq_f32_u32(vcltq_f32(x, y));
+    }
+
+    static inline pack cmple(pack x, pack y)
+    {
+        return vreinterpretq_f32_u32(vcleq_f32(x, y));
+    }
+
+    static inline pack select(pack mask, pack x, pack y)
+    {
+        return vbslq_f32(vreinterpretq_u32_f32(mask), x, y);
+    }
+
+    static inline ipack iadd(ipack x, ipack y) {return vaddq_s32(x, y);}
+    static inline ipack isub(ipack x, ipack y) {return vsubq_s32(x, y);}
+    static inline ipack iand(ipack x, ipack y) {return vandq_s32(x, y);}
+    static inline ipack iandnot(ipack x, ipack y) {return vbicq_s32(y, x);}
+
+    static inline ipack icmpeq(ipack x, ipack y)
+    {
+        return vreinterpretq_s32_u32(vceqq_s32(x, y));
+    }
+
+    template<int n> static inline ipack islli(ipack x)
+    {
+        return vshlq_n_s32(x, n);
+    }
+
+    template<int n> static inline ipack isrli(ipack x)
+    {
+        return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(x), n));
+    }
+
+    static inline ipack to_int_trunc(pack x) {return vcvtq_s32_f32(x);}
+
+    static inline ipack to_int_round(pack x)
+    {
+        pack half = bor(band(x, as_float(iset1(0x80000000))), set1(0.5f));
+        return vcvtq_s32_f32(vaddq_f32(x, half));
+    }
+
+    static inline pack to_float(ipack x) {return vcvtq_f32_s32(x);}
+    static inline ipack as_int(pack x) {return vreinterpretq_s32_f32(x);}
+    static inline pack as_float(ipack x) {return vreinterpretq_f32_s32(x);}
+
+    static inline float hsum(pack x)
+    {
+        float32x2_t sum = vadd_f32(vget_low_f32(x), vget_high_f32(x));
+        return vget_lane_f32(vpadd_f32(sum, sum), 0);
+    }
+
+    static inline float hmin(pack x)
+    {
+        float32x2_t res = vmin_f32(vget_low_f32(x), vget_high_f32(x));
+        return vget_lane_f32(vpmin_f32(res, res), 0);
+    }
+
+    static inline float hmax(pack x)
+    {
+        float32x2_t res = vmax_f32(vget_low_f32(x), vget_high_f32(x));
+        return vget_lane_f32(vpmax_f32(res, res), 0);
+    }
+};
+
+#endif
+
+} // Klib
+
+#endif // __SIGNAL_KSIMD_HPP__
@@ -0,0 +1,173 @@
+/// @file kvector_view.hpp
+///
+/// @brief Non-owning vector on an existing buffer
+///
+/// A KVectorView reads a buffer it doesn't own (a memory map, a
+/// received upload, a KVector) without copying it. It is read-only,
+/// and is used as a KVector in the expressions and the reductions:
+///
+///     KVectorView<float> x(buffer, n);
+///     KVector<float> y = 2.0f * x + 1.0f;  // One loop, no copy of x
+///     float rms = x.norm2() / std::sqrt(n);
+///
+/// For a memory updated by the hardware (BRAM), use a volatile view:
+/// KVectorView<uint32_t, true>. Each component is then read exactly once
+/// per pass, through a volatile access, and the reductions are
+/// sequential. A reduction in two passes (var, stdev) reads the
+/// buffer twice: use a snapshot for a consistent result.
+///
+/// The buffer must outlive the view.
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KVECTOR_VIEW_HPP__
+#define __SIGNAL_KVECTOR_VIEW_HPP__
+
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+#include "kexpr.hpp"
+#include "kreduce.hpp"
+#include "kvector.hpp"
+
+namespace Klib {
+
+/// @brief Read-only view of a buffer
+///
+/// @T Scalar type
+/// @Volatile True to read the buffer through volatile accesses
+template<typename T, bool Volatile = false>
+class KVectorView : public KExpr<KVectorView<T, Volatile>, T>
+{
+  public:
+    typedef typename std::conditional<Volatile,
+                                      const volatile T, const T>::type elem_t;
+
+    /// @brief View of a buffer
+    /// @data_ptr_ First component
+    /// @size_ Number of components
+    KVectorView(elem_t *data_ptr_, size_t size_)
+    : data_ptr(data_ptr_), len(size_)
+    {}
+
+    /// @brief View of a buffer at an address (memory map)
+    KVectorView(uintptr_t addr_, size_t size_)
+    : data_ptr(reinterpret_cast<elem_t*>(addr_)), len(size_)
+    {}
+
+    /// @brief View of a vector
+    template<typename Alloc>
+    KVectorView(const KVector<T, Alloc>& vect_)
+    : data_ptr(vect_.get_ptr()), len(vect_.size())
+    {}
+
+    /// @brief View of a std::vector
+    KVectorView(const std::vector<T>& vect_)
+    : data_ptr(vect_.data()), len(vect_.size())
+    {}
+
+    // ---------------------------------------
+    // Accessors
+    // ---------------------------------------
+
+    inline size_t size() const {return len;}
+
+    inline T operator[](size_t i) const
+    {
+        assert(i < len);
+        return data_ptr[i];
+    }
+
+    /// @brief Get the data pointer
+    ///
+    /// For a volatile view, the pointer is used to send
+    /// the buffer, with the bulk reads of the socket.
+    inline const T* get_ptr() const
+    {
+        return const_cast<const T*>(data_ptr);
+    }
+
+    /// @brief View of the components [begin, begin + size)
+    inline KVectorView<T, Volatile> sub(size_t begin_, size_t size_) const
+    {
+        assert(begin_ + size_ <= len);
+        return KVectorView<T, Volatile>(data_ptr + begin_, size_);
+    }
+
+    // ---------------------------------------
+    // Reductions
+    // Vectorized (see kreduce.hpp), except for the volatile
+    // views which use the sequential loops of KExpr.
+    // ---------------------------------------
+
+    inline T sum() const
+    {
+        return Volatile ? base().sum() : KSum(get_ptr(), len);
+    }
+
+    inline T mean() const
+    {
+        return sum() / len;
+    }
+
+    inline T max() const
+    {
+        return Volatile ? base().max() : KMax(get_ptr(), len);
+    }
+
+    inline T min() const
+    {
+        return Volatile ? base().min() : KMin(get_ptr(), len);
+    }
+
+    inline T norm1() const
+    {
+        return Volatile ? base().norm1() : KSumAbs(get_ptr(), len);
+    }
+
+    inline T norm2() const
+    {
+        return Volatile ? base().norm2()
+                        : std::sqrt(KSumSquares(get_ptr(), len));
+    }
+
+    inline T normp(uint32_t p) const
+    {
+        if(Volatile)
+            return base().normp(p);
+
+        return std::pow(KSumPowAbs(get_ptr(), len, p), 1/static_cast<T>(p));
+    }
+
+    inline T var() const
+    {
+        if(Volatile || len == 0)
+            return base().var();
+
+        return KSumSquaredDev(get_ptr(), len, mean()) / len;
+    }
+
+    inline T stdev() const
+    {
+        return std::sqrt(var());
+    }
+
+  private:
+    elem_t *data_ptr;
+    size_t len;
+
+    inline const KExpr<KVectorView<T, Volatile>, T>& base() const
+    {
+        return *this;
+    }
+}; // class KVectorView
+
+} // Klib
+
+#endif // __SIGNAL_KVECTOR_VIEW_HPP__
@@ -0,0 +1,68 @@
+/// @file kwindow.hpp
+///
+/// @brief Windows of the spectral analysis and of the filters design
+///
+/// @date 18/10/2026
+///
+/// (c) Koheron 2014-2015
+
+#ifndef __SIGNAL_KWINDOW_HPP__
+#define __SIGNAL_KWINDOW_HPP__
+
+#include <cmath>
+#include <cstddef>
+
+#include "kvector.hpp"
+
+namespace Klib {
+
+/// Windows
+typedef enum {
+    KWIN_RECTANGULAR,
+    KWIN_HANN,
+    KWIN_HAMMING,
+    KWIN_BLACKMAN,
+    KWIN_FLATTOP,
+    kwindows_num
+} kwindow_t;
+
+/// @brief Window of @n points
+///
+/// The periodic windows (DFT-even) are the ones of spectral analysis,
+/// the symmetric ones are used to design the FIR filters.
+template<typename T>
+inline KVector<T> KWindow(kwindow_t window, size_t n, bool periodic = true)
+{
+    KVector<T> res(n, static_cast<T>(1));
+    const double a = 2 * M_PI / (periodic || n < 2 ? n : n - 1);
+
+    for(size_t i=0; i<n; i++) {
+        const double c = a * i;
+
+        switch(window) {
+          case KWIN_HANN:
+            res[i] = 0.5 - 0.5 * std::cos(c);
+            break;
+          case KWIN_HAMMING:
+            res[i] = 0.54 - 0.46 * std::cos(c);
+            break;
+          case KWIN_BLACKMAN:
+            res[i] = 0.42 - 0.5 * std::cos(c) + 0.08 * std::cos(2 * c);
+            break;
+          case KWIN_FLATTOP:
+            res[i] = 0.21557895 - 0.41663158 * std::cos(c)
+                     + 0.277263158 * std::cos(2 * c)
+                     - 0.083578947 * std::cos(3 * c)
+                     + 0.006947368 * std::cos(4 * c);
+            break;
+          default:
+            break;
+        }
+    }
+
+    return res;
+}
+
+} // Klib
+
+#endif // __SIGNAL_KWINDOW_HPP__